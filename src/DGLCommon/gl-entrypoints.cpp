@@ -16,11 +16,10 @@
 #include "gl-entrypoints.h"
 #include "def.h"
 
-#include <memory>
-#include <string>
-#include <map>
 #include <vector>
 #include <cstdarg>
+#include <cstring>
+#include <stdint.h>
 
 namespace lists {
 
@@ -60,26 +59,35 @@ struct GLEntrypoint {
 #undef PARAM
 #undef RETVAL
 
-struct EntrypMapCache {
-    EntrypMapCache() {
-
-        for (Entrypoint e = 0; e < Entrypoints_NUM; e++) {
-            entryPointNameToEnum[GetEntryPointName(e)] = e;
-        }
-    }
-
-    static EntrypMapCache* get() {
-        if (!s_cache.get()) {
-            s_cache = std::make_shared<EntrypMapCache>();
-        }
-        return s_cache.get();
-    }
-
-    static std::shared_ptr<EntrypMapCache> s_cache;
-    std::map<std::string, Entrypoint> entryPointNameToEnum;
+//minimal perfect hash of entrypoint names, see buildPerfectHash() in codegen.py
+#define FUNC_HASH_DISPLACEMENT(d) d,
+#define FUNC_HASH_SLOT(name)
+const int g_EntrypointHashDisplacements[] = {
+#include "codegen_gl_function_hash.inl"
 };
+#undef FUNC_HASH_DISPLACEMENT
+#undef FUNC_HASH_SLOT
 
-std::shared_ptr<EntrypMapCache> EntrypMapCache::s_cache;
+#define FUNC_HASH_DISPLACEMENT(d)
+#define FUNC_HASH_SLOT(name) name##_Call,
+const Entrypoint g_EntrypointHashSlots[] = {
+#include "codegen_gl_function_hash.inl"
+};
+#undef FUNC_HASH_DISPLACEMENT
+#undef FUNC_HASH_SLOT
+
+static_assert(DGL_ARRAY_LENGTH(g_EntrypointHashSlots) == Entrypoints_NUM,
+              "entrypoint hash must cover all entrypoints");
+
+//must match nameHash() in codegen.py
+inline uint32_t entrypointNameHash(const char* name, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+    for (; *name; name++) {
+        hash ^= static_cast<unsigned char>(*name);
+        hash *= 16777619u;
+    }
+    return hash;
+}
 
 } //namespace lists
 
@@ -139,11 +147,18 @@ const char* GetEntryPointName(Entrypoint entryp) {
 }
 
 Entrypoint GetEntryPointEnum(const char* name) {
-    std::map<std::string, Entrypoint>::iterator ret =
-        lists::EntrypMapCache::get()->entryPointNameToEnum.find(name);
-    if (ret == lists::EntrypMapCache::get()->entryPointNameToEnum.end())
+    const uint32_t size = Entrypoints_NUM;
+    int displacement = lists::g_EntrypointHashDisplacements
+            [lists::entrypointNameHash(name, 0) % size];
+    uint32_t slot = (displacement < 0)
+            ? static_cast<uint32_t>(-displacement - 1)
+            : lists::entrypointNameHash(name, displacement) % size;
+
+    //hash is perfect only for known names, check if it is one of them
+    Entrypoint ret = lists::g_EntrypointHashSlots[slot];
+    if (strcmp(GetEntryPointName(ret), name) != 0)
         return NO_ENTRYPOINT;
-    return ret->second;
+    return ret;
 }
 
 const GLParamTypeMetadata GetEntryPointGLParamTypeMetadata(Entrypoint entryp, size_t param) {
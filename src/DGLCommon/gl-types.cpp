@@ -16,92 +16,85 @@
 #include "gl-types.h"
 #include "gl-glue-headers.h"
 
-#include <memory>
-#include <cstdio>
-#include <map>
-#include <set>
+#include <algorithm>
 #include <sstream>
 
 namespace lists {
 
-struct GLEnumName {
-public:
+struct EnumNameEntry {
+    gl_t m_value;
     const char* m_name;
-    GLEnumGroup  m_groups[11];
-    bool operator<(const GLEnumName& rhs) const {
-        return m_name < rhs.m_name;
-    }
 };
 
-struct EnumMapCache {
-    EnumMapCache() {
-        for (size_t i = 0; s_CodegenEnumGLToName[i].name.m_name != nullptr; i++) {
-            EnumGLToName[s_CodegenEnumGLToName[i].value].insert(&s_CodegenEnumGLToName[i].name);
-        }
-    }
-
-    static EnumMapCache* get() {
-        if (!s_cache.get()) {
-            s_cache = std::make_shared<EnumMapCache>();
-        }
-        return s_cache.get();
-    }
-
-    static std::shared_ptr<EnumMapCache> s_cache;
-    std::map<gl_t, std::set<GLEnumName*>> EnumGLToName;
-
-    static struct CodegenEnumGLToName {
-        //CodegenEnumGLToName(gl_t v, GLEnumName n):value(v), name(n) {}
-        gl_t value;
-        GLEnumName name;
-    } s_CodegenEnumGLToName[];
+struct EnumGroupNameEntry {
+    gl_t m_value;
+    GLEnumGroup m_group;
+    const char* m_name;
 };
 
+// Both tables are emitted by codegen sorted by value (and group), so lookups
+// are binary searches over static data.
+static const EnumNameEntry s_EnumNames[] = {
+#define ENUM_NAME_ENTRY(value, name) {value, #name},
+#define ENUM_GROUP_NAME_ENTRY(value, group, name)
+#include "codegen_gl_enum_name_table.inl"
+#undef ENUM_GROUP_NAME_ENTRY
+#undef ENUM_NAME_ENTRY
+};
 
-
-EnumMapCache::CodegenEnumGLToName EnumMapCache::s_CodegenEnumGLToName[] = {
-
-#define ENUM_LIST_ELEMENT(name, value, ...) \
-    {(gl_t)value,  { #name, {__VA_ARGS__, GLEnumGroup::NoneGroup}}},
-#include "codegen_gl_enum_list.inl"
-#undef ENUM_LIST_ELEMENT
-    {0,  {nullptr, {}}},
+static const EnumGroupNameEntry s_EnumGroupNames[] = {
+#define ENUM_NAME_ENTRY(value, name)
+#define ENUM_GROUP_NAME_ENTRY(value, group, name) {value, group, #name},
+#include "codegen_gl_enum_name_table.inl"
+#undef ENUM_GROUP_NAME_ENTRY
+#undef ENUM_NAME_ENTRY
 };
 
+inline bool operator<(const EnumNameEntry& lhs, gl_t rhs) {
+    return lhs.m_value < rhs;
+}
 
-std::shared_ptr<EnumMapCache> EnumMapCache::s_cache;
+inline bool operator<(const EnumGroupNameEntry& lhs,
+                      const std::pair<gl_t, GLEnumGroup>& rhs) {
+    return lhs.m_value < rhs.first ||
+           (lhs.m_value == rhs.first && lhs.m_group < rhs.second);
+}
 
 } //namespace lists
 
-std::string GetGLEnumName(gl_t glEnum, GLEnumGroup group) {
-
-    std::map<gl_t, std::set<lists::GLEnumName*>>::iterator nameSetPtr =
-            lists::EnumMapCache::get()->EnumGLToName.find(glEnum);
-
-    if (nameSetPtr == lists::EnumMapCache::get()->EnumGLToName.end()) {
+const char* FindGLEnumName(gl_t glEnum, GLEnumGroup group) {
 
-        //unknown enum, return hex value string.
-        std::ostringstream tmp;
-        tmp << "0x" << std::hex << glEnum;
-        return tmp.str();
+    if (group != GLEnumGroup::NoneGroup) {
+        std::pair<gl_t, GLEnumGroup> key(glEnum, group);
+        const lists::EnumGroupNameEntry* end = std::end(lists::s_EnumGroupNames);
+        const lists::EnumGroupNameEntry* i =
+                std::lower_bound(std::begin(lists::s_EnumGroupNames), end, key);
+        if (i != end && i->m_value == glEnum && i->m_group == group) {
+            //found name matching requested enum group.
+            return i->m_name;
+        }
     }
 
-    std::set<lists::GLEnumName*>& nameSet = nameSetPtr->second;
-
-    for (std::set<lists::GLEnumName*>::iterator i = nameSet.begin(); 
-        i != nameSet.end(); ++i) {
-
-        for (size_t j = 0; (*i)->m_groups[j] != GLEnumGroup::NoneGroup; j++) {
-            if ((*i)->m_groups[j] == group) {
-                //found name matching requested enum group.
-                return (*i)->m_name;
-            }
-        }
+    //requested group does not match any known name of this value. Return any name.
+    const lists::EnumNameEntry* end = std::end(lists::s_EnumNames);
+    const lists::EnumNameEntry* i =
+            std::lower_bound(std::begin(lists::s_EnumNames), end, glEnum);
+    if (i != end && i->m_value == glEnum) {
+        return i->m_name;
     }
+    return nullptr;
+}
 
-    //requested group does not match any known name of this entrypoint. Return any name.
+std::string GetGLEnumName(gl_t glEnum, GLEnumGroup group) {
+    const char* name = FindGLEnumName(glEnum, group);
+    if (name) {
+        return name;
+    }
 
-    return (*nameSet.begin())->m_name;
+    //unknown enum, return hex value string.
+    std::ostringstream tmp;
+    tmp << "0x" << std::hex << glEnum;
+    return tmp.str();
 }
 
 std::string GetShaderStageName(gl_t glEnum) {
@@ -32,6 +32,16 @@ enum class GLEnumGroup {
 };
 #undef ENUM_GROUP_LIST_ELEMENT
 
+/**
+ * Get name of GL enum, preferring name belonging to given group.
+ *
+ * Returns pointer to static string, or nullptr for unknown values. Does not allocate.
+ */
+const char* FindGLEnumName(gl_t glEnum, GLEnumGroup group = GLEnumGroup::NoneGroup);
+
+/**
+ * As FindGLEnumName, but returns hex string for unknown values.
+ */
 std::string GetGLEnumName(gl_t glEnum, GLEnumGroup group = GLEnumGroup::NoneGroup);
 
 std::string GetShaderStageName(gl_t glEnum);
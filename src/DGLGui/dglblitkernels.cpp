@@ -0,0 +1,586 @@
+/* Copyright (C) 2016 Slawomir Cygan <slawomir.cygan@gmail.com>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "dglblitkernels.h"
+
+#include <cstring>
+#include <stdint.h>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DGL_BLIT_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#define DGL_BLIT_AVX2
+#define DGL_BLIT_AVX2_TARGET
+#include <immintrin.h>
+#include <intrin.h>
+#elif defined(__GNUC__)
+#define DGL_BLIT_AVX2
+#define DGL_BLIT_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#endif
+
+namespace blitkernels {
+
+namespace {
+
+/**
+ * Source data types. toFloat() must perform exactly the same operations, as
+ * conversions in blt:: namespace of pixeltransfer.cpp.
+ */
+struct UNORM8 {
+    typedef uint8_t type;
+    static float toFloat(type v) { return v / 255.f; }
+};
+
+struct UNORM16 {
+    typedef uint16_t type;
+    static float toFloat(type v) { return v / 65535.f; }
+};
+
+struct FLOAT32 {
+    typedef float type;
+    static float toFloat(type v) { return v; }
+};
+
+/**
+ * Output formats. Layout must match DGLBlitterBase::outputOffsets.
+ */
+template <DGLBlitterBase::OutputFormat Format>
+struct Output;
+
+template <>
+struct Output<DGLBlitterBase::_GL_BGRA32> {
+    static const size_t kPixelSize = 4;
+    static int offset(int channel) {
+        static const int offsets[] = {2, 1, 0, 3};
+        return offsets[channel];
+    }
+};
+
+template <>
+struct Output<DGLBlitterBase::_GL_RGBX32> {
+    static const size_t kPixelSize = 3;
+    static int offset(int channel) {
+        static const int offsets[] = {0, 1, 2, -1};
+        return offsets[channel];
+    }
+};
+
+template <>
+struct Output<DGLBlitterBase::_GL_MONO8> {
+    static const size_t kPixelSize = 1;
+    static int offset(int channel) { return channel ? -1 : 0; }
+};
+
+inline unsigned char toByte(float v, const std::pair<float, float>& sb) {
+    float x = v * sb.first + sb.second;
+    x = x < 1.0f ? x : 1.0f;
+    x = x > 0.0f ? x : 0.0f;
+    return static_cast<unsigned char>(x * 255.0f);
+}
+
+template <class Src, int Components, DGLBlitterBase::OutputFormat Format>
+inline void blitPixel(const unsigned char* src, unsigned char* dst,
+                      const std::pair<float, float>* scaleBias) {
+    float temp[4] = {0.f, 0.f, 0.f, 1.f};
+    typename Src::type in[Components];
+    memcpy(in, src, sizeof(in));
+    for (int i = 0; i < Components; i++) {
+        temp[i] = Src::toFloat(in[i]);
+    }
+    for (int i = 0; i < 4; i++) {
+        int out = Output<Format>::offset(i);
+        if (out >= 0) {
+            dst[out] = toByte(temp[i], scaleBias[out]);
+        }
+    }
+}
+
+template <class Src, int Components, DGLBlitterBase::OutputFormat Format>
+inline void blitPixels(const unsigned char* src, unsigned char* dst,
+                       size_t count,
+                       const std::pair<float, float>* scaleBias) {
+    for (size_t x = 0; x < count; x++) {
+        blitPixel<Src, Components, Format>(
+                src + x * sizeof(typename Src::type) * Components,
+                dst + x * Output<Format>::kPixelSize, scaleBias);
+    }
+}
+
+template <class Src, int Components, DGLBlitterBase::OutputFormat Format>
+void blitScalar(size_t width, size_t height, const void* src, void* dst,
+                size_t srcStride, size_t dstStride,
+                const std::pair<float, float>* scaleBias) {
+    for (size_t y = 0; y < height; y++) {
+        blitPixels<Src, Components, Format>(
+                reinterpret_cast<const unsigned char*>(src) + y * srcStride,
+                reinterpret_cast<unsigned char*>(dst) + y * dstStride, width,
+                scaleBias);
+    }
+}
+
+#ifdef DGL_BLIT_SSE2
+
+/**
+ * Load single pixel to vector, channel i in lane i. Missing channels are set
+ * to {0, 0, 0, 1}, as in generic blitFunc.
+ */
+template <class Src, int Components>
+struct LoadSSE2;
+
+template <int Components>
+inline __m128 withDefaultsSSE2(__m128 v) {
+    const __m128 mask = _mm_castsi128_ps(
+            _mm_setr_epi32(-1, Components > 1 ? -1 : 0,
+                           Components > 2 ? -1 : 0, Components > 3 ? -1 : 0));
+    const __m128 defaults =
+            _mm_setr_ps(0.f, 0.f, 0.f, Components > 3 ? 0.f : 1.f);
+    return _mm_or_ps(_mm_and_ps(v, mask), defaults);
+}
+
+template <int Components>
+struct LoadSSE2<UNORM8, Components> {
+    static __m128 pixel(const unsigned char* src) {
+        int packed = 0;
+        memcpy(&packed, src, Components);
+        __m128i v = _mm_cvtsi32_si128(packed);
+        v = _mm_unpacklo_epi8(v, _mm_setzero_si128());
+        v = _mm_unpacklo_epi16(v, _mm_setzero_si128());
+        return withDefaultsSSE2<Components>(
+                _mm_div_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(255.f)));
+    }
+    static __m128 mono(const unsigned char* src) {
+        int packed;
+        memcpy(&packed, src, sizeof(packed));
+        __m128i v = _mm_cvtsi32_si128(packed);
+        v = _mm_unpacklo_epi8(v, _mm_setzero_si128());
+        v = _mm_unpacklo_epi16(v, _mm_setzero_si128());
+        return _mm_div_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(255.f));
+    }
+};
+
+template <int Components>
+struct LoadSSE2<UNORM16, Components> {
+    static __m128 pixel(const unsigned char* src) {
+        uint16_t packed[8] = {0};
+        memcpy(packed, src, Components * sizeof(uint16_t));
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(packed));
+        v = _mm_unpacklo_epi16(v, _mm_setzero_si128());
+        return withDefaultsSSE2<Components>(
+                _mm_div_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(65535.f)));
+    }
+    static __m128 mono(const unsigned char* src) {
+        __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+        v = _mm_unpacklo_epi16(v, _mm_setzero_si128());
+        return _mm_div_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(65535.f));
+    }
+};
+
+template <int Components>
+struct LoadSSE2<FLOAT32, Components> {
+    static __m128 pixel(const unsigned char* src) {
+        float temp[4] = {0.f, 0.f, 0.f, 1.f};
+        memcpy(temp, src, Components * sizeof(float));
+        return _mm_loadu_ps(temp);
+    }
+    static __m128 mono(const unsigned char* src) {
+        return _mm_loadu_ps(reinterpret_cast<const float*>(src));
+    }
+};
+
+/**
+ * Reorder channels of single pixel, so lane i is written to output byte i.
+ */
+template <DGLBlitterBase::OutputFormat Format>
+inline __m128 toOutputOrderSSE2(__m128 v) {
+    return v;
+}
+
+template <>
+inline __m128 toOutputOrderSSE2<DGLBlitterBase::_GL_BGRA32>(__m128 v) {
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 1, 2));
+}
+
+/**
+ * Scale, bias, clamp to [0, 1] and convert to [0, 255] integers. Order of
+ * operations (and NaN handling of min/max) follows generic blitFunc.
+ */
+inline __m128i toBytesSSE2(__m128 v, __m128 scale, __m128 bias) {
+    v = _mm_add_ps(_mm_mul_ps(v, scale), bias);
+    v = _mm_min_ps(v, _mm_set1_ps(1.0f));
+    v = _mm_max_ps(v, _mm_setzero_ps());
+    return _mm_cvttps_epi32(_mm_mul_ps(v, _mm_set1_ps(255.0f)));
+}
+
+template <class Src, int Components, DGLBlitterBase::OutputFormat Format>
+void blitSSE2(size_t width, size_t height, const void* src, void* dst,
+              size_t srcStride, size_t dstStride,
+              const std::pair<float, float>* scaleBias) {
+
+    const size_t srcPixelSize = sizeof(typename Src::type) * Components;
+    const size_t dstPixelSize = Output<Format>::kPixelSize;
+
+    const bool mono = Format == DGLBlitterBase::_GL_MONO8 && Components == 1;
+
+    __m128 scale, bias;
+    if (mono) {
+        scale = _mm_set1_ps(scaleBias[0].first);
+        bias = _mm_set1_ps(scaleBias[0].second);
+    } else {
+        scale = _mm_setr_ps(scaleBias[0].first, scaleBias[1].first,
+                            scaleBias[2].first, scaleBias[3].first);
+        bias = _mm_setr_ps(scaleBias[0].second, scaleBias[1].second,
+                           scaleBias[2].second, scaleBias[3].second);
+    }
+
+    for (size_t y = 0; y < height; y++) {
+        const unsigned char* srcPtr =
+                reinterpret_cast<const unsigned char*>(src) + y * srcStride;
+        unsigned char* dstPtr =
+                reinterpret_cast<unsigned char*>(dst) + y * dstStride;
+
+        size_t x = 0;
+        if (mono) {
+            // 4 pixels per vector
+            for (; x + 4 <= width; x += 4) {
+                __m128i v = toBytesSSE2(LoadSSE2<Src, 1>::mono(srcPtr), scale,
+                                        bias);
+                v = _mm_packs_epi32(v, v);
+                v = _mm_packus_epi16(v, v);
+                int packed = _mm_cvtsi128_si32(v);
+                memcpy(dstPtr, &packed, 4);
+                srcPtr += 4 * srcPixelSize;
+                dstPtr += 4;
+            }
+        } else {
+            // 4 pixels per iteration, single pixel per vector
+            for (; x + 4 <= width; x += 4) {
+                __m128i v[4];
+                for (int i = 0; i < 4; i++) {
+                    v[i] = toBytesSSE2(
+                            toOutputOrderSSE2<Format>(
+                                    LoadSSE2<Src, Components>::pixel(
+                                            srcPtr + i * srcPixelSize)),
+                            scale, bias);
+                }
+                __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(v[0], v[1]),
+                                                 _mm_packs_epi32(v[2], v[3]));
+                if (dstPixelSize == 4) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dstPtr),
+                                     bytes);
+                } else {
+                    unsigned char temp[16];
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(temp), bytes);
+                    for (int i = 0; i < 4; i++) {
+                        memcpy(dstPtr + i * dstPixelSize, temp + i * 4,
+                               dstPixelSize);
+                    }
+                }
+                srcPtr += 4 * srcPixelSize;
+                dstPtr += 4 * dstPixelSize;
+            }
+        }
+        blitPixels<Src, Components, Format>(srcPtr, dstPtr, width - x,
+                                            scaleBias);
+    }
+}
+
+#endif    // DGL_BLIT_SSE2
+
+#ifdef DGL_BLIT_AVX2
+
+/**
+ * Load two pixels to vector, one pixel per 128-bit lane.
+ */
+template <class Src, int Components>
+struct LoadAVX2;
+
+template <int Components>
+DGL_BLIT_AVX2_TARGET inline __m256 withDefaultsAVX2(__m256 v) {
+    const __m256 mask = _mm256_castsi256_ps(_mm256_setr_epi32(
+            -1, Components > 1 ? -1 : 0, Components > 2 ? -1 : 0,
+            Components > 3 ? -1 : 0, -1, Components > 1 ? -1 : 0,
+            Components > 2 ? -1 : 0, Components > 3 ? -1 : 0));
+    const float w = Components > 3 ? 0.f : 1.f;
+    const __m256 defaults = _mm256_setr_ps(0.f, 0.f, 0.f, w, 0.f, 0.f, 0.f, w);
+    return _mm256_or_ps(_mm256_and_ps(v, mask), defaults);
+}
+
+template <int Components>
+struct LoadAVX2<UNORM8, Components> {
+    DGL_BLIT_AVX2_TARGET static __m256 pixels(const unsigned char* src) {
+        unsigned char packed[16] = {0};
+        memcpy(packed, src, Components);
+        memcpy(packed + 4, src + Components, Components);
+        __m256i v = _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(packed)));
+        return withDefaultsAVX2<Components>(
+                _mm256_div_ps(_mm256_cvtepi32_ps(v), _mm256_set1_ps(255.f)));
+    }
+    DGL_BLIT_AVX2_TARGET static __m256 mono(const unsigned char* src) {
+        __m256i v = _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)));
+        return _mm256_div_ps(_mm256_cvtepi32_ps(v), _mm256_set1_ps(255.f));
+    }
+};
+
+template <int Components>
+struct LoadAVX2<UNORM16, Components> {
+    DGL_BLIT_AVX2_TARGET static __m256 pixels(const unsigned char* src) {
+        uint16_t packed[8] = {0};
+        memcpy(packed, src, Components * sizeof(uint16_t));
+        memcpy(packed + 4, src + Components * sizeof(uint16_t),
+               Components * sizeof(uint16_t));
+        __m256i v = _mm256_cvtepu16_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(packed)));
+        return withDefaultsAVX2<Components>(_mm256_div_ps(
+                _mm256_cvtepi32_ps(v), _mm256_set1_ps(65535.f)));
+    }
+    DGL_BLIT_AVX2_TARGET static __m256 mono(const unsigned char* src) {
+        __m256i v = _mm256_cvtepu16_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+        return _mm256_div_ps(_mm256_cvtepi32_ps(v), _mm256_set1_ps(65535.f));
+    }
+};
+
+template <int Components>
+struct LoadAVX2<FLOAT32, Components> {
+    DGL_BLIT_AVX2_TARGET static __m256 pixels(const unsigned char* src) {
+        float temp[8] = {0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f};
+        memcpy(temp, src, Components * sizeof(float));
+        memcpy(temp + 4, src + Components * sizeof(float),
+               Components * sizeof(float));
+        return _mm256_loadu_ps(temp);
+    }
+    DGL_BLIT_AVX2_TARGET static __m256 mono(const unsigned char* src) {
+        return _mm256_loadu_ps(reinterpret_cast<const float*>(src));
+    }
+};
+
+template <DGLBlitterBase::OutputFormat Format>
+DGL_BLIT_AVX2_TARGET inline __m256 toOutputOrderAVX2(__m256 v) {
+    return v;
+}
+
+template <>
+DGL_BLIT_AVX2_TARGET inline __m256
+toOutputOrderAVX2<DGLBlitterBase::_GL_BGRA32>(__m256 v) {
+    return _mm256_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 1, 2));
+}
+
+/**
+ * AVX2 variant of toBytesSSE2(). No FMA is used, to stay bit-exact.
+ */
+DGL_BLIT_AVX2_TARGET inline __m256i toBytesAVX2(__m256 v, __m256 scale,
+                                                __m256 bias) {
+    v = _mm256_add_ps(_mm256_mul_ps(v, scale), bias);
+    v = _mm256_min_ps(v, _mm256_set1_ps(1.0f));
+    v = _mm256_max_ps(v, _mm256_setzero_ps());
+    return _mm256_cvttps_epi32(_mm256_mul_ps(v, _mm256_set1_ps(255.0f)));
+}
+
+/**
+ * Pack 8 int32 values in [0, 255] range of each vector to 16 bytes.
+ */
+DGL_BLIT_AVX2_TARGET inline __m128i packBytesAVX2(__m256i a, __m256i b) {
+    return _mm_packus_epi16(
+            _mm_packs_epi32(_mm256_castsi256_si128(a),
+                            _mm256_extracti128_si256(a, 1)),
+            _mm_packs_epi32(_mm256_castsi256_si128(b),
+                            _mm256_extracti128_si256(b, 1)));
+}
+
+template <class Src, int Components, DGLBlitterBase::OutputFormat Format>
+DGL_BLIT_AVX2_TARGET void blitAVX2(size_t width, size_t height,
+                                   const void* src, void* dst,
+                                   size_t srcStride, size_t dstStride,
+                                   const std::pair<float, float>* scaleBias) {
+
+    const size_t srcPixelSize = sizeof(typename Src::type) * Components;
+    const size_t dstPixelSize = Output<Format>::kPixelSize;
+
+    const bool mono = Format == DGLBlitterBase::_GL_MONO8 && Components == 1;
+
+    __m256 scale, bias;
+    if (mono) {
+        scale = _mm256_set1_ps(scaleBias[0].first);
+        bias = _mm256_set1_ps(scaleBias[0].second);
+    } else {
+        scale = _mm256_setr_ps(scaleBias[0].first, scaleBias[1].first,
+                               scaleBias[2].first, scaleBias[3].first,
+                               scaleBias[0].first, scaleBias[1].first,
+                               scaleBias[2].first, scaleBias[3].first);
+        bias = _mm256_setr_ps(scaleBias[0].second, scaleBias[1].second,
+                              scaleBias[2].second, scaleBias[3].second,
+                              scaleBias[0].second, scaleBias[1].second,
+                              scaleBias[2].second, scaleBias[3].second);
+    }
+
+    for (size_t y = 0; y < height; y++) {
+        const unsigned char* srcPtr =
+                reinterpret_cast<const unsigned char*>(src) + y * srcStride;
+        unsigned char* dstPtr =
+                reinterpret_cast<unsigned char*>(dst) + y * dstStride;
+
+        size_t x = 0;
+        if (mono) {
+            // 16 pixels per iteration, 8 pixels per vector
+            for (; x + 16 <= width; x += 16) {
+                __m128i bytes = packBytesAVX2(
+                        toBytesAVX2(LoadAVX2<Src, 1>::mono(srcPtr), scale,
+                                    bias),
+                        toBytesAVX2(
+                                LoadAVX2<Src, 1>::mono(srcPtr + 8 * srcPixelSize),
+                                scale, bias));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dstPtr), bytes);
+                srcPtr += 16 * srcPixelSize;
+                dstPtr += 16;
+            }
+        } else {
+            // 4 pixels per iteration, 2 pixels per vector
+            for (; x + 4 <= width; x += 4) {
+                __m128i bytes = packBytesAVX2(
+                        toBytesAVX2(toOutputOrderAVX2<Format>(
+                                            LoadAVX2<Src, Components>::pixels(
+                                                    srcPtr)),
+                                    scale, bias),
+                        toBytesAVX2(toOutputOrderAVX2<Format>(
+                                            LoadAVX2<Src, Components>::pixels(
+                                                    srcPtr + 2 * srcPixelSize)),
+                                    scale, bias));
+                if (dstPixelSize == 4) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dstPtr),
+                                     bytes);
+                } else {
+                    unsigned char temp[16];
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(temp), bytes);
+                    for (int i = 0; i < 4; i++) {
+                        memcpy(dstPtr + i * dstPixelSize, temp + i * 4,
+                               dstPixelSize);
+                    }
+                }
+                srcPtr += 4 * srcPixelSize;
+                dstPtr += 4 * dstPixelSize;
+            }
+        }
+        blitPixels<Src, Components, Format>(srcPtr, dstPtr, width - x,
+                                            scaleBias);
+    }
+}
+
+#endif    // DGL_BLIT_AVX2
+
+template <class Src, int Components, DGLBlitterBase::OutputFormat Format>
+Kernel getKernel(ISA isa) {
+#ifdef DGL_BLIT_AVX2
+    if (isa == ISA::AVX2) {
+        return blitAVX2<Src, Components, Format>;
+    }
+#endif
+#ifdef DGL_BLIT_SSE2
+    if (isa != ISA::Scalar) {
+        return blitSSE2<Src, Components, Format>;
+    }
+#endif
+    (void)isa;
+    return blitScalar<Src, Components, Format>;
+}
+
+template <class Src, int Components>
+Kernel getKernel(DGLBlitterBase::OutputFormat format, ISA isa) {
+    switch (format) {
+        case DGLBlitterBase::_GL_BGRA32:
+            return getKernel<Src, Components, DGLBlitterBase::_GL_BGRA32>(isa);
+        case DGLBlitterBase::_GL_RGBX32:
+            return getKernel<Src, Components, DGLBlitterBase::_GL_RGBX32>(isa);
+        case DGLBlitterBase::_GL_MONO8:
+            return getKernel<Src, Components, DGLBlitterBase::_GL_MONO8>(isa);
+        default:
+            return nullptr;
+    }
+}
+
+template <class Src>
+Kernel getKernel(int components, DGLBlitterBase::OutputFormat format,
+                 ISA isa) {
+    switch (components) {
+        case 1:
+            return getKernel<Src, 1>(format, isa);
+        case 2:
+            return getKernel<Src, 2>(format, isa);
+        case 3:
+            return getKernel<Src, 3>(format, isa);
+        case 4:
+            return getKernel<Src, 4>(format, isa);
+        default:
+            return nullptr;
+    }
+}
+
+ISA detectISA() {
+#ifdef DGL_BLIT_AVX2
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] >= 7) {
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        __cpuidex(info, 7, 0);
+        bool avx2 = (info[1] & (1 << 5)) != 0;
+        if (osxsave && avx && avx2 && (_xgetbv(0) & 6) == 6) {
+            return ISA::AVX2;
+        }
+    }
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return ISA::AVX2;
+    }
+#endif
+#endif
+#ifdef DGL_BLIT_SSE2
+    return ISA::SSE2;
+#else
+    return ISA::Scalar;
+#endif
+}
+
+}    // namespace
+
+ISA getBestISA() {
+    static const ISA best = detectISA();
+    return best;
+}
+
+Kernel getKernel(gl_t type, int components,
+                 DGLBlitterBase::OutputFormat format, ISA isa) {
+    switch (type) {
+        case GL_UNSIGNED_BYTE:
+            return getKernel<UNORM8>(components, format, isa);
+        case GL_UNSIGNED_SHORT:
+            return getKernel<UNORM16>(components, format, isa);
+        case GL_FLOAT:
+            return getKernel<FLOAT32>(components, format, isa);
+        default:
+            return nullptr;
+    }
+}
+
+}    // namespace blitkernels
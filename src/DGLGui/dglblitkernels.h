@@ -0,0 +1,69 @@
+/* Copyright (C) 2016 Slawomir Cygan <slawomir.cygan@gmail.com>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#ifndef DGLBLITKERNELS_H
+#define DGLBLITKERNELS_H
+
+#include <utility>
+
+#include "dglblitterbase.h"
+
+/**
+ * Specialized pixel conversion kernels for DGLBlitterBase.
+ *
+ * Each kernel is compiled for single (source type, component count, output
+ * format) tuple, so no per-pixel indirect calls and output offset lookups are
+ * made. Results are bit-exact with generic GLDataType::blitFunc.
+ */
+namespace blitkernels {
+
+/**
+ * Instruction set used by kernel
+ */
+enum class ISA {
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+/**
+ * Get best instruction set supported by both this build and host CPU
+ */
+ISA getBestISA();
+
+/**
+ * Kernel converting width x height pixels from src to dst.
+ *
+ * scaleBias holds 4 (scale, bias) pairs, indexed by output byte position
+ * (same as in GLDataType::blitFunc).
+ */
+typedef void (*Kernel)(size_t width, size_t height, const void* src,
+                       void* dst, size_t srcStride, size_t dstStride,
+                       const std::pair<float, float>* scaleBias);
+
+/**
+ * Get kernel for given source data type, component count and output format.
+ *
+ * Returns nullptr, if there is no specialized kernel for this combination -
+ * generic GLDataType::blitFunc should be used then. If requested ISA is not
+ * available in this build, kernel for lower one is returned.
+ */
+Kernel getKernel(gl_t type, int components,
+                 DGLBlitterBase::OutputFormat format, ISA isa);
+
+}    // namespace blitkernels
+
+#endif    // DGLBLITKERNELS_H
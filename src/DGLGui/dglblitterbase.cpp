@@ -13,14 +13,146 @@
 * limitations under the License.
 */
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
 
 #include "dglblitterbase.h"
+#include "dglblitkernels.h"
 
 #include <DGLNet/protocol/pixeltransfer.h>
 
+namespace {
+
+/**
+ * Number of rows converted by single task. Small enough for obsolete blits to
+ * be abandoned quickly.
+ */
+const size_t kBandRows = 64;
+
+/**
+ * Pool of threads shared by all blitters.
+ */
+class BlitterThreadPool {
+   public:
+    static BlitterThreadPool* get() {
+        // never deleted: workers are not joined during static destruction
+        static BlitterThreadPool* pool = new BlitterThreadPool();
+        return pool;
+    }
+
+    void post(const std::function<void()>& task) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Tasks.push_back(task);
+        }
+        m_TaskReady.notify_one();
+    }
+
+   private:
+    BlitterThreadPool() {
+        // hardware_concurrency() may return 0, if unknown
+        unsigned int count =
+                std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int i = 0; i < count; i++) {
+            m_Threads.push_back(std::thread(&BlitterThreadPool::run, this));
+        }
+    }
+
+    void run() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_TaskReady.wait(lock, [this] { return !m_Tasks.empty(); });
+                task = m_Tasks.front();
+                m_Tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> m_Threads;
+    std::deque<std::function<void()> > m_Tasks;
+    std::mutex m_Mutex;
+    std::condition_variable m_TaskReady;
+};
+
+}    // namespace
+
+struct DGLBlitterBase::SinkState {
+    SinkState(DGLBlitterBase* blitter)
+            : m_Blitter(blitter), m_Generation(0), m_ActiveBands(0) {}
+
+    /**
+     * Obsolete all blits and wait for their bands in progress, so their
+     * source data is not read anymore. Requires m_Mutex to be locked.
+     */
+    unsigned int obsolete(std::unique_lock<std::mutex>& lock) {
+        unsigned int generation = ++m_Generation;
+        m_BandDone.wait(lock, [this] { return m_ActiveBands == 0; });
+        return generation;
+    }
+
+    /**
+     * Guards m_Blitter, m_ActiveBands and serializes sink() with cancel()
+     */
+    std::mutex m_Mutex;
+
+    /**
+     * Signalled, when band in progress is done
+     */
+    std::condition_variable m_BandDone;
+
+    /**
+     * Owning blitter, NULL if destroyed
+     */
+    DGLBlitterBase* m_Blitter;
+
+    /**
+     * Generation of most recent blit. Jobs of other generations are obsolete.
+     */
+    std::atomic<unsigned int> m_Generation;
+
+    /**
+     * Number of bands reading source data right now
+     */
+    size_t m_ActiveBands;
+};
+
+struct DGLBlitterBase::Job {
+    std::shared_ptr<SinkState> m_Sink;
+    unsigned int m_Generation;
+
+    const unsigned char* m_SrcData;
+    std::shared_ptr<const void> m_SrcDataOwner;
+    size_t m_SrcStride, m_SrcPixelSize;
+    const GLDataType* m_DataType;
+    int m_Components;
+
+    OutputFormat m_OutputFormat;
+    size_t m_DstStride, m_DstPixelSize;
+    size_t m_Width, m_Height;
+    std::pair<float, float> m_ScaleBias[4];
+
+    blitkernels::Kernel m_Kernel;
+
+    std::shared_ptr<std::vector<char> > m_Output;
+
+    /**
+     * Number of bands not converted yet
+     */
+    std::atomic<size_t> m_RemainingBands;
+};
+
 DGLBlitterBase::DGLBlitterBase()
-        : m_SrcData(nullptr),
+        : m_SinkState(std::make_shared<SinkState>(this)),
+          m_SrcData(nullptr),
           m_DataFormat(nullptr), 
           m_DataType(nullptr), 
           m_Width(0),
@@ -33,9 +165,16 @@ DGLBlitterBase::DGLBlitterBase()
     }
 }
 
+DGLBlitterBase::~DGLBlitterBase() {
+    std::unique_lock<std::mutex> lock(m_SinkState->m_Mutex);
+    m_SinkState->obsolete(lock);
+    m_SinkState->m_Blitter = nullptr;
+}
+
 void DGLBlitterBase::blit(unsigned int width, unsigned int height,
                           unsigned int rowBytes, gl_t format, gl_t type,
-                          const void* data) {
+                          const void* data,
+                          std::shared_ptr<const void> dataOwner) {
 
     m_SrcStride = rowBytes;
     m_Width = width;
@@ -49,10 +188,30 @@ void DGLBlitterBase::blit(unsigned int width, unsigned int height,
     }
 
     m_SrcData = data;
+    m_SrcDataOwner = dataOwner;
 
     doBlit();
 }
 
+void DGLBlitterBase::cancel() {
+    std::unique_lock<std::mutex> lock(m_SinkState->m_Mutex);
+    m_SinkState->obsolete(lock);
+}
+
+void DGLBlitterBase::reset() {
+    cancel();
+    m_SrcData = nullptr;
+    m_SrcDataOwner.reset();
+    m_SrcStride = 0;
+    m_DataFormat = nullptr;
+    m_DataType = nullptr;
+    m_Width = m_Height = 0;
+}
+
+unsigned int DGLBlitterBase::getGeneration() const {
+    return m_SinkState->m_Generation;
+}
+
 void DGLBlitterBase::setChannelScale(Channel channel, float scale, float bias) {
     m_ChannelScaleBiases[channel] = std::pair<float, float>(scale, bias);
     if (m_DataFormat && m_DataType) {
@@ -129,15 +288,91 @@ void DGLBlitterBase::doBlit() {
     }
 
     size_t targetRowBytes = (m_Width * dstPixelSize + 4 - 1) & (-4);
-    if (outputData.size() < size_t(targetRowBytes * m_Height))
-        outputData = std::vector<char>(targetRowBytes * m_Height);
 
-    m_DataType->blitFunc(outputOffsets[outputFormat], m_Width, m_Height,
-                         m_SrcData, &outputData[0], m_SrcStride, targetRowBytes,
-                         srcPixelSize, dstPixelSize, m_DataFormat->components,
-                         channelSBs);
+    std::shared_ptr<Job> job = std::make_shared<Job>();
+    job->m_Sink = m_SinkState;
+    job->m_SrcData = reinterpret_cast<const unsigned char*>(m_SrcData);
+    job->m_SrcDataOwner = m_SrcDataOwner;
+    job->m_SrcStride = m_SrcStride;
+    job->m_SrcPixelSize = srcPixelSize;
+    job->m_DataType = m_DataType;
+    job->m_Components = m_DataFormat->components;
+    job->m_OutputFormat = outputFormat;
+    job->m_DstStride = targetRowBytes;
+    job->m_DstPixelSize = dstPixelSize;
+    job->m_Width = m_Width;
+    job->m_Height = m_Height;
+    std::copy(channelSBs, channelSBs + 4, job->m_ScaleBias);
+
+    job->m_Kernel = nullptr;
+    if (!m_DataType->packed) {
+        job->m_Kernel = blitkernels::getKernel(
+                m_DataType->type, m_DataFormat->components, outputFormat,
+                blitkernels::getBestISA());
+    }
+
+    job->m_Output =
+            std::make_shared<std::vector<char> >(targetRowBytes * m_Height);
 
-    sink(m_Width, m_Height, outputFormat, &outputData[0]);
+    // empty image is still sunk, by single empty band
+    size_t bands = std::max<size_t>(1, (m_Height + kBandRows - 1) / kBandRows);
+    job->m_RemainingBands = bands;
+
+    {
+        // obsolete previous blit, its data may be released after return
+        std::unique_lock<std::mutex> lock(m_SinkState->m_Mutex);
+        job->m_Generation = m_SinkState->obsolete(lock);
+    }
+
+    for (size_t i = 0; i < bands; i++) {
+        size_t firstRow = i * kBandRows;
+        size_t rows = std::min(kBandRows, m_Height - firstRow);
+        BlitterThreadPool::get()->post(
+                std::bind(&DGLBlitterBase::runBand, job, firstRow, rows));
+    }
+}
+
+void DGLBlitterBase::runBand(const std::shared_ptr<Job>& job, size_t firstRow,
+                             size_t rows) {
+
+    {
+        std::lock_guard<std::mutex> lock(job->m_Sink->m_Mutex);
+        if (job->m_Sink->m_Generation != job->m_Generation) {
+            // obsolete, will never be sunk
+            return;
+        }
+        // blitter waits for this band before source data is released
+        job->m_Sink->m_ActiveBands++;
+    }
+
+    if (rows && job->m_Width) {
+        const unsigned char* src = job->m_SrcData + firstRow * job->m_SrcStride;
+        char* dst = &(*job->m_Output)[firstRow * job->m_DstStride];
+        if (job->m_Kernel) {
+            job->m_Kernel(job->m_Width, rows, src, dst, job->m_SrcStride,
+                          job->m_DstStride, job->m_ScaleBias);
+        } else {
+            job->m_DataType->blitFunc(
+                    outputOffsets[job->m_OutputFormat], job->m_Width, rows,
+                    src, dst, job->m_SrcStride, job->m_DstStride,
+                    job->m_SrcPixelSize, job->m_DstPixelSize,
+                    job->m_Components, job->m_ScaleBias);
+        }
+    }
+
+    bool lastBand = --job->m_RemainingBands == 0;
+    {
+        std::lock_guard<std::mutex> lock(job->m_Sink->m_Mutex);
+        job->m_Sink->m_ActiveBands--;
+        if (lastBand && job->m_Sink->m_Blitter &&
+            job->m_Sink->m_Generation == job->m_Generation) {
+            job->m_Sink->m_Blitter->sink(
+                    static_cast<int>(job->m_Width),
+                    static_cast<int>(job->m_Height), job->m_OutputFormat,
+                    job->m_Output, job->m_Generation);
+        }
+    }
+    job->m_Sink->m_BandDone.notify_all();
 }
 
 std::vector<AnyValue> DGLBlitterBase::describePixel(unsigned int x,
@@ -16,6 +16,7 @@
 #ifndef DGLBLITTERBASE_H
 #define DGLBLITTERBASE_H
 
+#include <memory>
 #include <vector>
 
 #include <DGLCommon/gl-headers.h>
@@ -24,13 +25,53 @@
 struct GLDataFormat;
 struct GLDataType;
 
+/**
+ * Converts pixel rectangles of any GL format and type to 8-bit BGRA, RGB or
+ * mono images.
+ *
+ * Conversion is asynchronous: image is split into row bands, converted on a
+ * pool of threads shared by all blitters. Result is passed to sink() on one of
+ * these threads. Every blit() or setChannelScale() obsoletes blit in progress:
+ * results of obsolete blits are never sunk. Obsoleting a blit waits for its
+ * bands already being converted; bands not started yet never read its data.
+ */
 class DGLBlitterBase {
 
    public:
     DGLBlitterBase();
-
+    virtual ~DGLBlitterBase();
+
+    /**
+     * Start blit of pixel rectangle.
+     *
+     * Data must be valid until blitter is destroyed, reset(), cancel()-ed or
+     * given another data: all of these return only after conversion stops
+     * reading it. Alternatively, data may be kept alive by dataOwner.
+     */
     void blit(unsigned int width, unsigned int height, unsigned int rowBytes,
-              gl_t format, gl_t type, const void* data);
+              gl_t format, gl_t type, const void* data,
+              std::shared_ptr<const void> dataOwner = nullptr);
+
+    /**
+     * Cancel blit in progress. When returns, sink() is not (and will not be)
+     * called for any blit started before, and its source data is not read
+     * anymore.
+     *
+     * Subclasses must call it in destructor.
+     */
+    void cancel();
+
+    /**
+     * Cancel blit in progress and drop source data, so it can be freed by its
+     * owner.
+     */
+    void reset();
+
+    /**
+     * Get generation of most recent blit. Generation is passed to sink(), so
+     * result may be validated against it on receiving thread.
+     */
+    unsigned int getGeneration() const;
 
     enum Channel {
         CHANNEL_R,
@@ -56,21 +97,43 @@ class DGLBlitterBase {
     static const int outputOffsets[3][4];
 
    protected:
+    /**
+     * Called on blitter thread, when blit is finished. Rows of data are
+     * aligned to 4 bytes. Data may be retained by implementation.
+     */
     virtual void sink(int width, int height, OutputFormat format,
-                      void* data) = 0;
+                      const std::shared_ptr<std::vector<char> >& data,
+                      unsigned int generation) = 0;
 
     void doBlit();
 
    private:
+    /**
+     * State shared by blitter and its jobs in progress
+     */
+    struct SinkState;
+
+    /**
+     * Single blit in progress
+     */
+    struct Job;
+
+    /**
+     * Convert band of rows, sink result if this is last band of job.
+     */
+    static void runBand(const std::shared_ptr<Job>& job, size_t firstRow,
+                        size_t rows);
+
+    std::shared_ptr<SinkState> m_SinkState;
+
     const void* m_SrcData;
+    std::shared_ptr<const void> m_SrcDataOwner;
 
     unsigned int m_SrcStride;
     const GLDataFormat* m_DataFormat;
     const GLDataType* m_DataType;
     size_t m_Width, m_Height;
 
-    std::vector<char> outputData;
-
     std::pair<float, float> m_ChannelScaleBiases[_LAST_CHANNEL];
 };
 
@@ -39,6 +39,8 @@ DGLBufferViewItem::DGLBufferViewItem(dglnet::ContextObjectName name,
     m_Listener->setEnabled(parrent->isVisible());
     CONNASSERT(parrent, SIGNAL(visibilityChanged(bool)), m_Listener,
         SLOT(setEnabled(bool)));
+
+    setResourceListener(m_Listener);
 }
 
 void DGLBufferViewItem::error(const std::string& message) {
@@ -47,6 +49,11 @@ void DGLBufferViewItem::error(const std::string& message) {
     m_Label->show();
 }
 
+void DGLBufferViewItem::releaseResource() {
+    m_Editor->setData(QByteArray());
+    error("");
+}
+
 void DGLBufferViewItem::update(const dglnet::DGLResource& res) {
     m_Editor->show();
     m_Label->hide();
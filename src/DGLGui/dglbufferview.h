@@ -49,6 +49,8 @@ slots:
     void update(const dglnet::DGLResource& res);
 
    private:
+    virtual void releaseResource() override;
+
     QHexEdit* m_Editor;
     QLabel* m_Label;
     QVBoxLayout* m_VerticalLayout;
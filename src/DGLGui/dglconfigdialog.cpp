@@ -31,6 +31,8 @@ DGLConfigDialog::DGLConfigDialog(const DGLConfiguration& configuration,
     m_Ui.checkBoxDebugContext->setChecked(m_Configuration.m_ForceDebugContext);
     m_Ui.checkBoxDebugContextES->setChecked(
             m_Configuration.m_ForceDebugContextES);
+    m_Ui.checkBoxPushBoundResources->setChecked(
+            m_Configuration.m_PushBoundResources);
 
     m_Ui.lineEdit_Adb->setText(QString::fromStdString(adbPath));
 }
@@ -42,6 +44,8 @@ const DGLConfiguration* DGLConfigDialog::getConfig() {
             m_Ui.checkBoxDebugContext->isChecked();
     m_Configuration.m_ForceDebugContextES =
             m_Ui.checkBoxDebugContextES->isChecked();
+    m_Configuration.m_PushBoundResources =
+            m_Ui.checkBoxPushBoundResources->isChecked();
     return &m_Configuration;
 }
 
@@ -67,9 +67,14 @@ DGLResourceListener::DGLResourceListener(dglnet::ContextObjectName obName,
         : DGLRequestHandler(manager->getRequestManager()),
           m_ObjectType(type),
           m_ObjectName(obName),
+          m_BaseSnapshotId(0),
           m_Manager(manager), 
           m_Enabled(true),
-          m_Outdated(false) {}
+          m_Outdated(false),
+          m_Displayed(false),
+          m_Evicted(false),
+          m_DataSize(0),
+          m_LastDisplayed(0) {}
 
 DGLResourceListener::~DGLResourceListener() {
     m_Manager->unregisterListener(this);
@@ -77,7 +82,12 @@ DGLResourceListener::~DGLResourceListener() {
 
 void DGLResourceListener::onRequestFinished(
         const dglnet::message::utils::ReplyBase* msg) {
-        update(*dynamic_cast<const dglnet::DGLResource*>(msg));
+        const dglnet::DGLResource* resource =
+                dynamic_cast<const dglnet::DGLResource*>(msg);
+        m_DataSize = resource->getDataSize();
+        m_Evicted = false;
+        update(*resource);
+        m_Manager->enforceMemoryBudget();
 }
 
 void DGLResourceListener::onRequestFailed(
@@ -86,18 +96,38 @@ void DGLResourceListener::onRequestFailed(
 }
 
 void DGLResourceListener::fire() {
+    m_Manager->dropPushedResources();
+    query();
+}
+
+void DGLResourceListener::query() {
     if (isEnabledMarkOutDatedIfNot()) {
+        std::shared_ptr<dglnet::message::utils::ReplyBase> pushed =
+                m_Manager->takePushedResource(m_ObjectType, m_ObjectName);
+        if (pushed) {
+            onRequestFinished(pushed.get());
+            return;
+        }
         m_Manager->getRequestManager()->request(
-            new dglnet::request::QueryResource(m_ObjectType, m_ObjectName),
+            new dglnet::request::QueryResource(m_ObjectType, m_ObjectName,
+                                               m_BaseSnapshotId),
             this);
     }
 }
 
+void DGLResourceListener::setBaseSnapshotId(opaque_id_t snapshotId) {
+    m_BaseSnapshotId = snapshotId;
+}
+
+size_t DGLResourceListener::getDataSize() const { return m_DataSize; }
+
 bool DGLResourceListener::isEnabledMarkOutDatedIfNot() {
-    if (!m_Enabled) {
+    // evicted resource is not queried, until someone wants to display it
+    bool enabled = m_Enabled && (!m_Evicted || m_Displayed);
+    if (!enabled) {
         m_Outdated = true;
     }
-    return m_Enabled;
+    return enabled;
 }
 
 void DGLResourceListener::setEnabled(bool enabled) {
@@ -108,24 +138,44 @@ void DGLResourceListener::setEnabled(bool enabled) {
         //someone enabled this listener, but it already missed some queries.
         //the view may be now outdated: immediate emit empty error & request update
         error("");
-        fire();
+        query();
 
         m_Outdated = false;
     }
 }
 
+void DGLResourceListener::setDisplayed(bool displayed) {
+    m_Displayed = displayed;
+    if (displayed) {
+        m_LastDisplayed = ++m_Manager->m_DisplayCounter;
+        if (m_Enabled && m_Outdated) {
+            // resource was evicted: reload it
+            error("");
+            query();
+
+            m_Outdated = false;
+        }
+    }
+}
+
+void DGLResourceListener::evict() {
+    m_DataSize = 0;
+    m_Evicted = true;
+    m_Outdated = true;
+    evicted();
+}
+
+const size_t DGLResourceManager::kDefaultMemoryBudget = 1024 * 1024 * 1024;
+
 DGLResourceManager::DGLResourceManager(DGLRequestManager* manager)
-        : m_RequestManager(manager) {}
+        : m_RequestManager(manager),
+          m_MemoryBudget(kDefaultMemoryBudget),
+          m_DisplayCounter(0) {}
 
 void DGLResourceManager::emitQueries() {
     for (std::list<DGLResourceListener*>::iterator i = m_Listeners.begin();
          i != m_Listeners.end(); i++) {
-         if ((*i)->isEnabledMarkOutDatedIfNot()) {
-            m_RequestManager->request(
-                new dglnet::request::QueryResource((*i)->m_ObjectType,
-                (*i)->m_ObjectName),
-                *i);
-        }
+        (*i)->query();
     }
 }
 
@@ -134,9 +184,7 @@ DGLResourceListener* DGLResourceManager::createListener(
     DGLResourceListener* listener = new DGLResourceListener(name, type, this);
 
     m_Listeners.insert(m_Listeners.end(), listener);
-    if (listener->isEnabledMarkOutDatedIfNot()) {
-        listener->fire();
-    }
+    listener->query();
 
     return listener;
 }
@@ -145,6 +193,68 @@ DGLRequestManager* DGLResourceManager::getRequestManager() {
     return m_RequestManager;
 }
 
+void DGLResourceManager::setMemoryBudget(size_t bytes) {
+    m_MemoryBudget = bytes;
+    enforceMemoryBudget();
+}
+
+size_t DGLResourceManager::getMemoryBudget() const { return m_MemoryBudget; }
+
+size_t DGLResourceManager::getMemoryUsage() const {
+    size_t usage = 0;
+    for (std::list<DGLResourceListener*>::const_iterator i =
+                 m_Listeners.begin();
+         i != m_Listeners.end(); i++) {
+        usage += (*i)->getDataSize();
+    }
+    return usage;
+}
+
+void DGLResourceManager::enforceMemoryBudget() {
+    size_t usage = getMemoryUsage();
+    while (usage > m_MemoryBudget) {
+        DGLResourceListener* leastRecent = NULL;
+        for (std::list<DGLResourceListener*>::iterator i = m_Listeners.begin();
+             i != m_Listeners.end(); i++) {
+            if (!(*i)->m_Displayed && (*i)->m_DataSize &&
+                (!leastRecent ||
+                 (*i)->m_LastDisplayed < leastRecent->m_LastDisplayed)) {
+                leastRecent = *i;
+            }
+        }
+        if (!leastRecent) {
+            // everything left is displayed
+            break;
+        }
+        usage -= leastRecent->m_DataSize;
+        leastRecent->evict();
+    }
+}
+
+void DGLResourceManager::setPushedResources(
+        const std::vector<dglnet::message::PushedResource>& resources) {
+    m_PushedResources = resources;
+}
+
+void DGLResourceManager::dropPushedResources() { m_PushedResources.clear(); }
+
+std::shared_ptr<dglnet::message::utils::ReplyBase>
+DGLResourceManager::takePushedResource(dglnet::message::ObjectType type,
+                                       const dglnet::ContextObjectName& name) {
+    std::shared_ptr<dglnet::message::utils::ReplyBase> ret;
+    for (std::vector<dglnet::message::PushedResource>::iterator i =
+                 m_PushedResources.begin();
+         i != m_PushedResources.end(); i++) {
+        if (i->m_Type == type && i->m_ObjectName == name) {
+            ret = i->m_Resource;
+            // data is now owned by listener, do not hold it twice
+            m_PushedResources.erase(i);
+            break;
+        }
+    }
+    return ret;
+}
+
 void DGLResourceManager::unregisterListener(DGLResourceListener* listener) {
     for (std::list<DGLResourceListener*>::iterator i = m_Listeners.begin();
          i != m_Listeners.end(); i++) {
@@ -191,11 +301,21 @@ DglController::DglController()
           m_ConfiguredAndBkpointsSet(false),
           m_BreakPointController(this),
           m_RequestManager(this),
-          m_ResourceManager(getRequestManager()) {
-    m_Timer.setInterval(10);
-    CONNASSERT(&m_Timer, SIGNAL(timeout()), this, SLOT(poll()));
+          m_ResourceManager(getRequestManager()),
+          m_ConnectionId(0) {
+    qRegisterMetaType<dglnet::Message*>("dglnet::Message*");
+
+    // network thread emits these, handle them on GUI thread
+    connect(this, SIGNAL(networkMessage(dglnet::Message*, uint)), this,
+            SLOT(handleNetworkMessage(dglnet::Message*, uint)),
+            Qt::QueuedConnection);
+    connect(this, SIGNAL(networkDisconnect(const QString&, uint)), this,
+            SLOT(handleNetworkDisconnect(const QString&, uint)),
+            Qt::QueuedConnection);
 }
 
+DglController::~DglController() { stopNetwork(); }
+
 void DglController::connectServer(const std::string& host,
                                   const std::string& port) {
     if (m_DglClient) {
@@ -207,83 +327,80 @@ void DglController::connectServer(const std::string& host,
     m_Disconnected = false;
 
     m_DglClient = dglnet::Client::Create(this, this);
+    m_ConnectionId++;
     m_DglClient->connectServer(host, port);
-    m_Timer.start();
-}
 
-void DglController::onSocket() {
+    m_NetworkThread = std::thread(&dglnet::ITransport::run, m_DglClient);
+}
 
-// Hey! If you are trying to disable the timer-based polling here, please
-// increment the following counter.
-// You shall not succeed... on windows some socketnotifies activate()-s are
-// missed, so we get stuck and wait forever for data to be ready.
+void DglController::onSocket() {}
 
-// Timer disable try count: 2
-// m_Timer.stop();
-//
-#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
-#define QSOCK_T int
-#else
-#define QSOCK_T qintptr
-#endif
+void DglController::onSocketStartSend() {}
 
-    m_NotifierRead = std::make_shared<QSocketNotifier>(
-            (QSOCK_T)m_DglClient->getSocketFD(), QSocketNotifier::Read);
-    m_NotifierWrite = std::make_shared<QSocketNotifier>(
-            (QSOCK_T)m_DglClient->getSocketFD(), QSocketNotifier::Write);
+void DglController::onSocketStopSend() {}
 
-#undef QSOCK_T
+bool DglController::onMessage(dglnet::Message* msg) {
+    // called on network thread: message is already deserialized, just pass
+    // it to GUI thread
+    emit networkMessage(msg, m_ConnectionId);
+    return true;
+}
 
-    m_NotifierWrite->setEnabled(false);
-    CONNASSERT(&*m_NotifierRead, SIGNAL(activated(int)), this, SLOT(poll()));
-    CONNASSERT(&*m_NotifierWrite, SIGNAL(activated(int)), this, SLOT(poll()));
+void DglController::handleNetworkMessage(dglnet::Message* msg,
+                                         uint connectionId) {
+    if (m_DglClient && connectionId == m_ConnectionId) {
+        msg->handle(this);
+    }
+    delete msg;
 }
 
-void DglController::onSocketStartSend() { m_NotifierWrite->setEnabled(true); }
+void DglController::handleNetworkDisconnect(const QString& why,
+                                            uint connectionId) {
+    if (m_DglClient && connectionId == m_ConnectionId) {
+        m_DglClientDeadInfo = why.toStdString();
+        m_Disconnected = true;
+        m_Connected = false;
+        disconnectServer();
+        connectionLost(tr("Connection error"), why);
+    }
+}
 
-void DglController::onSocketStopSend() { m_NotifierWrite->setEnabled(false); }
+void DglController::stopNetwork() {
+    if (m_DglClient) {
+        m_DglClient->stop();
+        m_NetworkThread.join();
+        m_DglClient->abort();
+    }
+}
 
 void DglController::disconnectServer() {
     if (m_DglClient) {
-        m_DglClient->abort();
+        stopNetwork();
         m_DglClient.reset();
+        m_ResourceManager.dropPushedResources();
         m_ConfiguredAndBkpointsSet = false;
         setConnected(false);
         setDisconnected(true);
         debugeeInfo("");
     }
     m_Connected = false;
-    m_NotifierRead.reset();
-    m_NotifierWrite.reset();
     newStatus("Disconnected.");
 }
 
 bool DglController::isConnected() { return m_Connected; }
 
-void DglController::poll() {
-    if (m_DglClient) {
-        m_DglClient->poll();
-
-        if (m_Disconnected) {
-            // one of asio handlers requested disconnection
-            disconnectServer();
-            connectionLost(tr("Connection error"), m_DglClientDeadInfo.c_str());
-        }
-    }
-}
-
 void DglController::debugContinue() {
     setBreaked(false);
     setRunning(true);
     DGL_ASSERT(isConnected());
     dglnet::message::ContinueBreak message(false);
-    m_DglClient->sendMessage(&message);
+    m_DglClient->postMessage(&message);
 }
 
 void DglController::debugInterrupt() {
     DGL_ASSERT(isConnected());
     dglnet::message::ContinueBreak message(true);
-    m_DglClient->sendMessage(&message);
+    m_DglClient->postMessage(&message);
     newStatus("Interrupting...");
 }
 
@@ -293,7 +410,7 @@ void DglController::debugStep() {
     DGL_ASSERT(isConnected());
     dglnet::message::ContinueBreak message(
             dglnet::message::StepMode::CALL);
-    m_DglClient->sendMessage(&message);
+    m_DglClient->postMessage(&message);
     newStatus("Running...");
 }
 
@@ -303,7 +420,7 @@ void DglController::debugStepDrawCall() {
     DGL_ASSERT(isConnected());
     dglnet::message::ContinueBreak message(
             dglnet::message::StepMode::DRAW_CALL);
-    m_DglClient->sendMessage(&message);
+    m_DglClient->postMessage(&message);
     newStatus("Running...");
 }
 
@@ -313,14 +430,14 @@ void DglController::debugStepFrame() {
     DGL_ASSERT(isConnected());
     dglnet::message::ContinueBreak message(
             dglnet::message::StepMode::FRAME);
-    m_DglClient->sendMessage(&message);
+    m_DglClient->postMessage(&message);
     newStatus("Running...");
 }
 
 void DglController::debugTerminate() {
     DGL_ASSERT(isConnected());
     dglnet::message::Terminate message;
-    m_DglClient->sendMessage(&message);
+    m_DglClient->postMessage(&message);
     newStatus("Terminating...");
 }
 
@@ -328,7 +445,7 @@ void DglController::onSetStatus(std::string str) { newStatus(str.c_str()); }
 
 void DglController::queryCallTrace(uint startOffset, uint endOffset) {
     dglnet::message::QueryCallTrace message(startOffset, endOffset);
-    m_DglClient->sendMessage(&message);
+    m_DglClient->postMessage(&message);
 }
 
 void DglController::doHandleHello(const dglnet::message::Hello& msg) {
@@ -353,6 +470,9 @@ void DglController::doHandleBreakedCall(
     setBreaked(true);
     setRunning(false);
 
+    // listeners created by views reacting to break may use them already
+    m_ResourceManager.setPushedResources(msg.m_PushedResources);
+
     breaked(msg.m_entryp, msg.m_TraceSize);
     breakedWithStateReports(msg.m_CurrentCtx, msg.m_CtxReports);
 
@@ -377,14 +497,12 @@ void DglController::doHandleConnect() {
 }
 
 void DglController::doHandleDisconnect(const std::string& msg) {
-    m_DglClientDeadInfo = msg;
-    m_Disconnected = true;
-    m_Connected = !m_Disconnected;
+    emit networkDisconnect(QString::fromStdString(msg), m_ConnectionId);
 }
 
 void DglController::sendMessage(dglnet::Message* msg) {
     DGL_ASSERT(isConnected());
-    m_DglClient->sendMessage(msg);
+    m_DglClient->postMessage(msg);
 }
 
 DGLBreakPointController* DglController::getBreakPoints() {
@@ -407,7 +525,7 @@ void DglController::sendConfig(const DGLConfiguration* config) {
     }
     if (isConnected()) {
         dglnet::message::Configuration message(m_Config);
-        m_DglClient->sendMessage(&message);
+        m_DglClient->postMessage(&message);
     }
 }
 
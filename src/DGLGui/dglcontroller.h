@@ -17,19 +17,22 @@
 #define DGLCONTROLLER_H
 
 #include "dglqtgui.h"
-#include <QTimer>
-#include <QSocketNotifier>
 
 #include <DGLNet/client.h>
 #include <DGLNet/protocol/fwd.h>
 #include <DGLNet/protocol/dglconfiguration.h>
 #include <DGLNet/protocol/ctxobjname.h>
 #include <DGLNet/protocol/msgutils.h>
+#include <DGLNet/protocol/message.h>
 #include <DGLNet/protocol/messagehandler.h>
 
 #include <DGLCommon/gl-entrypoints.h>
 #include <DGLCommon/def.h>
 
+#include <thread>
+
+Q_DECLARE_METATYPE(dglnet::Message*)
+
 class DGLRequestManager;
 
 /**
@@ -99,21 +102,66 @@ class DGLResourceListener : public QObject, public DGLRequestHandler {
         const std::string& error) override;
 
    public:
+    /**
+     * Query resource again. Resources pushed with last break are dropped, as
+     * caller may have just changed debugee state (ex. edited a shader).
+     */
     void fire();
     bool isEnabledMarkOutDatedIfNot();
 
+    /**
+     * Set id of state snapshot held by listener owner, so next State query
+     * returns delta against it (0 requests full state).
+     */
+    void setBaseSnapshotId(opaque_id_t snapshotId);
+
+    /**
+     * Get size of resource data last received by listener, 0 if evicted
+     */
+    size_t getDataSize() const;
+
 signals:
     void update(const dglnet::DGLResource&);
     void error(const std::string&);
+
+    /**
+     * Emitted when resource data is evicted by DGLResourceManager to fit
+     * memory budget. Receiver should release all data it holds.
+     */
+    void evicted();
 public slots:
     void setEnabled(bool enabled);
 
+    /**
+     * Mark resource as (not) displayed. Displayed resources are never
+     * evicted; evicted resources are queried again, when displayed.
+     */
+    void setDisplayed(bool displayed);
+
    private:
+    void evict();
+
+    /**
+     * Query resource, unless it was pushed by debugee with last break.
+     */
+    void query();
+
     dglnet::message::ObjectType m_ObjectType;
     dglnet::ContextObjectName m_ObjectName;
+    opaque_id_t m_BaseSnapshotId;
     DGLResourceManager* m_Manager;
     bool m_Enabled;
     bool m_Outdated;
+
+    bool m_Displayed;
+    bool m_Evicted;
+    size_t m_DataSize;
+
+    /**
+     * Value of DGLResourceManager::m_DisplayCounter, when resource was last
+     * displayed
+     */
+    uint64_t m_LastDisplayed;
 };
 
 /**
@@ -135,12 +183,53 @@ class DGLResourceManager {
 
     DGLRequestManager* getRequestManager();
 
+    /**
+     * Set limit of memory used by resource data held by listeners. When
+     * exceeded, data of least recently displayed resources is evicted.
+     */
+    void setMemoryBudget(size_t bytes);
+
+    size_t getMemoryBudget() const;
+
+    /**
+     * Get size of resource data held by all listeners
+     */
+    size_t getMemoryUsage() const;
+
+    static const size_t kDefaultMemoryBudget;
+
+    /**
+     * Set resources pushed by debugee with BreakedCall. They are handed to
+     * listeners instead of querying debugee, until next break.
+     */
+    void setPushedResources(
+            const std::vector<dglnet::message::PushedResource>& resources);
+
+    void dropPushedResources();
+
    private:
     void unregisterListener(DGLResourceListener* listener);
 
+    /**
+     * Get (and forget) pushed resource matching query, NULL if not pushed
+     */
+    std::shared_ptr<dglnet::message::utils::ReplyBase> takePushedResource(
+            dglnet::message::ObjectType type,
+            const dglnet::ContextObjectName& name);
+
+    /**
+     * Evict least recently displayed resources until usage fits budget
+     */
+    void enforceMemoryBudget();
+
     std::list<DGLResourceListener*> m_Listeners;
 
     DGLRequestManager* m_RequestManager;
+
+    size_t m_MemoryBudget;
+    uint64_t m_DisplayCounter;
+
+    std::vector<dglnet::message::PushedResource> m_PushedResources;
 };
 
 /**
@@ -208,6 +297,7 @@ class DglController : public QObject,
 
    public:
     DglController();
+    ~DglController();
 
     /**
      * Start a new network connection to already running debugee
@@ -239,18 +329,21 @@ class DglController : public QObject,
 
     /**
      * Method called by DGLClient, when network socket starts sending data
-     *
-     * We start QSocketNotifier in write mode to handle polls()
      */
     virtual void onSocketStartSend();
 
     /**
      * Method called by DGLClient, when network socket stops sending data
-     *
-     * We stop QSocketNotifier in write mode to stop handling polls()
      */
     virtual void onSocketStopSend();
 
+    /**
+     * Method called by DGLClient on network thread with each decoded message.
+     *
+     * Message is passed to GUI thread with queued networkMessage() signal.
+     */
+    virtual bool onMessage(dglnet::Message*);
+
     // IMessageHandler methods:
     virtual void doHandleHello(const dglnet::message::Hello&) override;
     virtual void doHandleBreakedCall(const dglnet::message::BreakedCall&)
@@ -265,7 +358,10 @@ class DglController : public QObject,
     virtual void doHandleConnect();
 
     /**
-     * Method called by DGLclient, when disconnection condition is detected
+     * Method called by DGLclient, when disconnection condition is detected.
+     *
+     * Called on network thread, passed to GUI thread with queued
+     * networkDisconnect() signal.
      */
     virtual void doHandleDisconnect(const std::string&) override;
 
@@ -339,9 +435,15 @@ signals:
     void newStatus(const QString&);
     void connectionLost(const QString&, const QString&);
 
+    /**
+     * Signals emitted on network thread, connected with queued connection.
+     * Connection id allows to drop messages of already closed connection.
+     */
+    void networkMessage(dglnet::Message*, uint);
+    void networkDisconnect(const QString&, uint);
+
    public
 slots:
-    void poll();
     void debugContinue();
     void debugInterrupt();
     void debugStep();
@@ -350,10 +452,30 @@ slots:
     void debugTerminate();
     void queryCallTrace(uint, uint);
 
+   private
+slots:
+    void handleNetworkMessage(dglnet::Message*, uint);
+    void handleNetworkDisconnect(const QString&, uint);
+
    private:
+    /**
+     * Stop network thread and close connection
+     */
+    void stopNetwork();
+
     std::shared_ptr<dglnet::Client> m_DglClient;
-    std::shared_ptr<QSocketNotifier> m_NotifierRead, m_NotifierWrite;
-    QTimer m_Timer;
+
+    /**
+     * Thread running m_DglClient: reads, decompresses and deserializes
+     * messages, so GUI thread only handles ready message objects.
+     */
+    std::thread m_NetworkThread;
+
+    /**
+     * Incremented with each connection, so messages queued by network thread
+     * of closed connection can be recognized.
+     */
+    uint m_ConnectionId;
 
     /**
      * Set to true, if client is no longer connected (setting to true from asio
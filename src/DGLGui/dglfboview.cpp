@@ -38,6 +38,8 @@ DGLFBOViewItem::DGLFBOViewItem(dglnet::ContextObjectName name,
     m_Listener->setEnabled(parrent->isVisible());
     CONNASSERT(parrent, SIGNAL(visibilityChanged(bool)), m_Listener,
         SLOT(setEnabled(bool)));
+
+    setResourceListener(m_Listener);
 }
 
 void DGLFBOViewItem::error(const std::string& message) {
@@ -48,6 +50,11 @@ void DGLFBOViewItem::error(const std::string& message) {
     m_Ui.m_framebufferStatusLabel->setText("");
 }
 
+void DGLFBOViewItem::releaseResource() {
+    m_Attachments.clear();
+    error("");
+}
+
 void DGLFBOViewItem::update(const dglnet::DGLResource& res) {
 
     const dglnet::resource::DGLResourceFBO* resource =
@@ -83,7 +90,7 @@ void DGLFBOViewItem::showAttachment(int id) {
 
         if (rectangle) {
             m_PixelRectangleScene->setPixelRectangle(
-                *rectangle);
+                m_Attachments[id].m_PixelRectangle);
         }
        
         m_Ui.m_pixelRectangleView->updateFormatSizeInfo(
@@ -33,6 +33,8 @@ slots:
     void showAttachment(int id);
 
    private:
+    virtual void releaseResource() override;
+
     Ui_DGLFBOViewItem m_Ui;
     DGLPixelRectangleScene* m_PixelRectangleScene;
     std::vector<dglnet::resource::DGLResourceFBO::FBOAttachment> m_Attachments;
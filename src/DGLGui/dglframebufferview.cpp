@@ -35,6 +35,8 @@ DGLFramebufferViewItem::DGLFramebufferViewItem(dglnet::ContextObjectName name,
     m_Listener->setEnabled(parrent->isVisible());
     CONNASSERT(parrent, SIGNAL(visibilityChanged(bool)), m_Listener,
         SLOT(setEnabled(bool)));
+
+    setResourceListener(m_Listener);
 }
 
 void DGLFramebufferViewItem::error(const std::string& message) {
@@ -42,11 +44,16 @@ void DGLFramebufferViewItem::error(const std::string& message) {
     m_Ui.m_PixelRectangleView->updateFormatSizeInfo(NULL, 0, 0);
 }
 
+void DGLFramebufferViewItem::releaseResource() {
+    m_PixelRectangle.reset();
+    error("");
+}
+
 void DGLFramebufferViewItem::update(const dglnet::DGLResource& res) {
     const dglnet::resource::DGLResourceFramebuffer* resource =
             dynamic_cast<const dglnet::resource::DGLResourceFramebuffer*>(&res);
     m_PixelRectangle = resource->m_PixelRectangle;
-    m_PixelRectangleScene->setPixelRectangle(*m_PixelRectangle);
+    m_PixelRectangleScene->setPixelRectangle(m_PixelRectangle);
     m_Ui.m_PixelRectangleView->updateFormatSizeInfo(m_PixelRectangle.get(), 0, 0);
 }
 
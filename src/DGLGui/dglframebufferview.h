@@ -48,6 +48,8 @@ slots:
     void update(const dglnet::DGLResource& res);
 
    private:
+    virtual void releaseResource() override;
+
     Ui::DGLFramebufferViewItem m_Ui;
     DGLPixelRectangleScene* m_PixelRectangleScene;
     DGLResourceListener* m_Listener;
@@ -52,6 +52,7 @@
 #define DGL_GEOMETRY_SETTINGS DGL_SETTINGS(geometry)
 #define DGL_WINDOW_STATE_SETTINGS DGL_SETTINGS(windowState)
 #define DGL_ColorScheme_SETTINGS DGL_SETTINGS(colorScheme)
+#define DGL_RESOURCE_MEMORY_BUDGET_SETTINGS DGL_SETTINGS(resourceMemoryBudgetMB)
 #define DGL_ADB_PATH_SETTINGS STRINGIFY(adbPath)
 
 /**
@@ -127,6 +128,11 @@ void DGLMainWindow::closeEvent(QCloseEvent *_event) {
     settings.setValue(DGL_GEOMETRY_SETTINGS, saveGeometry());
     settings.setValue(DGL_WINDOW_STATE_SETTINGS, saveState());
     settings.setValue(DGL_ColorScheme_SETTINGS, m_ColorScheme);
+    settings.setValue(
+            DGL_RESOURCE_MEMORY_BUDGET_SETTINGS,
+            static_cast<uint>(
+                    m_controller.getResourceManager()->getMemoryBudget() >>
+                    20));
     settings.setValue(
             DGL_ADB_PATH_SETTINGS,
             QString::fromStdString(DGLAdbInterface::get()->getAdbPath())
@@ -556,6 +562,14 @@ void DGLMainWindow::readSettings() {
 
     uint ColorScheme = settings.value(DGL_ColorScheme_SETTINGS).toUInt();
     setColorScheme(ColorScheme);
+
+    // memory budget of resources downloaded to views, in megabytes
+    size_t memoryBudgetMB =
+            settings.value(DGL_RESOURCE_MEMORY_BUDGET_SETTINGS,
+                           static_cast<uint>(
+                                   DGLResourceManager::kDefaultMemoryBudget >>
+                                   20)).toUInt();
+    m_controller.getResourceManager()->setMemoryBudget(memoryBudgetMB << 20);
 }
 
 void DGLMainWindow::setColorScheme(int colorScheme) {
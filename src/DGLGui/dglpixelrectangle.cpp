@@ -14,7 +14,6 @@
 */
 
 #include "dglpixelrectangle.h"
-#include "dglblitterbase.h"
 #include <DGLNet/protocol/resource.h>
 
 #include <QGraphicsView>
@@ -26,7 +25,13 @@
 #include <QGraphicsPixmapItem>
 #pragma warning(pop)
 
+#include <QCache>
+#include <QPainter>
 #include <QResizeEvent>
+#include <QStyleOptionGraphicsItem>
+
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 
 #include <DGLCommon/def.h>
@@ -56,39 +61,249 @@ void DGLPixRectQGraphicsView::leaveEvent(QEvent* /*_event*/) {
     emit onMouseLeft();
 }
 
-class DGLPixelRectangleBlitter : public DGLBlitterBase {
+DGLPixelRectangleBlitter::DGLPixelRectangleBlitter() : m_ReadyGeneration(0) {}
+
+DGLPixelRectangleBlitter::~DGLPixelRectangleBlitter() { cancel(); }
+
+void DGLPixelRectangleBlitter::reset() {
+    DGLBlitterBase::reset();
+    {
+        std::lock_guard<std::mutex> lock(m_ReadyMutex);
+        m_ReadyImage = QImage();
+        m_ReadyImageData.reset();
+    }
+    m_ImageData.reset();
+}
+
+void DGLPixelRectangleBlitter::sink(
+        int width, int height, OutputFormat format,
+        const std::shared_ptr<std::vector<char> >& data,
+        unsigned int generation) {
+    QImage::Format qtFormat;
+    switch (format) {
+        case _GL_BGRA32:
+            qtFormat = QImage::Format_ARGB32;
+            break;
+        case _GL_RGBX32:
+            qtFormat = QImage::Format_RGB888;
+            break;
+        case _GL_MONO8:
+            qtFormat = QImage::Format_Indexed8;
+            break;
+        case _LAST:
+        default:
+            DGL_ASSERT(0);
+            return;
+    }
+
+    // image only references data, so data is passed along with it
+    QImage image(data->empty() ? NULL : reinterpret_cast<uchar*>(&(*data)[0]),
+                 width, height, qtFormat);
+    if (format == _GL_MONO8) {
+        for (int i = 0; i < 256; ++i) {
+            image.setColor(i, qRgb(i, i, i));
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_ReadyMutex);
+        m_ReadyImage = image;
+        m_ReadyImageData = data;
+        m_ReadyGeneration = generation;
+    }
+
+    QMetaObject::invokeMethod(this, "onImageReady", Qt::QueuedConnection);
+}
+
+void DGLPixelRectangleBlitter::onImageReady() {
+    QImage image;
+    std::shared_ptr<std::vector<char> > imageData;
+    unsigned int generation;
+    {
+        std::lock_guard<std::mutex> lock(m_ReadyMutex);
+        if (!m_ReadyImageData) {
+            // already received with previous notification
+            return;
+        }
+        image = m_ReadyImage;
+        imageData = m_ReadyImageData;
+        generation = m_ReadyGeneration;
+        m_ReadyImage = QImage();
+        m_ReadyImageData.reset();
+    }
+
+    // blit may be obsoleted after sink, but before this notification
+    if (generation != getGeneration()) {
+        return;
+    }
+
+    // keep storage of previous image until receivers drop it
+    std::shared_ptr<std::vector<char> > previousImageData = m_ImageData;
+    m_ImageData = imageData;
+
+    emit blittedImage(image);
+}
+
+/**
+ * Graphics item displaying converted image as a tiled pyramid.
+ *
+ * Level 0 is the image itself, each next level is box-filtered 2x smaller.
+ * Tiles are built lazily, on first paint needing them, from tiles of level
+ * below, and kept in a cache bounded by memory size. Only tiles exposed at
+ * level matching current zoom are painted.
+ */
+class DGLPixelRectangleItem : public QGraphicsItem {
    public:
-    DGLPixelRectangleBlitter(DGLPixelRectangleScene* scene) : m_Scene(scene) {}
+    DGLPixelRectangleItem() : m_Levels(1) {
+        m_Tiles.setMaxCost(kTileCacheKB);
+        setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+    }
+
+    /**
+     * Set new base image. Drops all tiles built so far.
+     */
+    void setImage(const QImage& image) {
+        if (image.size() != m_Image.size()) {
+            prepareGeometryChange();
+        }
+        m_Image = image;
+        m_Tiles.clear();
+
+        m_Levels = 1;
+        while (std::max(m_Image.width(), m_Image.height()) >>
+                       (m_Levels - 1) >
+               kTileSize) {
+            m_Levels++;
+        }
+        update();
+    }
+
+    QRectF boundingRect() const {
+        return QRectF(0, 0, m_Image.width(), m_Image.height());
+    }
+
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
+               QWidget* /*widget*/) {
+        if (m_Image.isNull()) {
+            return;
+        }
+
+        // pick smallest level, that is still not magnified
+        qreal lod =
+                option->levelOfDetailFromTransform(painter->worldTransform());
+        int level = 0;
+        while (level + 1 < m_Levels && lod * (1 << (level + 1)) <= 1.0) {
+            level++;
+        }
+
+        QRectF exposed = option->exposedRect.intersected(boundingRect());
+        int tileBaseSize = kTileSize << level;
+        int tx0 = static_cast<int>(exposed.left()) / tileBaseSize;
+        int ty0 = static_cast<int>(exposed.top()) / tileBaseSize;
+        int tx1 = static_cast<int>(std::ceil(exposed.right())) / tileBaseSize;
+        int ty1 = static_cast<int>(std::ceil(exposed.bottom())) / tileBaseSize;
+        tx1 = std::min(tx1, getTileCount(m_Image.width(), level) - 1);
+        ty1 = std::min(ty1, getTileCount(m_Image.height(), level) - 1);
+
+        for (int ty = ty0; ty <= ty1; ty++) {
+            for (int tx = tx0; tx <= tx1; tx++) {
+                QImage tile = getTile(level, tx, ty);
+
+                // last tiles of level may exceed base image by one texel
+                QRectF target = QRectF(tx * tileBaseSize, ty * tileBaseSize,
+                                       tile.width() << level,
+                                       tile.height() << level)
+                                        .intersected(boundingRect());
+                QRectF source(0, 0, target.width() / (1 << level),
+                              target.height() / (1 << level));
+                painter->drawImage(target, tile, source);
+            }
+        }
+    }
 
    private:
-    void sink(int width, int height, OutputFormat format, void* data) {
-        QImage::Format qtFormat;
-        switch (format) {
-            case _GL_BGRA32:
-                qtFormat = QImage::Format_ARGB32;
-                break;
-            case _GL_RGBX32:
-                qtFormat = QImage::Format_RGB888;
-                break;
-            case _GL_MONO8:
-                qtFormat = QImage::Format_Indexed8;
-                break;
-            case _LAST:
-            default:
-                DGL_ASSERT(0);
-                return;
+    /**
+     * Tile size, in texels of its level
+     */
+    static const int kTileSize = 256;
+
+    /**
+     * Memory limit of tile cache
+     */
+    static const int kTileCacheKB = 128 * 1024;
+
+    static int getLevelSize(int baseSize, int level) {
+        return std::max(1, (baseSize + (1 << level) - 1) >> level);
+    }
+
+    static int getTileCount(int baseSize, int level) {
+        return (getLevelSize(baseSize, level) + kTileSize - 1) / kTileSize;
+    }
+
+    QImage getTile(int level, int tx, int ty) {
+        quint64 key = (static_cast<quint64>(level) << 48) |
+                      (static_cast<quint64>(ty) << 24) |
+                      static_cast<quint64>(tx);
+        if (QImage* cached = m_Tiles.object(key)) {
+            return *cached;
         }
-        m_Image = QImage(static_cast<uchar*>(data), width, height, qtFormat);
-        if (format == _GL_MONO8) {
-            for (int i = 0; i < 256; ++i) {
-                m_Image.setColor(i, qRgb(i, i, i));
+
+        QRect rect(tx * kTileSize, ty * kTileSize, kTileSize, kTileSize);
+        rect &= QRect(0, 0, getLevelSize(m_Image.width(), level),
+                      getLevelSize(m_Image.height(), level));
+
+        QImage tile;
+        if (level == 0) {
+            tile = m_Image.copy(rect).convertToFormat(
+                    QImage::Format_ARGB32_Premultiplied);
+        } else {
+            tile = QImage(rect.size(), QImage::Format_ARGB32_Premultiplied);
+            for (int j = 0; j < 2; j++) {
+                for (int i = 0; i < 2; i++) {
+                    int childX = 2 * tx + i, childY = 2 * ty + j;
+                    if (childX < getTileCount(m_Image.width(), level - 1) &&
+                        childY < getTileCount(m_Image.height(), level - 1)) {
+                        downsample(getTile(level - 1, childX, childY), tile,
+                                   i * kTileSize / 2, j * kTileSize / 2);
+                    }
+                }
+            }
+        }
+
+        m_Tiles.insert(key, new QImage(tile),
+                       std::max(1, tile.byteCount() / 1024));
+        return tile;
+    }
+
+    /**
+     * Box-filter source 2x into destination, at given offset. Odd edge
+     * texels are replicated.
+     */
+    static void downsample(const QImage& src, QImage& dst, int dstX,
+                           int dstY) {
+        for (int y = 0; y < (src.height() + 1) / 2; y++) {
+            const QRgb* row0 =
+                    reinterpret_cast<const QRgb*>(src.constScanLine(2 * y));
+            const QRgb* row1 = reinterpret_cast<const QRgb*>(
+                    src.constScanLine(std::min(2 * y + 1, src.height() - 1)));
+            QRgb* out = reinterpret_cast<QRgb*>(dst.scanLine(dstY + y)) + dstX;
+            for (int x = 0; x < (src.width() + 1) / 2; x++) {
+                int x0 = 2 * x, x1 = std::min(2 * x + 1, src.width() - 1);
+                QRgb p[4] = {row0[x0], row0[x1], row1[x0], row1[x1]};
+                out[x] = qRgba(average(qRed, p), average(qGreen, p),
+                               average(qBlue, p), average(qAlpha, p));
             }
         }
+    }
 
-        m_Scene->blittedImage(m_Image);
+    static int average(int (*channel)(QRgb), const QRgb* p) {
+        return (channel(p[0]) + channel(p[1]) + channel(p[2]) + channel(p[3]) +
+                2) / 4;
     }
-    DGLPixelRectangleScene* m_Scene;
+
     QImage m_Image;
+    int m_Levels;
+    QCache<quint64, QImage> m_Tiles;
 };
 
 DGLPixelRectangleView::DGLPixelRectangleView(QWidget* _parent)
@@ -207,27 +422,35 @@ void DGLPixelRectangleView::updateFormatSizeInfo(
 
 DGLPixelRectangleScene::DGLPixelRectangleScene()
         : m_Item(NULL),
-          m_Blitter(std::make_shared<DGLPixelRectangleBlitter>(this)) {}
+          m_Blitter(std::make_shared<DGLPixelRectangleBlitter>()) {
+    CONNASSERT(m_Blitter.get(), SIGNAL(blittedImage(const QImage&)), this,
+               SLOT(blittedImage(const QImage&)));
+}
 
 void DGLPixelRectangleScene::setText(const std::string& message) {
+    // drop image being blitted, so it does not replace message. Image is no
+    // longer displayed, so release all pixel data.
     m_Item = NULL;
     m_Scene.clear();
+    m_Image = QImage();
+    m_Blitter->reset();
     m_Scene.addText(message.c_str());
 }
 
 void DGLPixelRectangleScene::setPixelRectangle(
-        const dglnet::resource::DGLPixelRectangle& pixelRectangle) {
+        const std::shared_ptr<const dglnet::resource::DGLPixelRectangle>&
+                pixelRectangle) {
 
-    m_Item = NULL;
-
-    if (!pixelRectangle.getPtr()) {
+    if (!pixelRectangle || !pixelRectangle->getPtr()) {
         setText("No pixels");
         return;
     }
 
-    m_Blitter->blit(pixelRectangle.m_Width, pixelRectangle.m_Height,
-                    pixelRectangle.m_RowBytes, pixelRectangle.m_GLFormat,
-                    pixelRectangle.m_GLType, pixelRectangle.getPtr());
+    // blit is asynchronous: previous image is displayed until it is done.
+    m_Blitter->blit(pixelRectangle->m_Width, pixelRectangle->m_Height,
+                    pixelRectangle->m_RowBytes, pixelRectangle->m_GLFormat,
+                    pixelRectangle->m_GLType, pixelRectangle->getPtr(),
+                    pixelRectangle);
 }
 
 QPoint DGLPixelRectangleScene::translate(const QPoint& pos) {
@@ -244,9 +467,13 @@ std::pair<QColor, std::vector<AnyValue> > DGLPixelRectangleScene::getColor(
 }
 
 void DGLPixelRectangleScene::blittedImage(const QImage& image) {
-    m_Scene.clear();
+    if (!m_Item) {
+        m_Scene.clear();
+        m_Item = new DGLPixelRectangleItem();
+        m_Scene.addItem(m_Item);
+    }
     m_Image = image;
-    m_Item = m_Scene.addPixmap(QPixmap::fromImage(image));
+    m_Item->setImage(image);
     doRecalcSizes();
 }
 
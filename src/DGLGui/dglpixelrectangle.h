@@ -21,9 +21,12 @@
 #include <QGraphicsView>
 
 #include "ui_dglpixelrectangleview.h"
+#include "dglblitterbase.h"
 
 #include <DGLNet/protocol/resource.h>
 
+#include <mutex>
+
 class DGLPixRectQGraphicsView : public QGraphicsView {
     Q_OBJECT
    public:
@@ -65,7 +68,51 @@ slots:
     DGLPixelRectangleScene* m_Scene;
 };
 
-class DGLPixelRectangleBlitter;
+/**
+ * Blitter of pixel rectangle scene.
+ *
+ * Images converted on blitter threads are passed to the thread owning this
+ * object and emitted with blittedImage(), unless obsoleted meanwhile.
+ */
+class DGLPixelRectangleBlitter : public QObject, public DGLBlitterBase {
+    Q_OBJECT
+   public:
+    DGLPixelRectangleBlitter();
+    ~DGLPixelRectangleBlitter();
+
+    /**
+     * Drop source data and storage of last emitted image. Receivers must have
+     * dropped the image already.
+     */
+    void reset();
+
+signals:
+    void blittedImage(const QImage& image);
+
+   private
+slots:
+    void onImageReady();
+
+   private:
+    void sink(int width, int height, OutputFormat format,
+              const std::shared_ptr<std::vector<char> >& data,
+              unsigned int generation);
+
+    /**
+     * Image sunk on blitter thread, not yet received by onImageReady()
+     */
+    std::mutex m_ReadyMutex;
+    QImage m_ReadyImage;
+    std::shared_ptr<std::vector<char> > m_ReadyImageData;
+    unsigned int m_ReadyGeneration;
+
+    /**
+     * Storage of last emitted image
+     */
+    std::shared_ptr<std::vector<char> > m_ImageData;
+};
+
+class DGLPixelRectangleItem;
 
 class DGLPixelRectangleScene : public QObject {
     Q_OBJECT
@@ -74,7 +121,8 @@ class DGLPixelRectangleScene : public QObject {
 
     void setText(const std::string& message);
     void setPixelRectangle(
-            const dglnet::resource::DGLPixelRectangle& pixelRectangle);
+            const std::shared_ptr<const dglnet::resource::DGLPixelRectangle>&
+                    pixelRectangle);
 
     QPoint translate(const QPoint&);
     bool inside(const QPoint&);
@@ -88,19 +136,19 @@ class DGLPixelRectangleScene : public QObject {
 slots:
     void resize(const QSize&);
 
+   private
+slots:
+    void blittedImage(const QImage& image);
+
    private:
     void doRecalcSizes();
     QGraphicsScene m_Scene;
-    QGraphicsPixmapItem* m_Item;
+    DGLPixelRectangleItem* m_Item;
     QImage m_Image;
     float m_Scale;
     QPoint m_Pos;
 
-    void blittedImage(const QImage& image);
-
     std::shared_ptr<DGLPixelRectangleBlitter> m_Blitter;
-
-    friend class DGLPixelRectangleBlitter;
 };
 
 #endif
@@ -36,6 +36,8 @@ DGLRenderbufferViewItem::DGLRenderbufferViewItem(dglnet::ContextObjectName name,
     m_Listener->setEnabled(parrent->isVisible());
     CONNASSERT(parrent, SIGNAL(visibilityChanged(bool)), m_Listener,
         SLOT(setEnabled(bool)));
+
+    setResourceListener(m_Listener);
 }
 
 void DGLRenderbufferViewItem::error(const std::string& message) {
@@ -43,6 +45,11 @@ void DGLRenderbufferViewItem::error(const std::string& message) {
     m_Ui.m_pixelRectangleView->updateFormatSizeInfo(NULL, 0, 0);
 }
 
+void DGLRenderbufferViewItem::releaseResource() {
+    m_PixelRectangle.reset();
+    error("");
+}
+
 void DGLRenderbufferViewItem::update(const dglnet::DGLResource& res) {
 
     const dglnet::resource::DGLResourceRenderbuffer* resource =
@@ -52,8 +59,7 @@ void DGLRenderbufferViewItem::update(const dglnet::DGLResource& res) {
     m_PixelRectangle = resource->m_PixelRectangle;
 
     if (m_PixelRectangle) {
-        m_PixelRectangleScene->setPixelRectangle(
-            *m_PixelRectangle.get());
+        m_PixelRectangleScene->setPixelRectangle(m_PixelRectangle);
 
         m_Ui.m_pixelRectangleView->updateFormatSizeInfo(
             m_PixelRectangle.get(),
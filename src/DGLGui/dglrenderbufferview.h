@@ -32,6 +32,8 @@ slots:
     void update(const dglnet::DGLResource&);
 
    private:
+    virtual void releaseResource() override;
+
     Ui_DGLRenderbufferViewItem m_Ui;
     DGLPixelRectangleScene* m_PixelRectangleScene;
 
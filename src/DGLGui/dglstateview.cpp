@@ -15,8 +15,6 @@
 
 #include "dglstateview.h"
 
-#include <DGLNet/protocol/resource.h>
-
 #include <set>
 #include <climits>
 #include <iomanip>
@@ -26,7 +24,8 @@ DGLStateView::DGLStateView(QWidget* parrent, DglController* controller)
         : QDockWidget(tr("OpenGL State"), parrent),
           m_Listener(NULL),
           m_Controller(controller),
-          m_Ui(NULL) {
+          m_Ui(NULL),
+          m_SnapshotId(0) {
     setObjectName("DGLStateView");
 
     setConnected(false);
@@ -40,35 +39,72 @@ void DGLStateView::update(const dglnet::DGLResource& res) {
     const dglnet::resource::DGLResourceState* resource =
             dynamic_cast<const dglnet::resource::DGLResourceState*>(&res);
 
-    bool initializeRows = !(m_Ui->tableWidget->rowCount());
+    std::vector<size_t> changedRows;
+    try {
+        changedRows = resource->apply(m_SnapshotId, m_Items);
+    } catch (const std::runtime_error&) {
+        // delta against snapshot we do not have: request full state
+        resetSnapshot();
+        m_Listener->fire();
+        return;
+    }
+    m_SnapshotId = resource->m_SnapshotId;
+    m_Listener->setBaseSnapshotId(m_SnapshotId);
+
+    bool initializeRows =
+            m_Ui->tableWidget->rowCount() != static_cast<int>(m_Items.size());
 
     if (initializeRows) {
-        m_Ui->tableWidget->setRowCount(static_cast<int>(resource->m_Items.size()));
+        m_Ui->tableWidget->setRowCount(static_cast<int>(m_Items.size()));
 
-        for (size_t i = 0; i < resource->m_Items.size(); i++) {
+        for (size_t i = 0; i < m_Items.size(); i++) {
             QTableWidgetItem* item =
-                    new QTableWidgetItem(resource->m_Items[i].m_Name.c_str());
+                    new QTableWidgetItem(m_Items[i].m_Name.c_str());
             item->setFlags(Qt::ItemIsEnabled);
             m_Ui->tableWidget->setItem(static_cast<int>(i), 0, item);
+            setValue(i, false);
+        }
+    } else {
+        // only rows touched by previous or current update need refresh
+        for (size_t i = 0; i < m_ChangedRows.size(); i++) {
+            setValue(m_ChangedRows[i], false);
+        }
+        for (size_t i = 0; i < changedRows.size(); i++) {
+            setValue(changedRows[i], true);
         }
     }
+    m_ChangedRows.swap(changedRows);
+}
 
-    for (size_t i = 0; i < resource->m_Items.size(); i++) {
-        std::ostringstream valStream;
-        valStream << std::showpoint;
-        for (size_t j = 0; j < resource->m_Items[i].m_Values.size(); j++) {
-            if (j) valStream << ", ";
-            resource->m_Items[i].m_Values[j].writeToSS(valStream, GLParamTypeMetadata());
-            valStream << " ";
-        }
-        QTableWidgetItem* item = new QTableWidgetItem(valStream.str().c_str());
-        item->setFlags(Qt::ItemIsEnabled);
-        m_Ui->tableWidget->setItem(static_cast<int>(i), 1, item);
+void DGLStateView::setValue(size_t row, bool highlight) {
+    const dglnet::resource::utils::StateItem& stateItem = m_Items[row];
+    std::ostringstream valStream;
+    valStream << std::showpoint;
+    for (size_t j = 0; j < stateItem.m_Values.size(); j++) {
+        if (j) valStream << ", ";
+        stateItem.m_Values[j].writeToSS(valStream, GLParamTypeMetadata());
+        valStream << " ";
+    }
+    QTableWidgetItem* item = new QTableWidgetItem(valStream.str().c_str());
+    item->setFlags(Qt::ItemIsEnabled);
+    if (highlight) {
+        item->setBackground(QColor(255, 240, 150));
+    }
+    m_Ui->tableWidget->setItem(static_cast<int>(row), 1, item);
+}
+
+void DGLStateView::resetSnapshot() {
+    m_Items.clear();
+    m_ChangedRows.clear();
+    m_SnapshotId = 0;
+    if (m_Listener) {
+        m_Listener->setBaseSnapshotId(0);
     }
 }
 
 void DGLStateView::error(const std::string& /*message*/) {
     m_Ui->tableWidget->setRowCount(0);
+    resetSnapshot();
 }
 
 void DGLStateView::setConnected(bool connected) {
@@ -77,7 +113,9 @@ void DGLStateView::setConnected(bool connected) {
             delete m_Ui->frame;
             delete m_Ui;
             m_Ui = NULL;
+            m_Listener = NULL;
         }
+        resetSnapshot();
     } else {
         m_Ui = new Ui::DGLStateView();
         m_Ui->setupUi(this);
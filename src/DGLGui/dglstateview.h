@@ -19,6 +19,8 @@
 #include "dglcontroller.h"
 #include "ui_dglstateview.h"
 
+#include <DGLNet/protocol/resource.h>
+
 #include <QDockWidget>
 
 class DGLStateView : public QDockWidget {
@@ -34,9 +36,30 @@ slots:
     void error(const std::string&);
 
    private:
+    /**
+     * Forget held snapshot, so next query returns full state
+     */
+    void resetSnapshot();
+
+    /**
+     * Set value column of given row
+     */
+    void setValue(size_t row, bool highlight);
+
     DGLResourceListener* m_Listener;
     DglController* m_Controller;
     Ui::DGLStateView* m_Ui;
+
+    /**
+     * Current state snapshot, deltas are applied on it
+     */
+    std::vector<dglnet::resource::utils::StateItem> m_Items;
+    opaque_id_t m_SnapshotId;
+
+    /**
+     * Rows highlighted as changed by last update
+     */
+    std::vector<size_t> m_ChangedRows;
 };
 
 #endif    // DGLTREEVIEW_H
\ No newline at end of file
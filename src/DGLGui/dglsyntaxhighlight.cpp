@@ -18,9 +18,12 @@
 
 #include <QFile>
 #include <QDomDocument>
-#include <QRegExp>
+#include <QHash>
+#include <QSet>
 #include <QDebug>
 
+#include <algorithm>
+
 #ifndef NDEBUG
 //#define HL_DEBUG
 #endif
@@ -141,17 +144,118 @@ class DGLHLActionSetContext : public DGLHLActionBase {
     const DGLHLContext* m_context;
 };
 
+/**
+ * Line of text being highlighted.
+ *
+ * Rules are matched against rest of line, starting at m_From, so m_From is
+ * treated as start of string (as it is for word boundaries).
+ */
+class DGLHLLine {
+   public:
+    DGLHLLine(const QString& text)
+            : m_Str(text.utf16()), m_Length(text.length()), m_From(0) {}
+
+    ushort at(int i) const { return (i < m_Length) ? m_Str[i] : 0; }
+
+    static bool isWordChar(ushort c) {
+        if (c < 128) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                   (c >= '0' && c <= '9') || c == '_';
+        }
+        return QChar(c).isLetterOrNumber();
+    }
+
+    bool isWordBoundary(int i) const {
+        bool before = i > m_From && isWordChar(m_Str[i - 1]);
+        bool after = i < m_Length && isWordChar(m_Str[i]);
+        return before != after;
+    }
+
+    /**
+     * Get length of run of decimal digits at i
+     */
+    int matchDigits(int i) const {
+        int end = i;
+        while (at(end) >= '0' && at(end) <= '9') {
+            end++;
+        }
+        return end - i;
+    }
+
+    /**
+     * Get length of decimal number at i: (0|[1-9][0-9]*)
+     */
+    int matchDecimal(int i) const {
+        if (at(i) == '0') {
+            return 1;
+        }
+        if (at(i) >= '1' && at(i) <= '9') {
+            return matchDigits(i);
+        }
+        return 0;
+    }
+
+    /**
+     * Get length of optional sign at i: [+-]?
+     */
+    int matchSign(int i) const {
+        return (at(i) == '+' || at(i) == '-') ? 1 : 0;
+    }
+
+    /**
+     * Get length of float exponent at i: [Ee][+-]?[0-9]+
+     */
+    int matchExponent(int i) const {
+        if (at(i) != 'e' && at(i) != 'E') {
+            return 0;
+        }
+        int digits = matchDigits(i + 1 + matchSign(i + 1));
+        return digits ? 1 + matchSign(i + 1) + digits : 0;
+    }
+
+    const ushort* m_Str;
+    int m_Length;
+    int m_From;
+};
+
+/**
+ * Size of rule dispatch table: ASCII characters and one entry for all other
+ * characters.
+ */
+static const int kHLStartTableSize = 129;
+
+static int getHLStartTableIdx(ushort c) {
+    return (c < kHLStartTableSize - 1) ? c : kHLStartTableSize - 1;
+}
+
 class DGLHLRuleBase {
    public:
+    typedef std::vector<QString> keywordList_t;
+
     virtual ~DGLHLRuleBase() {}
 
-    virtual void tryMatch(const QString& str, uint& pos, int& matchSize) = 0;
+    /**
+     * Get size of rule match starting at pos, 0 if rule does not match
+     * there.
+     */
+    virtual int matchAt(const DGLHLLine& line, int pos) const = 0;
+
+    /**
+     * Mark entries of dispatch table for characters, that rule match can
+     * start with.
+     */
+    virtual void getStartChars(std::vector<bool>& table) const = 0;
 
-    const DGLHLTextCharFormat* getFormat() {
+    /**
+     * Get list of keywords, if rule matches keywords
+     */
+    virtual const keywordList_t* getKeywords() const { return NULL; }
+
+    const DGLHLTextCharFormat* getFormat() const {
         DGL_ASSERT(m_format);
         return m_format;
     }
-    const DGLHLActionBase* getAction() {
+    const DGLHLActionBase* getAction() const {
         DGL_ASSERT(m_action.get());
         return m_action.get();
     }
@@ -169,6 +273,12 @@ class DGLHLRuleBase {
 #endif
                   );
 
+    static void setNumberStartChars(std::vector<bool>& table) {
+        for (const char* c = "0123456789+-"; *c; c++) {
+            table[getHLStartTableIdx(*c)] = true;
+        }
+    }
+
    private:
     std::shared_ptr<DGLHLActionBase> m_action;
     const DGLHLTextCharFormat* m_format;
@@ -189,9 +299,11 @@ class DGLHLRuleDetectChar : public DGLHLRuleBase {
     virtual ~DGLHLRuleDetectChar() {}
 
    private:
-    virtual void tryMatch(const QString& str, uint& pos, int& matchSize) {
-        matchSize = 1;
-        pos = str.indexOf(m_char);
+    virtual int matchAt(const DGLHLLine& line, int pos) const {
+        return (line.at(pos) == static_cast<uchar>(m_char)) ? 1 : 0;
+    }
+    virtual void getStartChars(std::vector<bool>& table) const {
+        table[getHLStartTableIdx(static_cast<uchar>(m_char))] = true;
     }
     char m_char;
 };
@@ -206,19 +318,23 @@ class DGLHLRuleDetect2Chars : public DGLHLRuleBase {
                             QString(__FUNCTION__) + ":" + char1 + "," + char2
 #endif
                             ),
-              m_regex(QRegExp::escape(QString(char1) + QString(char2))) {
+              m_char1(char1),
+              m_char2(char2) {
     }
 
-    typedef std::vector<std::string> keywordList_t;
-
     virtual ~DGLHLRuleDetect2Chars() {}
 
    private:
-    virtual void tryMatch(const QString& str, uint& pos, int& matchSize) {
-        pos = (uint)m_regex.indexIn(str);
-        matchSize = m_regex.matchedLength();
+    virtual int matchAt(const DGLHLLine& line, int pos) const {
+        return (line.at(pos) == static_cast<uchar>(m_char1) &&
+                line.at(pos + 1) == static_cast<uchar>(m_char2))
+                       ? 2
+                       : 0;
+    }
+    virtual void getStartChars(std::vector<bool>& table) const {
+        table[getHLStartTableIdx(static_cast<uchar>(m_char1))] = true;
     }
-    QRegExp m_regex;
+    char m_char1, m_char2;
 };
 
 class DGLHLRuleKeyword : public DGLHLRuleBase {
@@ -226,16 +342,33 @@ class DGLHLRuleKeyword : public DGLHLRuleBase {
     DGLHLRuleKeyword(const DGLHLData* data, std::string _string,
                      QString formatName, QString actionName);
 
-    typedef std::vector<QString> keywordList_t;
-
    private:
-    virtual void tryMatch(const QString& str, uint& pos, int& matchSize) {
-        pos = (uint)m_regex.indexIn(str);
-        matchSize = m_regex.matchedLength();
+    virtual int matchAt(const DGLHLLine& line, int pos) const {
+        // whole words only: \bkeyword\b
+        if (!line.isWordBoundary(pos)) {
+            return 0;
+        }
+        int end = pos;
+        while (end < line.m_Length && DGLHLLine::isWordChar(line.m_Str[end])) {
+            end++;
+        }
+        QString word = QString::fromRawData(
+                reinterpret_cast<const QChar*>(line.m_Str + pos), end - pos);
+        return m_Set.contains(word) ? end - pos : 0;
     }
-    QRegExp m_regex;
-};
+    virtual void getStartChars(std::vector<bool>& table) const {
+        for (size_t i = 0; i < m_List->size(); i++) {
+            if ((*m_List)[i].length()) {
+                table[getHLStartTableIdx((*m_List)[i][0].unicode())] = true;
+            }
+        }
+    }
+    virtual const keywordList_t* getKeywords() const { return m_List; }
 
+    const keywordList_t* m_List;
+    QSet<QString> m_Set;
+};
+
 class DGLHLRuleInt : public DGLHLRuleBase {
    public:
     DGLHLRuleInt(const DGLHLData* data, QString formatName, QString actionName)
@@ -244,16 +377,22 @@ class DGLHLRuleInt : public DGLHLRuleBase {
                             ,
                             QString(__FUNCTION__)
 #endif
-                            ),
-              m_regex("\\b[+-]?(0|[1-9][0-9]*)") {
+                            ) {
     }
 
    private:
-    virtual void tryMatch(const QString& str, uint& pos, int& matchSize) {
-        pos = (uint)m_regex.indexIn(str);
-        matchSize = m_regex.matchedLength();
+    // \b[+-]?(0|[1-9][0-9]*)
+    virtual int matchAt(const DGLHLLine& line, int pos) const {
+        if (!line.isWordBoundary(pos)) {
+            return 0;
+        }
+        int sign = line.matchSign(pos);
+        int number = line.matchDecimal(pos + sign);
+        return number ? sign + number : 0;
+    }
+    virtual void getStartChars(std::vector<bool>& table) const {
+        setNumberStartChars(table);
     }
-    QRegExp m_regex;
 };
 
 class DGLHLRuleHlCHex : public DGLHLRuleBase {
@@ -265,16 +404,25 @@ class DGLHLRuleHlCHex : public DGLHLRuleBase {
                             ,
                             QString(__FUNCTION__)
 #endif
-                            ),
-              m_regex("\\b[+-]?0(x|X)[0-9]+") {
+                            ) {
     }
 
    private:
-    virtual void tryMatch(const QString& str, uint& pos, int& matchSize) {
-        pos = (uint)m_regex.indexIn(str);
-        matchSize = m_regex.matchedLength();
+    // \b[+-]?0(x|X)[0-9]+
+    virtual int matchAt(const DGLHLLine& line, int pos) const {
+        if (!line.isWordBoundary(pos)) {
+            return 0;
+        }
+        int i = pos + line.matchSign(pos);
+        if (line.at(i) != '0' || (line.at(i + 1) != 'x' && line.at(i + 1) != 'X')) {
+            return 0;
+        }
+        int digits = line.matchDigits(i + 2);
+        return digits ? i + 2 + digits - pos : 0;
+    }
+    virtual void getStartChars(std::vector<bool>& table) const {
+        setNumberStartChars(table);
     }
-    QRegExp m_regex;
 };
 
 class DGLHLRuleDecimal : public DGLHLRuleBase {
@@ -291,10 +439,11 @@ class DGLHLRuleDecimal : public DGLHLRuleBase {
     virtual ~DGLHLRuleDecimal() {}
 
    private:
-    virtual void tryMatch(const QString& /*str*/, uint& /*pos*/,
-                          int& /*matchSize*/) {
+    virtual int matchAt(const DGLHLLine& /*line*/, int /*pos*/) const {
         DGL_ASSERT(!"not implemented");
+        return 0;
     }
+    virtual void getStartChars(std::vector<bool>& /*table*/) const {}
 };
 
 class DGLHLRuleHlCOct : public DGLHLRuleBase {
@@ -306,16 +455,25 @@ class DGLHLRuleHlCOct : public DGLHLRuleBase {
                             ,
                             QString(__FUNCTION__)
 #endif
-                            ),
-              m_regex("\\b[+-]?0[0-9]+") {
+                            ) {
     }
 
    private:
-    virtual void tryMatch(const QString& str, uint& pos, int& matchSize) {
-        pos = (uint)m_regex.indexIn(str);
-        matchSize = m_regex.matchedLength();
+    // \b[+-]?0[0-9]+
+    virtual int matchAt(const DGLHLLine& line, int pos) const {
+        if (!line.isWordBoundary(pos)) {
+            return 0;
+        }
+        int i = pos + line.matchSign(pos);
+        if (line.at(i) != '0') {
+            return 0;
+        }
+        int digits = line.matchDigits(i + 1);
+        return digits ? i + 1 + digits - pos : 0;
+    }
+    virtual void getStartChars(std::vector<bool>& table) const {
+        setNumberStartChars(table);
     }
-    QRegExp m_regex;
 };
 
 class DGLHLRuleFloat : public DGLHLRuleBase {
@@ -327,20 +485,57 @@ class DGLHLRuleFloat : public DGLHLRuleBase {
                             ,
                             QString(__FUNCTION__)
 #endif
-                            ),
-              m_regex("\\b[+-]?((((0|[1-9][0-9]*)\\.[0-9]*)|(\\.[0-9]+))([Ee][+"
-                      "-]?["
-                      "0-9]+)?)|((((0|[1-9][0-9]*)\\.?[0-9]*)|(\\.[0-9]+))([Ee]"
-                      "[+-]"
-                      "?[0-9]+))(f|LF)?") {
+                            ) {
     }
 
    private:
-    virtual void tryMatch(const QString& str, uint& pos, int& matchSize) {
-        pos = (uint)m_regex.indexIn(str);
-        matchSize = m_regex.matchedLength();
+    // Longest match of either:
+    //  \b[+-]?((0|[1-9][0-9]*)\.[0-9]*|\.[0-9]+)([Ee][+-]?[0-9]+)?
+    //  ((0|[1-9][0-9]*)\.?[0-9]*|\.[0-9]+)[Ee][+-]?[0-9]+(f|LF)?
+    virtual int matchAt(const DGLHLLine& line, int pos) const {
+        int size = 0;
+        if (line.isWordBoundary(pos)) {
+            int i = pos + line.matchSign(pos);
+            int integer = line.matchDecimal(i);
+            int mantissa = 0;
+            if (integer && line.at(i + integer) == '.') {
+                mantissa = integer + 1 + line.matchDigits(i + integer + 1);
+            } else if (line.at(i) == '.' && line.matchDigits(i + 1)) {
+                mantissa = 1 + line.matchDigits(i + 1);
+            }
+            if (mantissa) {
+                i += mantissa;
+                size = i + line.matchExponent(i) - pos;
+            }
+        }
+
+        int integer = line.matchDecimal(pos);
+        int mantissa = 0;
+        if (integer) {
+            int i = pos + integer;
+            if (line.at(i) == '.') {
+                i++;
+            }
+            mantissa = i + line.matchDigits(i) - pos;
+        } else if (line.at(pos) == '.' && line.matchDigits(pos + 1)) {
+            mantissa = 1 + line.matchDigits(pos + 1);
+        }
+        int exponent = mantissa ? line.matchExponent(pos + mantissa) : 0;
+        if (exponent) {
+            int i = pos + mantissa + exponent;
+            if (line.at(i) == 'f') {
+                i++;
+            } else if (line.at(i) == 'L' && line.at(i + 1) == 'F') {
+                i += 2;
+            }
+            size = std::max(size, i - pos);
+        }
+        return size;
+    }
+    virtual void getStartChars(std::vector<bool>& table) const {
+        setNumberStartChars(table);
+        table[getHLStartTableIdx('.')] = true;
     }
-    QRegExp m_regex;
 };
 
 class DGLHLRuleStringDetect : public DGLHLRuleBase {
@@ -353,19 +548,29 @@ class DGLHLRuleStringDetect : public DGLHLRuleBase {
                             QString(__FUNCTION__) + ":" + _string
 #endif
                             ),
-              m_regex(QRegExp::escape(_string)) {
+              m_string(_string) {
     }
 
-    typedef std::vector<std::string> keywordList_t;
-
    private:
-    virtual void tryMatch(const QString& str, uint& pos, int& matchSize) {
-        pos = (uint)m_regex.indexIn(str);
-        matchSize = m_regex.matchedLength();
+    virtual int matchAt(const DGLHLLine& line, int pos) const {
+        if (m_string.isEmpty() || pos + m_string.length() > line.m_Length) {
+            return 0;
+        }
+        for (int i = 0; i < m_string.length(); i++) {
+            if (line.m_Str[pos + i] != m_string[i].unicode()) {
+                return 0;
+            }
+        }
+        return m_string.length();
+    }
+    virtual void getStartChars(std::vector<bool>& table) const {
+        if (!m_string.isEmpty()) {
+            table[getHLStartTableIdx(m_string[0].unicode())] = true;
+        }
     }
-    QRegExp m_regex;
+    QString m_string;
 };
-
+
 DGLHLRuleBase* DGLHLRuleBase::Create(const DGLHLData* data,
                                      const QDomElement& xml) {
 
@@ -422,42 +627,69 @@ class DGLHLContext {
         int pos, size;
     };
 
-    HLResult doHighlight(const QString& str) const {
+    /**
+     * Find first (and longest of first) rule match in line, starting from
+     * line.m_From. Result position is relative to line.m_From.
+     *
+     * Only rules that can start with given character are tried on each
+     * position, keywords of all rules are looked up at once.
+     */
+    HLResult doHighlight(const DGLHLLine& line) const {
         HLResult ret;
-        int bestMatchSize = 0;
-        size_t best = 0;
-        bool haveBest = false;
-        uint bestPos = static_cast<uint>(str.size());
-        for (size_t i = 0; i < m_rules.size(); i++) {
-            uint pos;
-            int matchSize;
-            m_rules[i]->tryMatch(str, pos, matchSize);
-            if (pos < bestPos ||
-                (pos == bestPos && matchSize > bestMatchSize)) {
-                bestPos = pos;
-                bestMatchSize = matchSize;
-                best = i;
-                haveBest = true;
+        for (int pos = line.m_From; pos < line.m_Length; pos++) {
+            int c = getHLStartTableIdx(line.m_Str[pos]);
+
+            int best = -1;
+            int bestMatchSize = 0;
+
+            if (m_KeywordStart[c] && line.isWordBoundary(pos)) {
+                int end = pos;
+                while (end < line.m_Length &&
+                       DGLHLLine::isWordChar(line.m_Str[end])) {
+                    end++;
+                }
+                QHash<QString, int>::const_iterator keyword =
+                        m_Keywords.find(QString::fromRawData(
+                                reinterpret_cast<const QChar*>(line.m_Str +
+                                                               pos),
+                                end - pos));
+                if (keyword != m_Keywords.end()) {
+                    best = keyword.value();
+                    bestMatchSize = end - pos;
+                }
             }
-        }
-        if (haveBest) {
-            ret.size = bestMatchSize;
-            ret.pos = bestPos;
-            ret.format = m_rules[best]->getFormat();
-            ret.action = m_rules[best]->getAction();
-#ifdef HL_DEBUG
-            qDebug() << "Match(rule = " << m_rules[best]->m_debugRuleName
-                     << ", pos=" << ret.pos << ",size=" << ret.size << "): |"
-                     << str.mid(ret.pos, ret.size) << "|\n";
-#endif
-        } else {
-            ret.pos = str.size();
-            ret.size = 0;
+
+            const std::vector<int>& candidates = m_StartTable[c];
+            for (size_t i = 0; i < candidates.size(); i++) {
+                int matchSize = m_rules[candidates[i]]->matchAt(line, pos);
+                // on equal matches first rule wins
+                if (matchSize > bestMatchSize ||
+                    (matchSize && matchSize == bestMatchSize &&
+                     candidates[i] < best)) {
+                    best = candidates[i];
+                    bestMatchSize = matchSize;
+                }
+            }
+
+            if (bestMatchSize) {
+                ret.size = bestMatchSize;
+                ret.pos = pos - line.m_From;
+                ret.format = m_rules[best]->getFormat();
+                ret.action = m_rules[best]->getAction();
 #ifdef HL_DEBUG
-            qDebug() << "No Match: |" << str << "|\n";
+                qDebug() << "Match(rule = " << m_rules[best]->m_debugRuleName
+                         << ", pos=" << ret.pos << ",size=" << ret.size
+                         << ")\n";
 #endif
+                return ret;
+            }
         }
 
+        ret.pos = line.m_Length - line.m_From;
+        ret.size = 0;
+#ifdef HL_DEBUG
+        qDebug() << "No Match\n";
+#endif
         return ret;
     }
     const DGLHLTextCharFormat* getDefaultFormat() const {
@@ -474,6 +706,18 @@ class DGLHLContext {
 
    private:
     std::vector<std::shared_ptr<DGLHLRuleBase> > m_rules;
+
+    /**
+     * Rules (indices in m_rules) that can match at given character
+     */
+    std::vector<std::vector<int> > m_StartTable;
+
+    /**
+     * Keywords of all keyword rules, mapped to first rule matching them
+     */
+    QHash<QString, int> m_Keywords;
+    std::vector<bool> m_KeywordStart;
+
     const DGLHLTextCharFormat* m_DefaultFormat;
     std::shared_ptr<DGLHLActionBase> m_LineEndAction;
     QDomElement m_xml;
@@ -674,14 +918,11 @@ DGLHLRuleKeyword::DGLHLRuleKeyword(const DGLHLData* data, std::string _string,
                         QString(__FUNCTION__) + ":" +
                                 QString::fromStdString(_string)
 #endif
-                        ) {
-    const keywordList_t* list = data->getKeywordList(_string);
-    QString regexStr;
-    for (size_t i = 0; i < list->size(); i++) {
-        regexStr += QString(i ? "|" : "") + "\\b" +
-                    QRegExp::escape((*list)[i]) + "\\b";
-    }
-    m_regex = QRegExp(regexStr);
+                        ),
+          m_List(data->getKeywordList(_string)) {
+    for (size_t i = 0; i < m_List->size(); i++) {
+        m_Set.insert((*m_List)[i]);
+    }
 }
 
 DGLHLActionBase* DGLHLActionBase::Create(const DGLHLData* data,
@@ -758,6 +999,33 @@ void DGLHLContext::link(const DGLHLData* data) {
         m_rules.push_back(std::shared_ptr<DGLHLRuleBase>(
                 DGLHLRuleBase::Create(data, element)));
     }
+
+    // compile rules to dispatch table
+    m_StartTable.resize(kHLStartTableSize);
+    m_KeywordStart.resize(kHLStartTableSize, false);
+    for (size_t i = 0; i < m_rules.size(); i++) {
+        const DGLHLRuleBase::keywordList_t* keywords =
+                m_rules[i]->getKeywords();
+        if (keywords) {
+            for (size_t j = 0; j < keywords->size(); j++) {
+                const QString& keyword = (*keywords)[j];
+                if (keyword.isEmpty() || m_Keywords.contains(keyword)) {
+                    continue;
+                }
+                m_Keywords.insert(keyword, static_cast<int>(i));
+                m_KeywordStart[getHLStartTableIdx(keyword[0].unicode())] =
+                        true;
+            }
+            continue;
+        }
+        std::vector<bool> startChars(kHLStartTableSize, false);
+        m_rules[i]->getStartChars(startChars);
+        for (int c = 0; c < kHLStartTableSize; c++) {
+            if (startChars[c]) {
+                m_StartTable[c].push_back(static_cast<int>(i));
+            }
+        }
+    }
 }
 
 DGLSyntaxHighlighterGLSL::DGLSyntaxHighlighterGLSL(bool essl,
@@ -777,10 +1045,13 @@ void DGLSyntaxHighlighterGLSL::highlightBlock(const QString& text) {
         currentState = *m_hlStateByIdx[previousStateIdx];
     }
 
-    int pos = 0;
+    DGLHLLine line(text);
+
+    int pos = 0;
     while (pos < text.length()) {
-        DGLHLContext::HLResult res =
-                currentState.getContext()->doHighlight(text.mid(pos));
+        line.m_From = pos;
+        DGLHLContext::HLResult res =
+                currentState.getContext()->doHighlight(line);
 
         if (res.pos) {
             // format all unmatched text with default format of current context
@@ -844,9 +1115,11 @@ bool DGLSyntaxHighlighterGLSL::HLState::operator<(const HLState& other) const {
     } else if (size() > other.size()) {
         return false;
     } else {
+        // lexicographical, so equal states are always mapped to same block
+        // state and rehighlighting stops at first block with unchanged state
         for (size_t i = 0; i < size(); i++) {
-            if ((*this)[i] < other[i]) {
-                return true;
+            if ((*this)[i] != other[i]) {
+                return (*this)[i] < other[i];
             }
         }
         return false;
@@ -17,12 +17,36 @@
 
 DGLTabbedViewItem::DGLTabbedViewItem(dglnet::ContextObjectName objName,
                                      QWidget* parrent)
-        : QWidget(parrent), m_ObjectName(objName) {}
+        : QWidget(parrent), m_ObjectName(objName), m_ResourceListener(NULL) {}
 
 const dglnet::ContextObjectName& DGLTabbedViewItem::getObjName() {
     return m_ObjectName;
 }
 
+void DGLTabbedViewItem::setResourceListener(DGLResourceListener* listener) {
+    m_ResourceListener = listener;
+    m_ResourceListener->setDisplayed(isVisible());
+    CONNASSERT(m_ResourceListener, SIGNAL(evicted()), this,
+               SLOT(releaseResource()));
+}
+
+void DGLTabbedViewItem::showEvent(QShowEvent* event) {
+    // tab is shown when selected, or its dock is shown
+    if (m_ResourceListener) {
+        m_ResourceListener->setDisplayed(true);
+    }
+    QWidget::showEvent(event);
+}
+
+void DGLTabbedViewItem::hideEvent(QHideEvent* event) {
+    if (m_ResourceListener) {
+        m_ResourceListener->setDisplayed(false);
+    }
+    QWidget::hideEvent(event);
+}
+
+void DGLTabbedViewItem::releaseResource() {}
+
 DGLTabbedView::DGLTabbedView(QWidget* parrent, DglController* controller)
         : QDockWidget(parrent), m_Controller(controller), m_TabWidget(this) {
 
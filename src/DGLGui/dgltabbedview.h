@@ -25,13 +25,33 @@
 #include "dglcontroller.h"
 
 class DGLTabbedViewItem : public QWidget {
+    Q_OBJECT
    public:
     DGLTabbedViewItem(dglnet::ContextObjectName, QWidget* parrent);
 
     const dglnet::ContextObjectName& getObjName();
 
+   protected:
+    /**
+     * Register listener of displayed resource. Listener is told when tab is
+     * displayed, and its data may be evicted, when tab is not.
+     */
+    void setResourceListener(DGLResourceListener* listener);
+
+    virtual void showEvent(QShowEvent* event) override;
+    virtual void hideEvent(QHideEvent* event) override;
+
+   protected
+slots:
+    /**
+     * Release resource data held by tab, called when data is evicted to fit
+     * memory budget. Data is queried again, when tab is displayed.
+     */
+    virtual void releaseResource();
+
    private:
     dglnet::ContextObjectName m_ObjectName;
+    DGLResourceListener* m_ResourceListener;
 };
 
 class DGLTabbedView : public QDockWidget {
@@ -52,6 +52,8 @@ DGLTextureViewItem::DGLTextureViewItem(dglnet::ContextObjectName name,
     CONNASSERT(parrent, SIGNAL(visibilityChanged(bool)), m_Listener,
         SLOT(setEnabled(bool)));
 
+    setResourceListener(m_Listener);
+
     m_Ui.labelCM->hide();
     m_Ui.comboBoxCM->hide();
 
@@ -124,6 +126,11 @@ void DGLTextureViewItem::update(const dglnet::DGLResource& res) {
     }
 }
 
+void DGLTextureViewItem::releaseResource() {
+    m_FacesLevelsLayers.clear();
+    error("");
+}
+
 void DGLTextureViewItem::faceComboChanged(int value) {
     uint uvalue = value;
     if (uvalue != m_CurrentFace && uvalue < static_cast<uint>(m_FacesLevelsLayers.size())) {
@@ -181,7 +188,7 @@ void DGLTextureViewItem::internalUpdate() {
     }    
 
     m_PixelRectangleScene->setPixelRectangle(
-            *m_FacesLevelsLayers[m_CurrentFace][m_CurrentLevel][m_CurrentLayer].m_PixelRectangle.get());
+            m_FacesLevelsLayers[m_CurrentFace][m_CurrentLevel][m_CurrentLayer].m_PixelRectangle);
     m_Ui.m_PixelRectangleView->updateFormatSizeInfo(
             m_FacesLevelsLayers[m_CurrentFace][m_CurrentLevel][m_CurrentLayer].m_PixelRectangle.get(),
             m_FacesLevelsLayers[m_CurrentFace][m_CurrentLevel][m_CurrentLayer].m_InternalFormat,
@@ -51,6 +51,7 @@ slots:
     void faceComboChanged(int value);
 
    private:
+    virtual void releaseResource() override;
     void internalUpdate();
 
     Ui::DGLTextureViewItem m_Ui;
@@ -15,11 +15,20 @@
 
 #include "dgltraceview.h"
 
+#include <QHBoxLayout>
+#include <QMessageBox>
 #include <QScrollBar>
 #include <QStyledItemDelegate>
 #include <QPainter>
+#include <QRegExp>
+#include <QToolButton>
+#include <QVBoxLayout>
 
 #include <DGLNet/protocol/entrypoint.h>
+#include <DGLNet/protocol/resource.h>
+
+#include <algorithm>
+#include <functional>
 
 class DGLTraceViewDelegate : public QStyledItemDelegate {
    public:
@@ -75,43 +84,417 @@ class DGLTraceViewDelegate : public QStyledItemDelegate {
     }
 };
 
-DGLTraceViewList::DGLTraceViewList(QWidget* parrent) : QListWidget(parrent) {
-    CONNASSERT(this, SIGNAL(resized()), parrent, SLOT(mayNeedNewElements()));
-    CONNASSERT(this->verticalScrollBar(), SIGNAL(valueChanged(int)), parrent,
-               SLOT(mayNeedNewElements()));
-    setItemDelegate(new DGLTraceViewDelegate(this));
+const int DGLTraceModel::kPageSize = 256;
+const int DGLTraceModel::kMaxPages = 64;
+const int DGLTraceModel::kIndexPageSize = 4096;
+
+DGLTraceModel::Record::Record(const CalledEntryPoint& call)
+        : m_Call(QString::fromStdString(call.toString())),
+          m_Error(static_cast<int>(call.getError())),
+          m_DebugOutput(QString::fromStdString(call.getDebugOutput())) {}
+
+DGLTraceModel::IndexRequestHandler::IndexRequestHandler(
+        DGLTraceModel* parrent, DGLRequestManager* manager)
+        : DGLRequestHandler(manager), m_Parrent(parrent) {}
+
+void DGLTraceModel::IndexRequestHandler::onRequestFinished(
+        const dglnet::message::utils::ReplyBase* reply) {
+    const dglnet::resource::DGLResourceCallTraceSearch* result =
+            dynamic_cast<const dglnet::resource::DGLResourceCallTraceSearch*>(
+                    reply);
+    if (result) {
+        m_Parrent->addIndex(*result);
+    }
+}
+
+void DGLTraceModel::IndexRequestHandler::onRequestFailed(
+        const std::string&) {}
+
+DGLTraceModel::PageRequestHandler::PageRequestHandler(
+        DGLTraceModel* parrent, DGLRequestManager* manager)
+        : DGLRequestHandler(manager), m_Parrent(parrent) {}
+
+void DGLTraceModel::PageRequestHandler::onRequestFinished(
+        const dglnet::message::utils::ReplyBase* reply) {
+    const dglnet::resource::DGLResourceCallTraceSearch* result =
+            dynamic_cast<const dglnet::resource::DGLResourceCallTraceSearch*>(
+                    reply);
+    if (result) {
+        m_Parrent->addFilteredTrace(*result);
+    }
+}
+
+void DGLTraceModel::PageRequestHandler::onRequestFailed(
+        const std::string&) {}
+
+DGLTraceModel::DGLTraceModel(QObject* _parent, DGLRequestManager* manager)
+        : QAbstractListModel(_parent),
+          m_TraceSize(0),
+          m_Breaked(false),
+          m_ScrollDirection(-1),
+          m_RequestManager(manager),
+          m_Filtered(false),
+          m_IndexHandler(this, manager),
+          m_PageHandler(this, manager) {
+    m_Pages.setMaxCost(kMaxPages);
+}
+
+void DGLTraceModel::clear() {
+    beginResetModel();
+    m_TraceSize = 0;
+    m_Breaked = false;
+    m_Index.clear();
+    dropPages();
+    endResetModel();
+}
+
+void DGLTraceModel::reset(const CalledEntryPoint& breaked, uint traceSize) {
+    beginResetModel();
+    m_TraceSize = traceSize;
+    m_Breaked = true;
+    m_BreakedRecord = Record(breaked);
+    m_BreakedRecord.m_Call = QString("BREAKED :  ") + m_BreakedRecord.m_Call;
+    m_BreakedRecord.m_Error = -1;    // do not display GL error
+    m_ScrollDirection = -1;
+    m_Index.clear();
+    dropPages();
+    endResetModel();
+
+    if (m_Filtered && m_TraceSize) {
+        requestIndex(static_cast<value_t>(m_TraceSize - 1));
+    }
+}
+
+void DGLTraceModel::setScrollDirection(int direction) {
+    m_ScrollDirection = direction;
+}
+
+void DGLTraceModel::addTrace(uint startOffset,
+                             const std::vector<CalledEntryPoint>& trace) {
+    if (m_Filtered || startOffset >= m_TraceSize) {
+        return;
+    }
+
+    // trace is ordered from oldest call, last one is at startOffset
+    int lastRow = static_cast<int>(m_TraceSize - 1 - startOffset);
+    int page = lastRow / kPageSize;
+    if (!m_PendingPages.erase(page)) {
+        // obsolete reply
+        return;
+    }
+
+    int firstPageRow = page * kPageSize;
+    Page* records = new Page(
+            std::min<int>(kPageSize, m_TraceSize - firstPageRow));
+    for (size_t i = 0; i < trace.size(); i++) {
+        int row = lastRow - static_cast<int>(trace.size() - 1 - i);
+        if (row >= firstPageRow) {
+            (*records)[row - firstPageRow] = Record(trace[i]);
+        }
+    }
+    m_Pages.insert(page, records);
+
+    int lastPageRow = firstPageRow + static_cast<int>(records->size()) - 1;
+    emit dataChanged(index(firstPageRow), index(lastPageRow));
+}
+
+void DGLTraceModel::setFilter(const dglnet::request::SearchCallTrace* filter) {
+    beginResetModel();
+    m_Filtered = filter != NULL;
+    if (filter) {
+        m_Filter = *filter;
+    }
+    m_Index.clear();
+    dropPages();
+    endResetModel();
+
+    if (m_Filtered && m_Breaked && m_TraceSize) {
+        requestIndex(static_cast<value_t>(m_TraceSize - 1));
+    }
+}
+
+bool DGLTraceModel::isFiltered() const { return m_Filtered; }
+
+int DGLTraceModel::getRow(value_t offset) const {
+    if (!m_Breaked) {
+        return -1;
+    }
+    if (offset == -1) {
+        return getTraceRowCount();
+    }
+    if (!m_Filtered) {
+        if (offset < 0 || static_cast<uint>(offset) >= m_TraceSize) {
+            return -1;
+        }
+        return static_cast<int>(m_TraceSize - 1 - offset);
+    }
+    // offsets in index decrease with row
+    std::vector<value_t>::const_iterator i = std::lower_bound(
+            m_Index.begin(), m_Index.end(), offset, std::greater<value_t>());
+    if (i == m_Index.end() || *i != offset) {
+        return -1;
+    }
+    return static_cast<int>(i - m_Index.begin());
+}
+
+value_t DGLTraceModel::getOffset(int row) const {
+    if (row >= getTraceRowCount()) {
+        return -1;
+    }
+    if (m_Filtered) {
+        return m_Index[row];
+    }
+    return static_cast<value_t>(m_TraceSize - 1 - row);
+}
+
+int DGLTraceModel::rowCount(const QModelIndex& _parent) const {
+    if (_parent.isValid() || !m_Breaked) {
+        return 0;
+    }
+    return getTraceRowCount() + 1;
 }
 
-uint DGLTraceViewList::getVisibleRowCount() {
-    QListWidgetItem* minimumItem = itemAt(5, 5);
-    QListWidgetItem* maximumItem = itemAt(5, height() - 5);
-    if (!minimumItem) {
-        minimumItem = item(0);
+QVariant DGLTraceModel::data(const QModelIndex& _index, int role) const {
+    if (!_index.isValid() || _index.row() >= rowCount()) {
+        return QVariant();
+    }
+
+    const Record* record = getRecord(_index.row());
+    static const Record unknown;
+    if (!record) {
+        record = &unknown;
+    }
+
+    switch (role) {
+        case CallRole:
+            return record->m_Call;
+        case ErrorRole:
+            return record->m_Error;
+        case DebugOutputRole:
+            if (record->m_DebugOutput.isEmpty()) {
+                return QVariant();
+            }
+            return record->m_DebugOutput;
+        default:
+            return QVariant();
+    }
+}
+
+const DGLTraceModel::Record* DGLTraceModel::getRecord(int row) const {
+    if (row == getTraceRowCount()) {
+        return &m_BreakedRecord;
+    }
+
+    int page = row / kPageSize;
+
+    // prefetch in scroll direction
+    int nextPage = page + m_ScrollDirection;
+    if (nextPage >= 0 && nextPage < getPageCount() &&
+        !m_Pages.contains(nextPage)) {
+        requestPage(nextPage);
+    }
+
+    Page* records = m_Pages.object(page);
+    if (!records) {
+        requestPage(page);
+        return NULL;
+    }
+    return &(*records)[row - page * kPageSize];
+}
+
+void DGLTraceModel::requestPage(int page) const {
+    if (!m_PendingPages.insert(page).second) {
+        return;
+    }
+    int firstRow = page * kPageSize;
+    int endRow = std::min(firstRow + kPageSize, getTraceRowCount());
+
+    if (m_Filtered) {
+        // search for page rows, from the oldest one
+        dglnet::request::SearchCallTrace* search =
+                new dglnet::request::SearchCallTrace(m_Filter);
+        search->m_StartOffset = m_Index[firstRow];
+        search->m_Backward = false;
+        search->m_MaxResults = endRow - firstRow;
+        search->m_WithCalls = true;
+        m_RequestManager->request(
+                search, &const_cast<DGLTraceModel*>(this)->m_PageHandler);
+        return;
     }
-    if (!maximumItem) {
-        maximumItem = item(count() - 1);
+
+    // offsets are counted backwards from last call in trace
+    const_cast<DGLTraceModel*>(this)->queryCallTrace(
+            m_TraceSize - static_cast<uint>(endRow),
+            m_TraceSize - static_cast<uint>(firstRow));
+}
+
+int DGLTraceModel::getPageCount() const {
+    return (getTraceRowCount() + kPageSize - 1) / kPageSize;
+}
+
+int DGLTraceModel::getTraceRowCount() const {
+    if (m_Filtered) {
+        return static_cast<int>(m_Index.size());
     }
-    return indexFromItem(maximumItem).row() - indexFromItem(minimumItem).row() +
-           1;
+    return static_cast<int>(m_TraceSize);
+}
+
+void DGLTraceModel::dropPages() {
+    m_Pages.clear();
+    m_PendingPages.clear();
+    m_RequestManager->unregisterHandler(&m_IndexHandler);
+    m_RequestManager->unregisterHandler(&m_PageHandler);
 }
 
-int DGLTraceViewList::getFirstVisibleElementIdx() {
-    QListWidgetItem* minimumItem = itemAt(5, 5);
-    if (!minimumItem) {
-        minimumItem = item(0);
+void DGLTraceModel::requestIndex(value_t startOffset) {
+    dglnet::request::SearchCallTrace* search =
+            new dglnet::request::SearchCallTrace(m_Filter);
+    // search from the oldest call, so rows can be appended
+    search->m_StartOffset = startOffset;
+    search->m_Backward = false;
+    search->m_MaxResults = kIndexPageSize;
+    search->m_WithCalls = false;
+    m_RequestManager->request(search, &m_IndexHandler);
+}
+
+void DGLTraceModel::addIndex(
+        const dglnet::resource::DGLResourceCallTraceSearch& result) {
+    if (!m_Filtered) {
+        return;
+    }
+
+    if (result.m_Offsets.size()) {
+        int firstRow = getTraceRowCount();
+
+        // last page grows, so it has to be fetched again
+        int lastPage = (firstRow - 1) / kPageSize;
+        if (firstRow % kPageSize) {
+            m_Pages.remove(lastPage);
+            m_PendingPages.erase(lastPage);
+        }
+
+        beginInsertRows(QModelIndex(), firstRow,
+                        firstRow + static_cast<int>(result.m_Offsets.size()) -
+                                1);
+        m_Index.insert(m_Index.end(), result.m_Offsets.begin(),
+                       result.m_Offsets.end());
+        endInsertRows();
+
+        if (firstRow % kPageSize) {
+            emit dataChanged(index(lastPage * kPageSize), index(firstRow - 1));
+        }
+    }
+
+    if (!result.m_Complete) {
+        requestIndex(result.m_NextOffset);
     }
-    return indexFromItem(minimumItem).row();
 }
 
-void DGLTraceViewList::resizeEvent(QResizeEvent* /*e*/) { resized(); }
+void DGLTraceModel::addFilteredTrace(
+        const dglnet::resource::DGLResourceCallTraceSearch& result) {
+    if (!m_Filtered || result.m_Offsets.empty() ||
+        result.m_Offsets.size() != result.m_Calls.size()) {
+        return;
+    }
+
+    int firstRow = getRow(result.m_Offsets[0]);
+    int page = firstRow / kPageSize;
+    if (firstRow < 0 || !m_PendingPages.erase(page)) {
+        // obsolete reply
+        return;
+    }
+
+    int firstPageRow = page * kPageSize;
+    Page* records = new Page(
+            std::min<int>(kPageSize, getTraceRowCount() - firstPageRow));
+    for (size_t i = 0; i < result.m_Offsets.size(); i++) {
+        int row = getRow(result.m_Offsets[i]);
+        if (row >= firstPageRow &&
+            row < firstPageRow + static_cast<int>(records->size())) {
+            (*records)[row - firstPageRow] = Record(result.m_Calls[i]);
+        }
+    }
+    m_Pages.insert(page, records);
+
+    int lastPageRow = firstPageRow + static_cast<int>(records->size()) - 1;
+    emit dataChanged(index(firstPageRow), index(lastPageRow));
+}
 
 DGLTraceView::DGLTraceView(QWidget* parrent, DglController* controller)
-        : QDockWidget(tr("Call trace"), parrent), m_traceList(this) {
+        : QDockWidget(tr("Call trace"), parrent),
+          DGLRequestHandler(controller->getRequestManager()),
+          m_traceList(this),
+          m_Model(this, controller->getRequestManager()),
+          m_LastScrollValue(0),
+          m_RequestManager(controller->getRequestManager()),
+          m_SearchErrors(tr("GL errors")),
+          m_SearchDebugOutput(tr("Debug output")),
+          m_SearchFilter(tr("Filter")) {
     setObjectName("DGLTraceView");
 
     setEnabled(false);
 
-    setWidget(&m_traceList);
+    m_traceList.setItemDelegate(new DGLTraceViewDelegate(&m_traceList));
+    // all rows have same height, so view does not have to query them all
+    m_traceList.setUniformItemSizes(true);
+    m_traceList.setModel(&m_Model);
+
+    m_SearchEntrypoints.setPlaceholderText(tr("Entrypoints"));
+    m_SearchEntrypoints.setToolTip(
+            tr("Space separated entrypoint names, e.g. glDrawArrays "
+               "glDrawElements"));
+    m_SearchArgs.setPlaceholderText(tr("Arguments"));
+    m_SearchArgs.setToolTip(
+            tr("Comma separated argument values, * matches any value, e.g. "
+               "GL_TEXTURE_2D, *"));
+
+    QToolButton* previous = new QToolButton();
+    previous->setArrowType(Qt::UpArrow);
+    previous->setToolTip(tr("Find previous call"));
+    QToolButton* next = new QToolButton();
+    next->setArrowType(Qt::DownArrow);
+    next->setToolTip(tr("Find next call"));
+    m_SearchFilter.setToolTip(tr("Show only matching calls"));
+
+    QHBoxLayout* searchLayout = new QHBoxLayout();
+    searchLayout->addWidget(&m_SearchEntrypoints, 2);
+    searchLayout->addWidget(&m_SearchArgs, 1);
+    searchLayout->addWidget(&m_SearchErrors);
+    searchLayout->addWidget(&m_SearchDebugOutput);
+    searchLayout->addWidget(previous);
+    searchLayout->addWidget(next);
+    searchLayout->addWidget(&m_SearchFilter);
+
+    QWidget* widget = new QWidget(this);
+    QVBoxLayout* layout = new QVBoxLayout(widget);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addLayout(searchLayout);
+    layout->addWidget(&m_traceList);
+
+    setWidget(widget);
+
+    CONNASSERT(m_traceList.verticalScrollBar(), SIGNAL(valueChanged(int)),
+               this, SLOT(scrolled(int)));
+
+    // search bar. View starts at the breaked call, so enter searches towards
+    // older calls
+    CONNASSERT(&m_SearchEntrypoints, SIGNAL(returnPressed()), this,
+               SLOT(findPrevious()));
+    CONNASSERT(&m_SearchArgs, SIGNAL(returnPressed()), this,
+               SLOT(findPrevious()));
+    CONNASSERT(previous, SIGNAL(clicked()), this, SLOT(findPrevious()));
+    CONNASSERT(next, SIGNAL(clicked()), this, SLOT(findNext()));
+    CONNASSERT(&m_SearchEntrypoints, SIGNAL(editingFinished()), this,
+               SLOT(updateFilter()));
+    CONNASSERT(&m_SearchArgs, SIGNAL(editingFinished()), this,
+               SLOT(updateFilter()));
+    CONNASSERT(&m_SearchErrors, SIGNAL(toggled(bool)), this,
+               SLOT(updateFilter()));
+    CONNASSERT(&m_SearchDebugOutput, SIGNAL(toggled(bool)), this,
+               SLOT(updateFilter()));
+    CONNASSERT(&m_SearchFilter, SIGNAL(toggled(bool)), this,
+               SLOT(updateFilter()));
+
     // inbound
     CONNASSERT(controller, SIGNAL(setConnected(bool)), this,
                SLOT(setEnabled(bool)));
@@ -124,75 +507,138 @@ DGLTraceView::DGLTraceView(QWidget* parrent, DglController* controller)
                this, SLOT(gotCallTraceChunkChunk(
                              uint, const std::vector<CalledEntryPoint>&)));
     // outbound
-    CONNASSERT(this, SIGNAL(queryCallTrace(uint, uint)), controller,
+    CONNASSERT(&m_Model, SIGNAL(queryCallTrace(uint, uint)), controller,
                SLOT(queryCallTrace(uint, uint)));
 }
 
-void DGLTraceView::setEnabled(bool enabled) {
-    m_traceList.clear();
-    m_Enabled = enabled;
-    m_QueryUpperBound = 0;
+void DGLTraceView::onRequestFinished(
+        const dglnet::message::utils::ReplyBase* reply) {
+    const dglnet::resource::DGLResourceCallTraceSearch* result =
+            dynamic_cast<const dglnet::resource::DGLResourceCallTraceSearch*>(
+                    reply);
+    if (!result || result->m_Offsets.empty()) {
+        return;
+    }
+    int row = m_Model.getRow(result->m_Offsets[0]);
+    if (row >= 0) {
+        m_traceList.setCurrentIndex(m_Model.index(row));
+        m_traceList.scrollTo(m_Model.index(row),
+                             QAbstractItemView::PositionAtCenter);
+    }
 }
 
+void DGLTraceView::onRequestFailed(const std::string& error) {
+    QMessageBox::critical(this, tr("Cannot search call trace"),
+                          QString::fromStdString(error));
+}
+
+void DGLTraceView::setEnabled(bool /*enabled*/) { m_Model.clear(); }
+
 void DGLTraceView::setRunning(bool running) {
     if (running) {
-        m_traceList.clear();
-        m_QueryUpperBound = 0;
+        m_Model.clear();
     }
 }
 
-void DGLTraceView::mayNeedNewElements() {
-    if (m_Enabled) {
-        if (m_traceList.getFirstVisibleElementIdx() <
-            m_traceList.count() - m_QueryUpperBound - 1) {
-            // we are starving of entrypoints to display, try to query new
-            // entrypoints up to this bound
-            int nextUpperBound =
-                    m_QueryUpperBound + 2 * m_traceList.getVisibleRowCount();
-            queryCallTrace(m_QueryUpperBound, nextUpperBound);
-            m_QueryUpperBound = nextUpperBound;
+void DGLTraceView::scrolled(int value) {
+    if (value != m_LastScrollValue) {
+        m_Model.setScrollDirection(value < m_LastScrollValue ? -1 : 1);
+        m_LastScrollValue = value;
+    }
+}
+
+void DGLTraceView::findPrevious() { find(true); }
+
+void DGLTraceView::findNext() { find(false); }
+
+void DGLTraceView::updateFilter() {
+    dglnet::request::SearchCallTrace search;
+    if (m_SearchFilter.isChecked() && getSearch(search)) {
+        m_Model.setFilter(&search);
+    } else if (m_Model.isFiltered()) {
+        m_Model.setFilter(NULL);
+    }
+}
+
+void DGLTraceView::find(bool backward) {
+    if (!m_Model.rowCount()) {
+        return;
+    }
+
+    int row = m_traceList.currentIndex().isValid()
+                      ? m_traceList.currentIndex().row()
+                      : m_Model.rowCount() - 1;
+
+    if (m_Model.isFiltered()) {
+        // all displayed calls match
+        row += backward ? -1 : 1;
+        if (row >= 0 && row < m_Model.rowCount()) {
+            m_traceList.setCurrentIndex(m_Model.index(row));
+            m_traceList.scrollTo(m_Model.index(row));
+        }
+        return;
+    }
+
+    dglnet::request::SearchCallTrace* search =
+            new dglnet::request::SearchCallTrace();
+    if (!getSearch(*search)) {
+        delete search;
+        return;
+    }
+    value_t offset = m_Model.getOffset(row);
+    search->m_Backward = backward;
+    search->m_StartOffset = backward ? offset + 1 : offset - 1;
+    search->m_MaxResults = 1;
+    if (search->m_StartOffset < 0) {
+        // nothing is newer than breaked call
+        delete search;
+        return;
+    }
+
+    // only last search is relevant
+    m_RequestManager->unregisterHandler(this);
+    m_RequestManager->request(search, this);
+}
+
+bool DGLTraceView::getSearch(dglnet::request::SearchCallTrace& search) {
+    QStringList entrypoints = m_SearchEntrypoints.text().split(
+            QRegExp("[\\s,]+"), QString::SkipEmptyParts);
+    for (int i = 0; i < entrypoints.size(); i++) {
+        Entrypoint entrypoint =
+                GetEntryPointEnum(entrypoints[i].toStdString().c_str());
+        if (entrypoint == NO_ENTRYPOINT) {
+            QMessageBox::warning(this, tr("Invalid search"),
+                                 tr("Unknown entrypoint: ") + entrypoints[i]);
+            return false;
+        }
+        search.m_Entrypoints.insert(entrypoint);
+    }
+
+    if (!m_SearchArgs.text().trimmed().isEmpty()) {
+        QStringList args = m_SearchArgs.text().split(',');
+        for (int i = 0; i < args.size(); i++) {
+            QString arg = args[i].trimmed();
+            if (!arg.isEmpty() && arg != "*") {
+                search.m_ArgFilters.push_back(
+                        dglnet::request::SearchCallTrace::ArgFilter(
+                                i, arg.toStdString()));
+            }
         }
     }
+
+    search.m_GLErrorOnly = m_SearchErrors.isChecked();
+    search.m_DebugOutputOnly = m_SearchDebugOutput.isChecked();
+    return true;
 }
 
 void DGLTraceView::breaked(const CalledEntryPoint& entryp, uint traceSize) {
-    m_traceList.clear();
-    m_QueryUpperBound = 0;
-    for (uint i = 0; i < traceSize; i++) {
-        QListWidgetItem* item = new QListWidgetItem();
-        item->setData(Qt::UserRole, "<unknown>");
-        m_traceList.addItem(item);
-    }
-    QListWidgetItem* item = new QListWidgetItem();
-    item->setData(
-            Qt::UserRole,
-            QString("BREAKED :  ") + QString::fromStdString(entryp.toString()));
-    item->setData(Qt::UserRole + 1, -1);    // do not display GL error
-    m_traceList.addItem(item);
-    m_traceList.setCurrentRow(m_traceList.count() - 1);
+    m_Model.reset(entryp, traceSize);
+    m_traceList.setCurrentIndex(m_Model.index(m_Model.rowCount() - 1));
     m_traceList.scrollToBottom();
-    m_QueryUpperBound = 0;
-    mayNeedNewElements();
+    m_LastScrollValue = m_traceList.verticalScrollBar()->value();
 }
 
 void DGLTraceView::gotCallTraceChunkChunk(
         uint offset, const std::vector<CalledEntryPoint>& trace) {
-    for (uint i = offset; i < offset + trace.size(); i++) {
-        int row = m_traceList.count() - i - 2;
-        delete m_traceList.takeItem(row);
-
-        std::string func = trace[trace.size() - 1 - i + offset].toString();
-        gl_t error = trace[trace.size() - 1 - i + offset].getError();
-        std::string debugOutput =
-                trace[trace.size() - 1 - i + offset].getDebugOutput();
-
-        QListWidgetItem* item = new QListWidgetItem();
-        item->setData(Qt::UserRole, func.c_str());
-        item->setData(Qt::UserRole + 1, (uint)error);
-        if (debugOutput.length()) {
-            item->setData(Qt::UserRole + 2, debugOutput.c_str());
-        }
-
-        m_traceList.insertItem(row, item);
-    }
+    m_Model.addTrace(offset, trace);
 }
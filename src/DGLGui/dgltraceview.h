@@ -17,33 +17,229 @@
 #define DGLTRACEVIEW_H
 
 #include "dglqtgui.h"
+#include <QAbstractListModel>
+#include <QCache>
+#include <QCheckBox>
 #include <QDockWidget>
+#include <QLineEdit>
+#include <QListView>
 
 #include "DGLCommon//gl-types.h"
+#include "DGLNet/protocol/request.h"
 
 #include "dglcontroller.h"
 
-class DGLTraceViewList : public QListWidget {
+#include <set>
+
+/**
+ * Model of call trace seen from a break.
+ *
+ * Row 0 is the oldest call in trace, last row is the breaked call. Calls are
+ * fetched from debugee in pages, when any row of page is first accessed (so
+ * only pages actually displayed are fetched), and kept in bounded cache. Next
+ * page in scroll direction is prefetched. Each call is formatted once, when
+ * its page is received.
+ *
+ * When filter is set, rows are only calls matching it. Offsets of matching
+ * calls are searched by debugee and received in pages, and rows are appended
+ * as they come.
+ */
+class DGLTraceModel : public QAbstractListModel {
     Q_OBJECT
    public:
-    DGLTraceViewList(QWidget*);
-    uint getVisibleRowCount();
-    int getFirstVisibleElementIdx();
+    /**
+     * Data roles provided by model
+     */
+    enum Role {
+        CallRole = Qt::UserRole,           // formatted call
+        ErrorRole = Qt::UserRole + 1,      // GL error, -1 if not known
+        DebugOutputRole = Qt::UserRole + 2    // debug output, if any
+    };
+
+    DGLTraceModel(QObject* parent, DGLRequestManager* manager);
+
+    /**
+     * Remove all rows
+     */
+    void clear();
+
+    /**
+     * Start new trace of given size, ending with breaked call.
+     */
+    void reset(const CalledEntryPoint& breaked, uint traceSize);
+
+    /**
+     * Set direction of prefetch: -1 (towards older calls) or 1.
+     */
+    void setScrollDirection(int direction);
+
+    /**
+     * Handle call trace chunk received from debugee
+     */
+    void addTrace(uint startOffset, const std::vector<CalledEntryPoint>& trace);
+
+    /**
+     * Display only calls matching filter, or all calls if filter is NULL.
+     */
+    void setFilter(const dglnet::request::SearchCallTrace* filter);
+
+    bool isFiltered() const;
+
+    /**
+     * Get row displaying call of given offset, -1 if call is not displayed.
+     */
+    int getRow(value_t offset) const;
+
+    /**
+     * Get offset of call displayed in row. Breaked call has offset -1.
+     */
+    value_t getOffset(int row) const;
+
+    virtual int rowCount(const QModelIndex& parent = QModelIndex()) const;
+    virtual QVariant data(const QModelIndex& index,
+                          int role = Qt::DisplayRole) const;
 
-   private:
-    virtual void resizeEvent(QResizeEvent* e);
 signals:
-    void resized();
+    void queryCallTrace(uint startOffset, uint endOffset);
+
+   private:
+    /**
+     * Number of calls in page
+     */
+    static const int kPageSize;
+
+    /**
+     * Number of pages kept in cache
+     */
+    static const int kMaxPages;
+
+    /**
+     * Number of offsets in single filter search reply
+     */
+    static const int kIndexPageSize;
+
+    class IndexRequestHandler : public DGLRequestHandler {
+       public:
+        IndexRequestHandler(DGLTraceModel* parrent,
+                            DGLRequestManager* manager);
+        virtual void onRequestFinished(
+                const dglnet::message::utils::ReplyBase* reply) override;
+        virtual void onRequestFailed(const std::string& error) override;
+
+       private:
+        DGLTraceModel* m_Parrent;
+    };
+
+    class PageRequestHandler : public DGLRequestHandler {
+       public:
+        PageRequestHandler(DGLTraceModel* parrent,
+                           DGLRequestManager* manager);
+        virtual void onRequestFinished(
+                const dglnet::message::utils::ReplyBase* reply) override;
+        virtual void onRequestFailed(const std::string& error) override;
+
+       private:
+        DGLTraceModel* m_Parrent;
+    };
+
+    /**
+     * Single formatted call
+     */
+    struct Record {
+        Record() : m_Call("<unknown>"), m_Error(-1) {}
+        Record(const CalledEntryPoint& call);
+        QString m_Call;
+        int m_Error;
+        QString m_DebugOutput;
+    };
+
+    typedef std::vector<Record> Page;
+
+    /**
+     * Get record of row. Requests page of this row (and next one in scroll
+     * direction), if not cached.
+     */
+    const Record* getRecord(int row) const;
+
+    /**
+     * Request page from debugee, unless already requested.
+     */
+    void requestPage(int page) const;
+
+    int getPageCount() const;
+
+    /**
+     * Number of rows with calls from trace (all but breaked call)
+     */
+    int getTraceRowCount() const;
+
+    /**
+     * Drop pages, that are being fetched or cached. Ongoing searches are
+     * abandoned.
+     */
+    void dropPages();
+
+    /**
+     * Request next part of filtered call offsets, starting from given offset
+     */
+    void requestIndex(value_t startOffset);
+
+    /**
+     * Handle filtered call offsets received from debugee
+     */
+    void addIndex(const dglnet::resource::DGLResourceCallTraceSearch& result);
+
+    /**
+     * Handle filtered calls received from debugee
+     */
+    void addFilteredTrace(
+            const dglnet::resource::DGLResourceCallTraceSearch& result);
+
+    /**
+     * Number of calls in trace, not including breaked call
+     */
+    uint m_TraceSize;
+
+    /**
+     * True if model displays a break (m_TraceSize + 1 rows)
+     */
+    bool m_Breaked;
+
+    Record m_BreakedRecord;
+
+    int m_ScrollDirection;
+
+    mutable QCache<int, Page> m_Pages;
+
+    /**
+     * Pages requested, but not received yet. Replies for other pages are
+     * obsolete.
+     */
+    mutable std::set<int> m_PendingPages;
+
+    DGLRequestManager* m_RequestManager;
+
+    bool m_Filtered;
+    dglnet::request::SearchCallTrace m_Filter;
+
+    /**
+     * Offsets of calls matching filter, for each row
+     */
+    std::vector<value_t> m_Index;
+
+    IndexRequestHandler m_IndexHandler;
+    PageRequestHandler m_PageHandler;
 };
 
-class DGLTraceView : public QDockWidget {
+class DGLTraceView : public QDockWidget, public DGLRequestHandler {
     Q_OBJECT
 
    public:
     DGLTraceView(QWidget* parrent, DglController* controller);
 
-signals:
-    void queryCallTrace(uint startOffset, uint endOffset);
+    virtual void onRequestFinished(
+            const dglnet::message::utils::ReplyBase* reply) override;
+    virtual void onRequestFailed(const std::string& error) override;
 
    public
 slots:
@@ -52,12 +248,36 @@ slots:
     void breaked(const CalledEntryPoint&, uint);
     void gotCallTraceChunkChunk(uint, const std::vector<CalledEntryPoint>&);
 
-    void mayNeedNewElements();
+   private
+slots:
+    void scrolled(int value);
+    void findPrevious();
+    void findNext();
+    void updateFilter();
 
    private:
-    DGLTraceViewList m_traceList;
-    bool m_Enabled;
-    int m_QueryUpperBound;
+    /**
+     * Select next call matching search criteria, towards older calls if
+     * backward.
+     */
+    void find(bool backward);
+
+    /**
+     * Build search request from search bar. Returns false, if search bar
+     * contents are not valid.
+     */
+    bool getSearch(dglnet::request::SearchCallTrace& search);
+
+    QListView m_traceList;
+    DGLTraceModel m_Model;
+    int m_LastScrollValue;
+    DGLRequestManager* m_RequestManager;
+
+    QLineEdit m_SearchEntrypoints;
+    QLineEdit m_SearchArgs;
+    QCheckBox m_SearchErrors;
+    QCheckBox m_SearchDebugOutput;
+    QCheckBox m_SearchFilter;
 };
 
 #endif    // DGLTRACEVIEW_H
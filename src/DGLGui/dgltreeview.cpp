@@ -15,483 +15,588 @@
 
 #include "dgltreeview.h"
 
+#include <algorithm>
 #include <set>
 #include <climits>
 
-DGLTreeView::DGLTreeView(QWidget* parrent, DglController* controller)
-        : QDockWidget(tr("State Tree"), parrent),
-          m_TreeWidget(this),
-          m_controller(controller) {
-    setObjectName("DGLTreeView");
+using dglnet::ContextObjectName;
+using dglnet::message::ObjectType;
+using dglnet::message::utils::ContextReport;
+
+const int DGLTreeModel::kFetchSize = 256;
+
+namespace {
+/**
+ * Position of object folders in context node
+ */
+enum ContextFolder {
+    kTextureFolder,
+    kBufferFolder,
+    kFBOFolder,
+    kRenderbufferFolder,
+    kShaderFolder,
+    kProgramFolder,
+    kTextureUnitFolder,
+    kFramebufferFolder
+};
+}
 
-    //    m_TreeWidget.setMinimumSize(QSize(200, 0));
+struct DGLTreeModel::Node {
+    Node(Node* parent, const QString& text, const QString& icon,
+         ObjectType type)
+            : m_Parent(parent),
+              m_Row(parent ? (int)parent->m_Children.size() : 0),
+              m_Text(text),
+              m_Icon(icon),
+              m_Bold(false),
+              m_Id(0),
+              m_Type(type),
+              m_Fetched(0),
+              m_FetchLimit(0) {}
+
+    ~Node() {
+        for (size_t i = 0; i < m_Children.size(); i++) {
+            delete m_Children[i];
+        }
+    }
 
-    setConnected(false);
+    /**
+     * True, if node lists objects (m_Names), not other nodes (m_Children)
+     */
+    bool hasObjects() const { return m_Type != ObjectType::Invalid; }
 
-    setWidget(&m_TreeWidget);
-    // inbound
-    CONNASSERT(controller, SIGNAL(setConnected(bool)), this,
-               SLOT(setConnected(bool)));
-    CONNASSERT(controller, SIGNAL(debugeeInfo(const std::string&)), this,
-               SLOT(debugeeInfo(const std::string&)));
-    CONNASSERT(controller, SIGNAL(setBreaked(bool)), &m_TreeWidget,
-               SLOT(setEnabled(bool)));
-    CONNASSERT(controller,
-               SIGNAL(breakedWithStateReports(
-                       opaque_id_t,
-                       const std::vector<
-                               dglnet::message::utils::ContextReport>&)),
-               this,
-               SLOT(breakedWithStateReports(
-                       opaque_id_t,
-                       const std::vector<
-                               dglnet::message::utils::ContextReport>&)));
+    Node* m_Parent;
+    int m_Row;
+    QString m_Text;
+    QIcon m_Icon;
+    bool m_Bold;
 
-    // internal
-    CONNASSERT(&m_TreeWidget, SIGNAL(itemDoubleClicked(QTreeWidgetItem*, int)),
-               this, SLOT(onDoubleClicked(QTreeWidgetItem*, int)));
-}
+    /**
+     * Context id, for context nodes
+     */
+    opaque_id_t m_Id;
 
-DGLTreeView::~DGLTreeView() {}
+    /**
+     * Type of objects listed in node, Invalid for contexts and folders of
+     * folders
+     */
+    ObjectType m_Type;
+
+    std::vector<Node*> m_Children;
+
+    /**
+     * All objects of folder, in report order. Only first m_Fetched are
+     * exposed as rows.
+     */
+    std::vector<ContextObjectName> m_Names;
+    int m_Fetched;
+
+    /**
+     * Number of rows requested by view, so objects appended to already
+     * displayed folder are shown without another fetchMore()
+     */
+    int m_FetchLimit;
+};
 
-void DGLTreeView::setConnected(bool connected) {
-    m_Connected = connected;
-    if (!connected) {
-        m_TreeWidget.setHeaderLabel("");
-        while (m_TreeWidget.topLevelItemCount()) {
-            delete m_TreeWidget.takeTopLevelItem(0);
-        }
-    }
-}
+DGLTreeModel::DGLTreeModel(QObject* parent)
+        : QAbstractItemModel(parent),
+          m_Root(new Node(NULL, QString(), QString(), ObjectType::Invalid)) {}
 
-void QClickableTreeWidgetItem::handleDoubleClick(DglController*) {}
+DGLTreeModel::~DGLTreeModel() { delete m_Root; }
 
-const dglnet::ContextObjectName& QClickableTreeWidgetItem::getObjName() {
-    return m_name;
+void DGLTreeModel::clear() {
+    beginResetModel();
+    delete m_Root;
+    m_Root = new Node(NULL, QString(), QString(), ObjectType::Invalid);
+    endResetModel();
 }
 
-void QClickableTreeWidgetItem::setObjName(const dglnet::ContextObjectName& name) {
-    m_name = name;
+void DGLTreeModel::setHeader(const QString& header) {
+    m_Header = header;
+    emit headerDataChanged(Qt::Horizontal, 0, 0);
 }
 
-class DGLTextureWidget : public QClickableTreeWidgetItem {
-   public:
-    DGLTextureWidget() {}
-
-    DGLTextureWidget(QString iconPath) {
-        setIcon(0, QIcon(iconPath));
+void DGLTreeModel::update(opaque_id_t currentContextId,
+                          const std::vector<ContextReport>& reports) {
+    for (size_t i = 0; i < reports.size(); i++) {
+        Node* ctxNode = NULL;
+        for (size_t j = 0; j < m_Root->m_Children.size(); j++) {
+            if (m_Root->m_Children[j]->m_Id == reports[i].m_Id) {
+                ctxNode = m_Root->m_Children[j];
+                break;
+            }
+        }
+        if (!ctxNode) {
+            int row = (int)m_Root->m_Children.size();
+            beginInsertRows(QModelIndex(), row, row);
+            ctxNode = new Node(m_Root, QString(), ":/icons/context.png",
+                               ObjectType::Invalid);
+            ctxNode->m_Id = reports[i].m_Id;
+            m_Root->m_Children.push_back(ctxNode);
+            // must match ContextFolder order
+            addFolder(ctxNode, "Textures", DGL_RES_ICON_TEXTURE_PATH,
+                      ObjectType::Texture);
+            addFolder(ctxNode, "Vertex Buffers", DGL_RES_ICON_BUFFER_PATH,
+                      ObjectType::Buffer);
+            addFolder(ctxNode, "Framebuffer objects", DGL_RES_ICON_FBO_PATH,
+                      ObjectType::FBO);
+            addFolder(ctxNode, "Renderbuffer objects",
+                      DGL_RES_ICON_RENDERBUFFER_PATH, ObjectType::Renderbuffer);
+            addFolder(ctxNode, "Shaders", DGL_RES_ICON_SHADER_PATH,
+                      ObjectType::Shader);
+            addFolder(ctxNode, "Shader Programs", DGL_RES_ICON_PROGRAM_PATH,
+                      ObjectType::Program);
+            addFolder(ctxNode, "Texture units", DGL_RES_ICON_TEXTUREUNIT_PATH,
+                      ObjectType::Invalid);
+            addFolder(ctxNode, "Frame Buffers", DGL_RES_ICON_FRAMEBUFFER_PATH,
+                      ObjectType::Framebuffer);
+            endInsertRows();
+        }
+        updateContext(ctxNode, reports[i], reports[i].m_Id == currentContextId);
     }
 
-    virtual void setObjName(const dglnet::ContextObjectName& name) {
-        setText(0, QString("Texture ") + QString::number(name.m_Name) +
-            QString::fromStdString(
-            " (" + GetTextureTargetName(name.m_Target) +
-            ")"));
-        QClickableTreeWidgetItem::setObjName(name);
+    for (int j = 0; j < (int)m_Root->m_Children.size(); j++) {
+        bool found = false;
+        for (size_t i = 0; i < reports.size(); i++) {
+            if (m_Root->m_Children[j]->m_Id == reports[i].m_Id) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            removeNodes(m_Root, j--, 1);
+        }
     }
+}
 
-    virtual void handleDoubleClick(DglController* controller) {
-        controller->getViewRouter()->show(
-                m_name, dglnet::message::ObjectType::Texture);
+bool DGLTreeModel::getObject(const QModelIndex& index, ContextObjectName& name,
+                             ObjectType& type) const {
+    if (!index.isValid()) {
+        return false;
     }
-};
-
-class DGLProgramPipelineWidget : public QClickableTreeWidgetItem {
-public:
-    DGLProgramPipelineWidget() {}
-
-    DGLProgramPipelineWidget(QString iconPath) {
-            setIcon(0, QIcon(iconPath));
+    Node* parentNode = static_cast<Node*>(index.internalPointer());
+    if (!parentNode->hasObjects()) {
+        return false;
     }
+    name = parentNode->m_Names[index.row()];
+    type = parentNode->m_Type;
+    return true;
+}
 
-    virtual void setObjName(const dglnet::ContextObjectName& name) {
-        setText(0, QString("Program ") + QString::number(name.m_Name));
-        QClickableTreeWidgetItem::setObjName(name);
+QModelIndex DGLTreeModel::index(int row, int column,
+                                const QModelIndex& parent) const {
+    if (!hasIndex(row, column, parent)) {
+        return QModelIndex();
     }
+    return createIndex(row, column, getNode(parent));
+}
 
-    virtual void handleDoubleClick(DglController* controller) {
-        controller->getViewRouter()->show(
-            m_name, dglnet::message::ObjectType::Texture);
+QModelIndex DGLTreeModel::parent(const QModelIndex& index) const {
+    if (!index.isValid()) {
+        return QModelIndex();
     }
-};
-
+    return getIndex(static_cast<Node*>(index.internalPointer()));
+}
 
-class DGLBufferWidget : public QClickableTreeWidgetItem {
-   public:
-    DGLBufferWidget() {}
-    DGLBufferWidget(QString iconPath) {        
-        setIcon(0, QIcon(iconPath));
+int DGLTreeModel::rowCount(const QModelIndex& parent) const {
+    if (parent.column() > 0) {
+        return 0;
     }
-
-    virtual void setObjName(const dglnet::ContextObjectName& name) {
-        setText(0, QString("Buffer ") + QString::number(name.m_Name));
-        QClickableTreeWidgetItem::setObjName(name);
+    Node* node = getNode(parent);
+    if (!node) {
+        return 0;
     }
-
-    void handleDoubleClick(DglController* controller) {
-        controller->getViewRouter()->show(
-                m_name, dglnet::message::ObjectType::Buffer);
+    if (node->hasObjects()) {
+        return node->m_Fetched;
     }
-};
+    return (int)node->m_Children.size();
+}
 
-class DGLFBOWidget : public QClickableTreeWidgetItem {
-   public:
-    DGLFBOWidget() {}
-    DGLFBOWidget(QString iconPath) {
-        setIcon(0, QIcon(iconPath));
-    }
+int DGLTreeModel::columnCount(const QModelIndex&) const { return 1; }
 
-    virtual void setObjName(const dglnet::ContextObjectName& name) {
-        setText(0, QString("FBO ") + QString::number(name.m_Name));
-        QClickableTreeWidgetItem::setObjName(name);
+bool DGLTreeModel::hasChildren(const QModelIndex& parent) const {
+    if (parent.column() > 0) {
+        return false;
     }
-
-    void handleDoubleClick(DglController* controller) {
-        controller->getViewRouter()->show(m_name,
-                                          dglnet::message::ObjectType::FBO);
+    Node* node = getNode(parent);
+    if (!node) {
+        return false;
     }
-};
+    // report children of folders not fetched yet, so they can be expanded
+    return node->hasObjects() ? !node->m_Names.empty()
+                              : !node->m_Children.empty();
+}
 
-class DGLRenderbufferWidget : public QClickableTreeWidgetItem {
-public:
-    DGLRenderbufferWidget() {}
-    DGLRenderbufferWidget(QString iconPath) {
-            setIcon(0, QIcon(iconPath));
-    }
+QVariant DGLTreeModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid()) {
+        return QVariant();
+    }
+    Node* parentNode = static_cast<Node*>(index.internalPointer());
+    if (parentNode->hasObjects()) {
+        switch (role) {
+            case Qt::DisplayRole:
+                return getObjectText(parentNode, index.row());
+            case Qt::DecorationRole:
+                return parentNode->m_Icon;
+            case SortRole:
+                return (uint)parentNode->m_Names[index.row()].m_Name;
+            case ObjectRole:
+                return true;
+        }
+        return QVariant();
+    }
+
+    Node* node = parentNode->m_Children[index.row()];
+    switch (role) {
+        case Qt::DisplayRole:
+            return node->m_Text;
+        case Qt::DecorationRole:
+            return node->m_Icon;
+        case Qt::FontRole:
+            if (node->m_Bold) {
+                QFont fnt;
+                fnt.setBold(true);
+                return fnt;
+            }
+            break;
+        case SortRole:
+            // folders keep their order regardless of sort direction
+            return (uint)node->m_Row;
+        case ObjectRole:
+            return false;
+    }
+    return QVariant();
+}
 
-    virtual void setObjName(const dglnet::ContextObjectName& name) {
-        setText(0, QString("Renderbuffer ") + QString::number(name.m_Name));
-        QClickableTreeWidgetItem::setObjName(name);
+QVariant DGLTreeModel::headerData(int section, Qt::Orientation orientation,
+                                  int role) const {
+    if (section == 0 && orientation == Qt::Horizontal &&
+        role == Qt::DisplayRole) {
+        return m_Header;
     }
+    return QVariant();
+}
 
-    void handleDoubleClick(DglController* controller) {
-        controller->getViewRouter()->show(m_name,
-            dglnet::message::ObjectType::Renderbuffer);
-    }
-};
+bool DGLTreeModel::canFetchMore(const QModelIndex& parent) const {
+    Node* node = getNode(parent);
+    return node && node->hasObjects() &&
+           node->m_Fetched < (int)node->m_Names.size();
+}
 
-class DGLShaderWidget : public QClickableTreeWidgetItem {
-   public:
-    DGLShaderWidget() {}
-    DGLShaderWidget(QString iconPath) {
-        setIcon(0, QIcon(iconPath));
+void DGLTreeModel::fetchMore(const QModelIndex& parent) {
+    Node* node = getNode(parent);
+    if (!node || !node->hasObjects()) {
+        return;
     }
-
-    virtual void setObjName(const dglnet::ContextObjectName& name) {
-        setText(0, QString("Shader ") + QString::number(name.m_Name) +
-            QString::fromStdString(
-            " (" + GetShaderStageName(name.m_Target) +
-            ")"));
-        QClickableTreeWidgetItem::setObjName(name);
+    node->m_FetchLimit = std::max(node->m_FetchLimit, node->m_Fetched) + kFetchSize;
+    int count = std::min((int)node->m_Names.size(), node->m_FetchLimit);
+    if (count > node->m_Fetched) {
+        beginInsertRows(parent, node->m_Fetched, count - 1);
+        node->m_Fetched = count;
+        endInsertRows();
     }
+}
 
-    void handleDoubleClick(DglController* controller) {
-        controller->getViewRouter()->show(
-                m_name, dglnet::message::ObjectType::Shader);
+DGLTreeModel::Node* DGLTreeModel::getNode(const QModelIndex& index) const {
+    if (!index.isValid()) {
+        return m_Root;
     }
-};
-
-class DGLProgramWidget : public QClickableTreeWidgetItem {
-   public:
-    DGLProgramWidget() {}
-    DGLProgramWidget(QString iconPath) {
-        setIcon(0, QIcon(iconPath));
+    Node* parentNode = static_cast<Node*>(index.internalPointer());
+    if (parentNode->hasObjects()) {
+        return NULL;
     }
+    return parentNode->m_Children[index.row()];
+}
 
-    virtual void setObjName(const dglnet::ContextObjectName& name) {
-        setText(0, QString(" Shader Program ") + QString::number(name.m_Name));
-        QClickableTreeWidgetItem::setObjName(name);
+QModelIndex DGLTreeModel::getIndex(Node* node) const {
+    if (node == m_Root) {
+        return QModelIndex();
     }
+    return createIndex(node->m_Row, 0, node->m_Parent);
+}
 
-    void handleDoubleClick(DglController* controller) {
-        controller->getViewRouter()->show(
-                m_name, dglnet::message::ObjectType::Program);
-    }
-};
+DGLTreeModel::Node* DGLTreeModel::addFolder(Node* parent, const QString& text,
+                                            const QString& icon,
+                                            ObjectType type) {
+    Node* node = new Node(parent, text, icon, type);
+    parent->m_Children.push_back(node);
+    return node;
+}
 
-class DGLFramebufferWidget : public QClickableTreeWidgetItem {
-   public:
-    DGLFramebufferWidget() {}
-    DGLFramebufferWidget(QString iconPath) {
-        setIcon(0, QIcon(iconPath));
-    }
+void DGLTreeModel::updateContext(Node* node, const ContextReport& report,
+                                 bool current) {
+    QString text = QString("Context 0x") + QString::number(report.m_Id, 16) +
+                   (current ? QString(" (current)") : QString(""));
+    if (node->m_Text != text || node->m_Bold != current) {
+        node->m_Text = text;
+        node->m_Bold = current;
+        QModelIndex index = getIndex(node);
+        emit dataChanged(index, index);
+    }
+    updateNames(node->m_Children[kTextureFolder], report.m_TextureSpace);
+    updateNames(node->m_Children[kBufferFolder], report.m_BufferSpace);
+    updateNames(node->m_Children[kFBOFolder], report.m_FBOSpace);
+    updateNames(node->m_Children[kRenderbufferFolder],
+                report.m_RenderbufferSpace);
+    updateNames(node->m_Children[kShaderFolder], report.m_ShaderSpace);
+    updateNames(node->m_Children[kProgramFolder], report.m_ProgramSpace);
+    updateNames(node->m_Children[kFramebufferFolder],
+                report.m_FramebufferSpace);
+    updateUnits(node->m_Children[kTextureUnitFolder],
+                report.m_TextureUnitSpace);
+}
 
-    virtual void setObjName(const dglnet::ContextObjectName& name) {
-        QString strname = "unknown";
-        switch (name.m_Name) {
-            case GL_FRONT_RIGHT:
-                strname = "Front right buffer";
-                break;
-            case GL_BACK_RIGHT:
-                strname = "Back right buffer";
-                break;
-            case GL_FRONT:
-                strname = "Front buffer";
-                break;
-            case GL_BACK:
-                strname = "Back buffer";
-                break;
+void DGLTreeModel::updateUnits(
+        Node* node, const std::vector<std::set<ContextObjectName> >& units) {
+    int count = (int)node->m_Children.size();
+    if ((int)units.size() > count) {
+        beginInsertRows(getIndex(node), count, (int)units.size() - 1);
+        for (size_t i = count; i < units.size(); i++) {
+            addFolder(node, "Unit " + QString::number(i),
+                      DGL_RES_ICON_TEXTUREUNIT_PATH, ObjectType::Texture);
         }
-        setText(0, strname);
-        QClickableTreeWidgetItem::setObjName(name);
+        endInsertRows();
+    } else if ((int)units.size() < count) {
+        removeNodes(node, (int)units.size(), count - (int)units.size());
     }
-
-    void handleDoubleClick(DglController* controller) {
-        controller->getViewRouter()->show(
-                m_name, dglnet::message::ObjectType::Framebuffer);
+    for (size_t i = 0; i < units.size(); i++) {
+        updateNames(node->m_Children[i], units[i]);
     }
-};
+}
 
-template <typename ObjType>
-class DGLObjectNodeWidgetBase : public QTreeWidgetItem {
-   public:
-    DGLObjectNodeWidgetBase(opaque_id_t ctxId, QString header, QString iconPath)
-            : m_IconPath(iconPath), m_CtxId(ctxId) {
-        setHeader(header);
-        setIcon(0, QIcon(iconPath));
-    }
+void DGLTreeModel::updateNames(Node* node,
+                               const std::set<ContextObjectName>& names) {
+    std::vector<ContextObjectName>& current = node->m_Names;
 
-    void setHeader(QString header) {
-        setText(0, header);
+    // fast path: nothing changed, no model signals
+    if (current.size() == names.size()) {
+        bool same = true;
+        std::set<ContextObjectName>::const_iterator it = names.begin();
+        for (size_t i = 0; same && i < current.size(); i++, it++) {
+            same = current[i].exactlySameAs(*it);
+        }
+        if (same) {
+            return;
+        }
     }
-    
-   protected:
-    QString m_IconPath;
-    opaque_id_t m_CtxId;
-};
 
-template <typename ObjType>
-class DGLObjectNodeWidget : public DGLObjectNodeWidgetBase<ObjType> {
-public:
-    DGLObjectNodeWidget(opaque_id_t ctxId, QString header, QString iconPath)
-        : DGLObjectNodeWidgetBase<ObjType>(ctxId, header, iconPath) {}
-
-    template <typename T>
-    void update(const std::set<T>& names) {
-        typedef typename std::set<T>::iterator set_iter;
-
-        if (this->childCount() != (int)names.size()) {
-
-            //remove excessive childs
-            while (this->childCount() > (int)names.size()) {
-                this->removeChild(this->child(this->childCount() - 1));
+    // merge both sorted sequences, removing and inserting runs of rows
+    std::set<ContextObjectName>::const_iterator it = names.begin();
+    int pos = 0;
+    while (pos < (int)current.size() || it != names.end()) {
+        if (it == names.end() ||
+            (pos < (int)current.size() && current[pos] < *it)) {
+            int count = 1;
+            while (pos + count < (int)current.size() &&
+                   (it == names.end() || current[pos + count] < *it)) {
+                count++;
             }
-
-            //add missing children
-            while ((int)names.size() > this->childCount()) {
-                this->addChild(new ObjType(this->m_IconPath));
+            removeNames(node, pos, count);
+        } else if (pos == (int)current.size() || *it < current[pos]) {
+            std::vector<ContextObjectName> added;
+            while (it != names.end() &&
+                   (pos == (int)current.size() || *it < current[pos])) {
+                added.push_back(*it++);
             }
-        }
-
-        int childIdx = 0;
-        for (set_iter i = names.begin(); i != names.end(); i++) {
-            ObjType* typedChild = dynamic_cast<ObjType*>(this->child(childIdx));
-            DGL_ASSERT(typedChild);
-            if (typedChild) {
-                if (!i->exactlySameAs(typedChild->getObjName())) {
-                    typedChild->setObjName(*i);
+            insertNames(node, pos, added);
+            pos += (int)added.size();
+        } else {
+            // same object, but target may be known now
+            if (!current[pos].exactlySameAs(*it)) {
+                current[pos] = *it;
+                if (pos < node->m_Fetched) {
+                    QModelIndex index = createIndex(pos, 0, node);
+                    emit dataChanged(index, index);
                 }
             }
-            childIdx++;
+            pos++;
+            it++;
         }
     }
-};
-
-template <typename ObjType>
-class DGLIndexedObjectNodeWidget : public DGLObjectNodeWidgetBase<ObjType> {
-public:
-    DGLIndexedObjectNodeWidget(opaque_id_t ctxId, QString header, QString childHeader, QString iconPath)
-        : DGLObjectNodeWidgetBase<ObjType>(ctxId, header, iconPath), m_ChildHeader(childHeader) {}
-   
-     template<typename T>
-    void update(const std::vector<std::set<T> >& elements) {
 
-        if (elements.size() != m_Childs.size()) {
-            //resising a vector rellloc all pointers, 
-            //so delete & create all object once again
+    // expose objects that moved into range already requested by view
+    int count = std::min((int)current.size(), node->m_FetchLimit);
+    if (count > node->m_Fetched) {
+        beginInsertRows(getIndex(node), node->m_Fetched, count - 1);
+        node->m_Fetched = count;
+        endInsertRows();
+    }
+}
 
-            //this happend no more than once per ctx.
+void DGLTreeModel::insertNames(Node* node, int pos,
+                               const std::vector<ContextObjectName>& names) {
+    if (pos < node->m_Fetched) {
+        beginInsertRows(getIndex(node), pos, pos + (int)names.size() - 1);
+        node->m_Names.insert(node->m_Names.begin() + pos, names.begin(),
+                             names.end());
+        node->m_Fetched += (int)names.size();
+        endInsertRows();
+    } else {
+        // past exposed rows - view will not see it until fetched
+        node->m_Names.insert(node->m_Names.begin() + pos, names.begin(),
+                             names.end());
+    }
+}
 
-            for (size_t i = 0; i < m_Childs.size(); i++) {
-                this->removeChild(&m_Childs[i]);
-            }
+void DGLTreeModel::removeNames(Node* node, int pos, int count) {
+    if (pos < node->m_Fetched) {
+        int visible = std::min(count, node->m_Fetched - pos);
+        beginRemoveRows(getIndex(node), pos, pos + visible - 1);
+        node->m_Names.erase(node->m_Names.begin() + pos,
+                            node->m_Names.begin() + pos + count);
+        node->m_Fetched -= visible;
+        endRemoveRows();
+    } else {
+        node->m_Names.erase(node->m_Names.begin() + pos,
+                            node->m_Names.begin() + pos + count);
+    }
+}
 
-            m_Childs.resize(elements.size(), DGLObjectNodeWidget<ObjType>(0, "", ""));
+void DGLTreeModel::removeNodes(Node* node, int pos, int count) {
+    beginRemoveRows(getIndex(node), pos, pos + count - 1);
+    for (int i = pos; i < pos + count; i++) {
+        delete node->m_Children[i];
+    }
+    node->m_Children.erase(node->m_Children.begin() + pos,
+                           node->m_Children.begin() + pos + count);
+    for (size_t i = pos; i < node->m_Children.size(); i++) {
+        node->m_Children[i]->m_Row = (int)i;
+    }
+    endRemoveRows();
+}
 
-            for (size_t i = 0; i < m_Childs.size(); i++) {
-                m_Childs[i] = 
-                    DGLObjectNodeWidget<ObjType>(this->m_CtxId, m_ChildHeader + QString::number(i),
-                            this->m_IconPath);
-                this->addChild(&m_Childs[i]);
+QString DGLTreeModel::getObjectText(Node* node, int row) const {
+    const ContextObjectName& name = node->m_Names[row];
+    switch (node->m_Type) {
+        case ObjectType::Texture:
+            return QString("Texture ") + QString::number(name.m_Name) +
+                   QString::fromStdString(
+                           " (" + GetTextureTargetName(name.m_Target) + ")");
+        case ObjectType::Buffer:
+            return QString("Buffer ") + QString::number(name.m_Name);
+        case ObjectType::FBO:
+            return QString("FBO ") + QString::number(name.m_Name);
+        case ObjectType::Renderbuffer:
+            return QString("Renderbuffer ") + QString::number(name.m_Name);
+        case ObjectType::Shader:
+            return QString("Shader ") + QString::number(name.m_Name) +
+                   QString::fromStdString(
+                           " (" + GetShaderStageName(name.m_Target) + ")");
+        case ObjectType::Program:
+            return QString("Shader Program ") + QString::number(name.m_Name);
+        case ObjectType::Framebuffer:
+            switch (name.m_Name) {
+                case GL_FRONT_RIGHT:
+                    return "Front right buffer";
+                case GL_BACK_RIGHT:
+                    return "Back right buffer";
+                case GL_FRONT:
+                    return "Front buffer";
+                case GL_BACK:
+                    return "Back buffer";
             }
-        }
-
-        DGL_ASSERT(elements.size() == m_Childs.size());
-        
-        for (size_t i = 0; i < elements.size(); i++) {
-            m_Childs[i].update(elements[i]);
-        }
+            return "unknown";
+        default:
+            return QString();
     }
-   private:
-    std::vector<DGLObjectNodeWidget<ObjType> > m_Childs;
-    QString m_ChildHeader;
-};
-
-
-template <typename ObjType>
-class DGLAggregateObjectNodeWidget : public DGLObjectNodeWidgetBase<ObjType> {
-public:
-    DGLAggregateObjectNodeWidget(opaque_id_t ctxId, QString header, QString childHeader, QString iconPath)
-        : DGLObjectNodeWidgetBase<ObjType>(ctxId, header, iconPath), m_ChildHeader(childHeader) {}
-
-    template<typename T1, typename T2>
-    void update(const std::set<std::pair<T1, std::set<T2> > >& elements) {
-
-        if (elements.size() != m_Childs.size()) {
-            //resising a vector rellloc all pointers, 
-            //so delete & create all object once again
-
-            //this happend no more than once per ctx.
+}
 
-            for (size_t i = 0; i < m_Childs.size(); i++) {
-                this->removeChild(&m_Childs[i]);
-            }
+DGLTreeFilterModel::DGLTreeFilterModel(QObject* parent)
+        : QSortFilterProxyModel(parent) {
+    setSortRole(DGLTreeModel::SortRole);
+    setFilterCaseSensitivity(Qt::CaseInsensitive);
+    setDynamicSortFilter(true);
+}
 
-            m_Childs.resize(elements.size(), DGLObjectNodeWidget<ObjType>(this->m_CtxId, "", this->m_IconPath));
+bool DGLTreeFilterModel::filterAcceptsRow(
+        int sourceRow, const QModelIndex& sourceParent) const {
+    QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
+    if (!sourceModel()->data(index, DGLTreeModel::ObjectRole).toBool()) {
+        return true;
+    }
+    return QSortFilterProxyModel::filterAcceptsRow(sourceRow, sourceParent);
+}
 
-            for (size_t i = 0; i < m_Childs.size(); i++) {
-                this->addChild(&m_Childs[i]);
-            }
+DGLTreeView::DGLTreeView(QWidget* parrent, DglController* controller)
+        : QDockWidget(tr("State Tree"), parrent),
+          m_Model(this),
+          m_FilterModel(this),
+          m_TreeView(this),
+          m_controller(controller) {
+    setObjectName("DGLTreeView");
 
-        }
+    m_FilterModel.setSourceModel(&m_Model);
+    m_TreeView.setModel(&m_FilterModel);
+    // all rows have same height, so view does not have to query them all
+    m_TreeView.setUniformRowHeights(true);
+    m_TreeView.setSortingEnabled(true);
+    m_TreeView.sortByColumn(0, Qt::AscendingOrder);
 
-        DGL_ASSERT(elements.size() == m_Childs.size());
+    m_FilterEdit.setPlaceholderText(tr("Filter objects"));
 
-        int idx = 0;
-        for (typename std::set<std::pair<T1, std::set<T2> > >::iterator it = elements.begin(); it != elements.end(); it++) {
+    QWidget* widget = new QWidget(this);
+    QVBoxLayout* layout = new QVBoxLayout(widget);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(&m_FilterEdit);
+    layout->addWidget(&m_TreeView);
 
-            //it: pointer to (object name, set<objects>) pairs;
+    setConnected(false);
 
-            m_Childs[idx].setHeader(m_ChildHeader + QString::number(it->first.m_Name));
+    setWidget(widget);
+    // inbound
+    CONNASSERT(controller, SIGNAL(setConnected(bool)), this,
+               SLOT(setConnected(bool)));
+    CONNASSERT(controller, SIGNAL(debugeeInfo(const std::string&)), this,
+               SLOT(debugeeInfo(const std::string&)));
+    CONNASSERT(controller, SIGNAL(setBreaked(bool)), &m_TreeView,
+               SLOT(setEnabled(bool)));
+    CONNASSERT(controller,
+               SIGNAL(breakedWithStateReports(
+                       opaque_id_t,
+                       const std::vector<
+                               dglnet::message::utils::ContextReport>&)),
+               this,
+               SLOT(breakedWithStateReports(
+                       opaque_id_t,
+                       const std::vector<
+                               dglnet::message::utils::ContextReport>&)));
 
-            m_Childs[idx].update(it->second);
+    // internal
+    CONNASSERT(&m_TreeView, SIGNAL(doubleClicked(const QModelIndex&)), this,
+               SLOT(onDoubleClicked(const QModelIndex&)));
+    CONNASSERT(&m_FilterEdit, SIGNAL(textChanged(const QString&)), this,
+               SLOT(setFilter(const QString&)));
+}
 
-            idx++;
-        }
+DGLTreeView::~DGLTreeView() {}
 
-        for (size_t i = 0; i < elements.size(); i++) {
-            
-        }
+void DGLTreeView::setConnected(bool connected) {
+    m_Connected = connected;
+    if (!connected) {
+        m_Model.setHeader("");
+        m_Model.clear();
     }
-private:
-    std::vector<DGLObjectNodeWidget<ObjType> > m_Childs;
-    QString m_ChildHeader;
-};
-
-class DGLCtxTreeWidget : public QTreeWidgetItem {
-   public:
-    DGLCtxTreeWidget(opaque_id_t ctxId)
-            : m_Id(ctxId),
-              m_TextureNode(ctxId,         "Textures",             DGL_RES_ICON_TEXTURE_PATH),
-              m_BufferNode(ctxId,          "Vertex Buffers",       DGL_RES_ICON_BUFFER_PATH),
-              m_FBONode(ctxId,             "Framebuffer objects",  DGL_RES_ICON_FBO_PATH),
-              m_RenderbufferNode(ctxId,    "Renderbuffer objects", DGL_RES_ICON_RENDERBUFFER_PATH),
-              m_ShaderNode(ctxId,          "Shaders",              DGL_RES_ICON_SHADER_PATH),
-              m_ProgramNode(ctxId,         "Shader Programs",      DGL_RES_ICON_PROGRAM_PATH),
-              m_FramebufferNode(ctxId,     "Frame Buffers",        DGL_RES_ICON_FRAMEBUFFER_PATH),
-              m_TextureUnitNode(ctxId,     "Texture units",    "Unit ",             DGL_RES_ICON_TEXTUREUNIT_PATH),
-              m_ProgramPipelineNode(ctxId, "Pipeline objects", "Program Pipeline ", DGL_RES_ICON_PPO_PATH)  {
-        addChild(&m_TextureNode);
-        addChild(&m_BufferNode);
-        addChild(&m_FBONode);
-        addChild(&m_RenderbufferNode);
-        addChild(&m_ShaderNode);
-        addChild(&m_ProgramNode);
-        addChild(&m_TextureUnitNode);
-        addChild(&m_FramebufferNode);
-        //addChild(&m_ProgramPipelineNode);
-        setIcon(0, QIcon(":/icons/context.png"));
-    }
-    opaque_id_t getId() { return m_Id; }
-
-    void update(const dglnet::message::utils::ContextReport& report,
-                bool current) {
-        QFont fnt = font(0);
-        fnt.setBold(current);
-        setFont(0, fnt);
-        DGL_ASSERT(m_Id == report.m_Id);
-        setText(0, QString("Context 0x") + QString::number(report.m_Id, 16) +
-                           (current ? QString(" (current)") : QString("")));
-        m_TextureNode.update(report.m_TextureSpace);
-        m_BufferNode.update(report.m_BufferSpace);
-        m_FBONode.update(report.m_FBOSpace);
-        m_RenderbufferNode.update(report.m_RenderbufferSpace);
-        m_ShaderNode.update(report.m_ShaderSpace);
-        m_ProgramNode.update(report.m_ProgramSpace);
-        m_BufferNode.update(report.m_BufferSpace);
-        m_FramebufferNode.update(report.m_FramebufferSpace);
-        m_TextureUnitNode.update(report.m_TextureUnitSpace);
-        m_ProgramPipelineNode.update(report.m_ProgramPipelineSpace);
-    }
-
-   private:
-    opaque_id_t m_Id;
-    DGLObjectNodeWidget<DGLTextureWidget> m_TextureNode;
-    DGLObjectNodeWidget<DGLBufferWidget> m_BufferNode;
-    DGLObjectNodeWidget<DGLFBOWidget> m_FBONode;
-    DGLObjectNodeWidget<DGLRenderbufferWidget> m_RenderbufferNode;
-    DGLObjectNodeWidget<DGLShaderWidget> m_ShaderNode;
-    DGLObjectNodeWidget<DGLProgramWidget> m_ProgramNode;
-    DGLObjectNodeWidget<DGLFramebufferWidget> m_FramebufferNode;
-    DGLIndexedObjectNodeWidget<DGLTextureWidget> m_TextureUnitNode;
-    DGLAggregateObjectNodeWidget<DGLProgramWidget> m_ProgramPipelineNode;
-};
+}
 
 void DGLTreeView::breakedWithStateReports(
         opaque_id_t currentContextId,
         const std::vector<dglnet::message::utils::ContextReport>&
                 report) {
-    for (size_t i = 0; i < report.size(); i++) {
-        DGLCtxTreeWidget* treeWidget = 0;
-        for (int j = 0; j < m_TreeWidget.topLevelItemCount(); j++) {
-            DGLCtxTreeWidget* thisWidget = dynamic_cast<DGLCtxTreeWidget*>(
-                    m_TreeWidget.topLevelItem(j));
-            if (thisWidget && thisWidget->getId() == report[i].m_Id) {
-                treeWidget = thisWidget;
-                break;
-            }
-        }
-        if (!treeWidget) {
-            treeWidget = new DGLCtxTreeWidget(report[i].m_Id);
-            m_TreeWidget.addTopLevelItem(treeWidget);
-        }
-        treeWidget->update(report[i], report[i].m_Id == currentContextId);
-    }
+    m_Model.update(currentContextId, report);
+}
 
-    for (int j = 0; j < m_TreeWidget.topLevelItemCount(); j++) {
-        DGLCtxTreeWidget* thisWidget =
-                dynamic_cast<DGLCtxTreeWidget*>(m_TreeWidget.topLevelItem(j));
-        bool found = false;
-        for (size_t i = 0; i < report.size(); i++) {
-            if (thisWidget && thisWidget->getId() == report[i].m_Id) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            delete m_TreeWidget.takeTopLevelItem(j--);
-        }
+void DGLTreeView::onDoubleClicked(const QModelIndex& index) {
+    ContextObjectName name;
+    ObjectType type;
+    if (m_Model.getObject(m_FilterModel.mapToSource(index), name, type)) {
+        m_controller->getViewRouter()->show(name, type);
     }
 }
 
-void DGLTreeView::onDoubleClicked(QTreeWidgetItem* item, int) {
-    QClickableTreeWidgetItem* clickableItem =
-            dynamic_cast<QClickableTreeWidgetItem*>(item);
-    if (clickableItem) {
-        clickableItem->handleDoubleClick(m_controller);
-    }
+void DGLTreeView::setFilter(const QString& filter) {
+    m_FilterModel.setFilterFixedString(filter);
 }
 
 void DGLTreeView::debugeeInfo(const std::string& processName) {
-    m_TreeWidget.setHeaderLabel(processName.c_str());
+    m_Model.setHeader(processName.c_str());
 }
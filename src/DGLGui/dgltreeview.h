@@ -18,21 +18,131 @@
 
 #include "dglqtgui.h"
 #include <QDockWidget>
+#include <QAbstractItemModel>
+#include <QSortFilterProxyModel>
 
 #include "DGLCommon//gl-types.h"
 
 #include "dglcontroller.h"
 
+#include <set>
+#include <vector>
+
 class DGLTreeView;
 
-class QClickableTreeWidgetItem : public QTreeWidgetItem {
-public:
-    const dglnet::ContextObjectName& getObjName();
-    virtual void setObjName(const dglnet::ContextObjectName& name);
-    virtual void handleDoubleClick(DglController*);
+/**
+ * Model of per-context GL object tree.
+ *
+ * Each break replaces the whole object report, so the model keeps sorted copy
+ * of every namespace and applies only difference of two reports: rows are
+ * inserted and removed in runs, untouched folders do not emit any signals.
+ * Objects are not stored as separate nodes - object row is an index into
+ * folder's name array, formatted on demand. Large folders expose their objects
+ * in chunks, when the view asks for them (canFetchMore()/fetchMore()).
+ */
+class DGLTreeModel : public QAbstractItemModel {
+   public:
+    /**
+     * Data roles provided by model
+     */
+    enum Role {
+        SortRole = Qt::UserRole,           // object name, or folder position
+        ObjectRole = Qt::UserRole + 1      // true for object rows
+    };
+
+    DGLTreeModel(QObject* parent);
+    ~DGLTreeModel();
+
+    /**
+     * Remove all contexts
+     */
+    void clear();
+
+    /**
+     * Set text displayed in header
+     */
+    void setHeader(const QString& header);
+
+    /**
+     * Apply new state reports of all contexts
+     */
+    void update(opaque_id_t currentContextId,
+                const std::vector<dglnet::message::utils::ContextReport>&);
+
+    /**
+     * Get object displayed in given row. Returns false, if index does not
+     * point to an object (context, folder).
+     */
+    bool getObject(const QModelIndex& index, dglnet::ContextObjectName& name,
+                   dglnet::message::ObjectType& type) const;
+
+    virtual QModelIndex index(int row, int column,
+                              const QModelIndex& parent = QModelIndex()) const;
+    virtual QModelIndex parent(const QModelIndex& index) const;
+    virtual int rowCount(const QModelIndex& parent = QModelIndex()) const;
+    virtual int columnCount(const QModelIndex& parent = QModelIndex()) const;
+    virtual bool hasChildren(const QModelIndex& parent = QModelIndex()) const;
+    virtual QVariant data(const QModelIndex& index,
+                          int role = Qt::DisplayRole) const;
+    virtual QVariant headerData(int section, Qt::Orientation orientation,
+                                int role = Qt::DisplayRole) const;
+    virtual bool canFetchMore(const QModelIndex& parent) const;
+    virtual void fetchMore(const QModelIndex& parent);
+
+    /**
+     * Number of objects exposed to the view by one fetchMore() call
+     */
+    static const int kFetchSize;
+
+   private:
+    struct Node;
+
+    /**
+     * Get node displayed at index, or NULL if index points to an object row.
+     * Invalid index refers to root node.
+     */
+    Node* getNode(const QModelIndex& index) const;
+
+    QModelIndex getIndex(Node* node) const;
 
-protected:
-    dglnet::ContextObjectName m_name;
+    Node* addFolder(Node* parent, const QString& text, const QString& icon,
+                    dglnet::message::ObjectType type);
+
+    void updateContext(Node* node,
+                       const dglnet::message::utils::ContextReport& report,
+                       bool current);
+
+    void updateUnits(
+            Node* node,
+            const std::vector<std::set<dglnet::ContextObjectName> >& units);
+
+    void updateNames(Node* node,
+                     const std::set<dglnet::ContextObjectName>& names);
+
+    void insertNames(Node* node, int pos,
+                     const std::vector<dglnet::ContextObjectName>& names);
+
+    void removeNames(Node* node, int pos, int count);
+
+    void removeNodes(Node* node, int pos, int count);
+
+    QString getObjectText(Node* node, int row) const;
+
+    Node* m_Root;
+    QString m_Header;
+};
+
+/**
+ * Sort & filter proxy of DGLTreeModel. Filter applies to object rows only,
+ * contexts and folders are always shown.
+ */
+class DGLTreeFilterModel : public QSortFilterProxyModel {
+   public:
+    DGLTreeFilterModel(QObject* parent);
+
+   protected:
+    virtual bool filterAcceptsRow(int sourceRow,
+                                  const QModelIndex& sourceParent) const;
 };
 
 class DGLTreeView : public QDockWidget {
@@ -42,8 +152,6 @@ class DGLTreeView : public QDockWidget {
     DGLTreeView(QWidget* parrent, DglController* controller);
     ~DGLTreeView();
 
-    void regiSterItem(QTreeWidgetItem item);
-
    public
 slots:
     void setConnected(bool);
@@ -52,10 +160,14 @@ slots:
             opaque_id_t currentContextId,
             const std::vector<dglnet::message::utils::ContextReport>&);
 
-    void onDoubleClicked(QTreeWidgetItem*, int);
+    void onDoubleClicked(const QModelIndex&);
+    void setFilter(const QString&);
 
    private:
-    QTreeWidget m_TreeWidget;
+    DGLTreeModel m_Model;
+    DGLTreeFilterModel m_FilterModel;
+    QLineEdit m_FilterEdit;
+    QTreeView m_TreeView;
     bool m_Connected;
     DglController* m_controller;
 };
@@ -76,6 +76,12 @@ class ClientImpl : public Client {
 
     virtual void notifyEndSend() override { m_controller->onSocketStopSend(); }
 
+    virtual void onMessage(Message* msg) override {
+        if (!m_controller->onMessage(msg)) {
+            Transport::onMessage(msg);
+        }
+    }
+
     std::shared_ptr<ClientImpl> shared_from_this() {
         return std::static_pointer_cast<ClientImpl>(get_shared_from_base());
     }
@@ -26,6 +26,11 @@ class IController {
     virtual void onSocketStartSend() = 0;
     virtual void onSocketStopSend() = 0;
 
+    // called with each received message on thread running the client. Return
+    // true to take ownership of the message, false to let client's
+    // MessageHandler handle it immediately.
+    virtual bool onMessage(Message*) { return false; }
+
     virtual ~IController() {}
 };
 
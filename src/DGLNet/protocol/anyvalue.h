@@ -42,6 +42,8 @@ class PtrWrap {
 
     intptr_t getVal() const { return static_cast<intptr_t>(m_value); }
 
+    bool operator==(const PtrWrap& rhs) const { return m_value == rhs.m_value; }
+
    private:
     pointer_store_t m_value;
 };
@@ -82,6 +84,12 @@ class AnyValue {
     }
 
    void writeToSS(std::ostringstream& out, const GLParamTypeMetadata& paramMetadata) const;
+
+    /**
+     * Values are equal only if both type and value match
+     */
+    bool operator==(const AnyValue& rhs) const { return m_value == rhs.m_value; }
+    bool operator!=(const AnyValue& rhs) const { return !(*this == rhs); }
    
    private:
     boost::variant<signed long long, unsigned long long, signed long,
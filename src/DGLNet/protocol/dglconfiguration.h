@@ -23,12 +23,18 @@ class DGLConfiguration {
               m_BreakOnDebugOutput(true),
               m_BreakOnCompilerError(true),
               m_ForceDebugContext(true),
-              m_ForceDebugContextES(false) {}
+              m_ForceDebugContextES(false),
+              m_ValidateShadowState(false),
+              m_PushBoundResources(false) {}
     bool m_BreakOnGLError;
     bool m_BreakOnDebugOutput;
     bool m_BreakOnCompilerError;
     bool m_ForceDebugContext;
     bool m_ForceDebugContextES;
+    // cross-check shadowed GL state with driver on each state query (testing)
+    bool m_ValidateShadowState;
+    // send resources of currently bound objects together with each break
+    bool m_PushBoundResources;
 };
 
 #endif
\ No newline at end of file
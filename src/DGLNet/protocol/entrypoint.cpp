@@ -78,6 +78,17 @@ public:
     }
 };
 
+namespace {
+void writeEnumName(std::ostringstream& out, gl_t value, GLEnumGroup group) {
+    const char* name = FindGLEnumName(value, group);
+    if (name) {
+        out << name;
+    } else {
+        out << "0x" << std::hex << value << std::dec;
+    }
+}
+}
+
 void AnyValue::writeToSS(std::ostringstream& out, const GLParamTypeMetadata& paramMetadata) const {
     if (paramMetadata.m_BaseType == GLParamTypeMetadata::BaseType::Value) {
         
@@ -85,7 +96,7 @@ void AnyValue::writeToSS(std::ostringstream& out, const GLParamTypeMetadata& par
 
     } else if (paramMetadata.m_BaseType == GLParamTypeMetadata::BaseType::Enum) {
         
-        out << GetGLEnumName(
+        writeEnumName(out,
             boost::apply_visitor(AnyValueCaster<gl_t>(), m_value),
             paramMetadata.m_EnumGroup);
 
@@ -101,7 +112,7 @@ void AnyValue::writeToSS(std::ostringstream& out, const GLParamTypeMetadata& par
                 } else {
                     first = false;
                 }
-                out << GetGLEnumName(j & bitfield, paramMetadata.m_EnumGroup);
+                writeEnumName(out, j & bitfield, paramMetadata.m_EnumGroup);
             }
             j *= 2;
         }
@@ -41,6 +41,8 @@ namespace message {
 
     class SetBreakPoints;
 
+    class PushedResource;
+
     namespace utils {
         class ContextReport;
         class ReplyBase;
@@ -52,6 +54,8 @@ class DGLResource;
 namespace resource {
 
     class DGLPixelRectangle;
+    class DGLResourceState;
+    class DGLResourceCallTraceSearch;
 
     namespace utils {
         class StateItem;
@@ -67,6 +67,8 @@ class Configuration : public Message {
         ar& m_config.m_BreakOnCompilerError;
         ar& m_config.m_ForceDebugContext;
         ar& m_config.m_ForceDebugContextES;
+        ar& m_config.m_ValidateShadowState;
+        ar& m_config.m_PushBoundResources;
     }
 
     Configuration() {}
@@ -77,6 +79,29 @@ class Configuration : public Message {
     virtual void handle(MessageHandler* h) const;
 };
 
+/**
+ * Resource sent by debugee without being requested, as it would be a reply to
+ * request::QueryResource(m_Type, m_ObjectName).
+ */
+class PushedResource {
+   public:
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& m_Type;
+        ar& m_ObjectName;
+        ar& m_Resource;
+    }
+
+    PushedResource() : m_Type(ObjectType::Invalid) {}
+    PushedResource(ObjectType type, ContextObjectName name,
+                   std::shared_ptr<utils::ReplyBase> resource)
+            : m_Type(type), m_ObjectName(name), m_Resource(resource) {}
+
+    ObjectType m_Type;
+    ContextObjectName m_ObjectName;
+    std::shared_ptr<utils::ReplyBase> m_Resource;
+};
+
 class BreakedCall : public Message {
    public:
     template <class Archive>
@@ -86,6 +111,7 @@ class BreakedCall : public Message {
         ar& m_TraceSize;
         ar& m_CtxReports;
         ar& m_CurrentCtx;
+        ar& m_PushedResources;
     }
 
     BreakedCall(CalledEntryPoint entryp, value_t traceSize,
@@ -101,6 +127,10 @@ class BreakedCall : public Message {
     value_t m_TraceSize;
     std::vector<utils::ContextReport> m_CtxReports;
     opaque_id_t m_CurrentCtx;
+
+    // resources of objects bound at break, sent only if
+    // DGLConfiguration::m_PushBoundResources is set
+    std::vector<PushedResource> m_PushedResources;
    private:
     virtual void handle(MessageHandler* h) const;
 };
@@ -446,33 +446,90 @@ struct GLInternalFormat g_InternalFormats[] = {
         {GL_STENCIL_INDEX8, GL_STENCIL_INDEX, GL_UNSIGNED_BYTE, 0}
  };
 
-const GLInternalFormat* GLFormats::getInternalFormat(gl_t internalFormat) {
-    for (size_t i = 0;
-         i < DGL_ARRAY_LENGTH(g_InternalFormats); i++) {
-        if (g_InternalFormats[i].internalFormat == internalFormat) {
-            return &g_InternalFormats[i];
+namespace {
+
+/**
+ * Dense index over enum keys of a format table.
+ *
+ * Maps (key - min key) to position of first table entry with this key, so
+ * lookups are a range check and one array access. Format enums span about
+ * 30k values, so the index takes ~30kB per table.
+ */
+template <typename T, gl_t T::*Key>
+class DenseFormatIndex {
+   public:
+    template <size_t Size>
+    DenseFormatIndex(T (&table)[Size])
+            : m_Table(table), m_MinKey(table[0].*Key) {
+        static_assert(Size < kNoEntry, "format table too big for index");
+        gl_t maxKey = m_MinKey;
+        for (size_t i = 0; i < Size; i++) {
+            m_MinKey = MIN(m_MinKey, table[i].*Key);
+            maxKey = MAX(maxKey, table[i].*Key);
+        }
+        m_Index.resize(static_cast<size_t>(maxKey - m_MinKey) + 1, kNoEntry);
+        // walk backwards, so first entry of duplicated keys wins.
+        for (size_t i = Size; i-- > 0;) {
+            m_Index[static_cast<size_t>(table[i].*Key - m_MinKey)] =
+                    static_cast<uint8_t>(i);
         }
     }
-    return NULL;
-}
 
-const GLDataFormat* GLFormats::getDataFormat(gl_t dataFormat) {
-    for (size_t i = 0; i < DGL_ARRAY_LENGTH(g_DataFormats);
-         i++) {
-        if (g_DataFormats[i].format == dataFormat) {
-            return &g_DataFormats[i];
+    const T* find(gl_t key) const {
+        if (key < m_MinKey || key - m_MinKey >= m_Index.size()) {
+            return NULL;
+        }
+        uint8_t i = m_Index[static_cast<size_t>(key - m_MinKey)];
+        if (i == kNoEntry) {
+            return NULL;
         }
+        return &m_Table[i];
     }
-    return NULL;
+
+   private:
+    static const uint8_t kNoEntry = 0xff;
+    const T* m_Table;
+    gl_t m_MinKey;
+    std::vector<uint8_t> m_Index;
+};
+
+template <typename T, gl_t T::*Key>
+const uint8_t DenseFormatIndex<T, Key>::kNoEntry;
+
+}    // namespace
+
+const GLInternalFormat* GLFormats::getInternalFormat(gl_t internalFormat) {
+    static const DenseFormatIndex<GLInternalFormat,
+                                  &GLInternalFormat::internalFormat>
+            index(g_InternalFormats);
+    return index.find(internalFormat);
+}
+
+const GLDataFormat* GLFormats::getDataFormat(gl_t dataFormat) {
+    static const DenseFormatIndex<GLDataFormat, &GLDataFormat::format> index(
+            g_DataFormats);
+    return index.find(dataFormat);
 }
 
 const GLDataType* GLFormats::getDataType(gl_t dataType) {
-    for (size_t i = 0; i < DGL_ARRAY_LENGTH(g_DataTypes); i++) {
-        if (g_DataTypes[i].type == dataType) {
-            return &g_DataTypes[i];
-        }
-    }
-    return NULL;
+    static const DenseFormatIndex<GLDataType, &GLDataType::type> index(
+            g_DataTypes);
+    return index.find(dataType);
+}
+
+const GLInternalFormat* GLFormats::getInternalFormats(size_t& count) {
+    count = DGL_ARRAY_LENGTH(g_InternalFormats);
+    return g_InternalFormats;
+}
+
+const GLDataFormat* GLFormats::getDataFormats(size_t& count) {
+    count = DGL_ARRAY_LENGTH(g_DataFormats);
+    return g_DataFormats;
+}
+
+const GLDataType* GLFormats::getDataTypes(size_t& count) {
+    count = DGL_ARRAY_LENGTH(g_DataTypes);
+    return g_DataTypes;
 }
 
 const GLInternalFormat* GLFormats::adjustInternalFormatFromTypeES(gl_t internalFormat, gl_t type) {
@@ -55,6 +55,14 @@ class GLFormats {
     static const GLDataFormat* getDataFormat(gl_t dataFormat);
     static const GLDataType* getDataType(gl_t dataType);
 
+    /**
+     * Format tables, in lookup order: getters above return the first entry
+     * matching requested enum.
+     */
+    static const GLInternalFormat* getInternalFormats(size_t& count);
+    static const GLDataFormat* getDataFormats(size_t& count);
+    static const GLDataType* getDataTypes(size_t& count);
+
     static gl_t getBestColorRenderableFormatES(gl_t internalFormat, gl_t type,
                                           int ctxMajor);
     static const GLInternalFormat* adjustInternalFormatFromTypeES(
@@ -15,6 +15,9 @@
 
 #include "request.h"
 
+#include <cstdlib>
+#include <sstream>
+
 namespace dglnet {
 namespace request {
 
@@ -28,5 +31,63 @@ EditShaderSource::EditShaderSource(opaque_id_t context, gl_t shaderId,
 ForceLinkProgram::ForceLinkProgram(opaque_id_t context, gl_t programId)
         : m_Context(context), m_ProgramId(programId) {}
 
+namespace {
+bool toNumber(const std::string& str, double& ret) {
+    if (str.empty()) {
+        return false;
+    }
+    char* end;
+    ret = strtod(str.c_str(), &end);
+    return *end == '\0';
+}
+}    // namespace
+
+SearchCallTrace::SearchCallTrace()
+        : m_GLErrorOnly(false),
+          m_DebugOutputOnly(false),
+          m_StartOffset(0),
+          m_Backward(true),
+          m_MaxResults(0),
+          m_WithCalls(false) {}
+
+bool SearchCallTrace::matches(const CalledEntryPoint& call) const {
+    if (m_Entrypoints.size() &&
+        m_Entrypoints.find(call.getEntrypoint()) == m_Entrypoints.end()) {
+        return false;
+    }
+    if (m_GLErrorOnly && call.getError() == GL_NO_ERROR) {
+        return false;
+    }
+    if (m_DebugOutputOnly && call.getDebugOutput().empty()) {
+        return false;
+    }
+
+    const std::vector<AnyValue>& args = call.getArgs();
+    for (size_t i = 0; i < m_ArgFilters.size(); i++) {
+        const ArgFilter& filter = m_ArgFilters[i];
+        if (filter.m_Index < 0 ||
+            static_cast<size_t>(filter.m_Index) >= args.size()) {
+            return false;
+        }
+
+        // format same way as CalledEntryPoint::toString()
+        std::ostringstream arg;
+        arg << std::showpoint;
+        args[filter.m_Index].writeToSS(
+                arg, GetEntryPointGLParamTypeMetadata(call.getEntrypoint(),
+                                                      filter.m_Index));
+        if (arg.str() == filter.m_Value) {
+            continue;
+        }
+        double argNumber, filterNumber;
+        if (!toNumber(arg.str(), argNumber) ||
+            !toNumber(filter.m_Value, filterNumber) ||
+            argNumber != filterNumber) {
+            return false;
+        }
+    }
+    return true;
+}
+
 }    // namespace resource
 }    // namespace dglnet
@@ -15,8 +15,11 @@
 
 #include <DGLNet/protocol/ctxobjname.h>
 #include <DGLNet/protocol/msgutils.h>
+#include <DGLNet/protocol/entrypoint.h>
 #include <boost/serialization/base_object.hpp>
 
+#include <set>
+
 #ifndef REQUEST_H
 #define REQUEST_H
 
@@ -38,13 +41,22 @@ class QueryResource : public DGLRequest {
         ar& boost::serialization::base_object<DGLRequest>(*this);
         ar& m_Type;
         ar& m_ObjectName;
+        ar& m_BaseSnapshotId;
     }
 
-    QueryResource() : m_Type(message::ObjectType::Invalid) {}
-    QueryResource(message::ObjectType type, ContextObjectName name)
-            : m_Type(type), m_ObjectName(name) {}
+    QueryResource()
+            : m_Type(message::ObjectType::Invalid), m_BaseSnapshotId(0) {}
+    QueryResource(message::ObjectType type, ContextObjectName name,
+                  opaque_id_t baseSnapshotId = 0)
+            : m_Type(type),
+              m_ObjectName(name),
+              m_BaseSnapshotId(baseSnapshotId) {}
     message::ObjectType m_Type;
     ContextObjectName m_ObjectName;
+
+    // State queries only: id of state snapshot held by client (0 if none).
+    // Reply is a delta against it, if wrapper still has this snapshot.
+    opaque_id_t m_BaseSnapshotId;
 };
 
 class EditShaderSource : public DGLRequest {
@@ -100,6 +112,85 @@ public:
     value_t m_Size;
 };
 
+/**
+ * Search call history of debugee for calls matching all given criteria.
+ *
+ * Calls are identified by offsets counted backwards from the last call in
+ * history (as in message::QueryCallTrace). Search starts at m_StartOffset and
+ * goes towards older (m_Backward) or newer calls, until m_MaxResults matches
+ * are found, so large histories can be searched in pages.
+ */
+class SearchCallTrace : public DGLRequest {
+   public:
+    /**
+     * Argument criterion: argument at m_Index, formatted as in call trace,
+     * must be equal to m_Value. Numbers are compared by value.
+     */
+    struct ArgFilter {
+        template <class Archive>
+        void serialize(Archive& ar, const unsigned int) {
+            ar& m_Index;
+            ar& m_Value;
+        }
+
+        ArgFilter() : m_Index(0) {}
+        ArgFilter(value_t index, const std::string& value)
+                : m_Index(index), m_Value(value) {}
+
+        value_t m_Index;
+        std::string m_Value;
+    };
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& boost::serialization::base_object<DGLRequest>(*this);
+        ar& m_Entrypoints;
+        ar& m_ArgFilters;
+        ar& m_GLErrorOnly;
+        ar& m_DebugOutputOnly;
+        ar& m_StartOffset;
+        ar& m_Backward;
+        ar& m_MaxResults;
+        ar& m_WithCalls;
+    }
+
+    SearchCallTrace();
+
+    /**
+     * Check if call matches search criteria
+     */
+    bool matches(const CalledEntryPoint& call) const;
+
+    /**
+     * Searched entrypoints, empty set matches any
+     */
+    std::set<Entrypoint> m_Entrypoints;
+    std::vector<ArgFilter> m_ArgFilters;
+
+    /**
+     * Match only calls that generated GL error
+     */
+    bool m_GLErrorOnly;
+
+    /**
+     * Match only calls that generated debug output
+     */
+    bool m_DebugOutputOnly;
+
+    value_t m_StartOffset;
+    bool m_Backward;
+
+    /**
+     * Maximum number of results in reply, 0 for no limit
+     */
+    value_t m_MaxResults;
+
+    /**
+     * Send matching calls in reply, not only their offsets
+     */
+    bool m_WithCalls;
+};
+
 }    // namespace request
 }    // namespace dglnet
 
@@ -108,6 +199,7 @@ REGISTER_CLASS(dglnet::request::QueryResource,     drQR)
 REGISTER_CLASS(dglnet::request::EditShaderSource,  drESS)
 REGISTER_CLASS(dglnet::request::ForceLinkProgram,  drFLP)
 REGISTER_CLASS(dglnet::request::RequestBenchmarkBuffer,  drBB)
+REGISTER_CLASS(dglnet::request::SearchCallTrace,   drSCT)
 #endif
 
 #endif    // REQUEST_H
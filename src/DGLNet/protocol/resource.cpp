@@ -16,6 +16,7 @@
 
 #include "resource.h"
 #include <cstring>
+#include <stdexcept>
 
 
 
@@ -88,5 +89,101 @@ void* DGLPixelRectangle::getPtr() const { return m_Storage; }
 
 size_t DGLPixelRectangle::getSize() const { return static_cast<size_t>(m_Height * m_RowBytes); }
 
+namespace {
+size_t getPixelRectangleSize(
+        const std::shared_ptr<DGLPixelRectangle>& pixelRectangle) {
+    return (pixelRectangle && pixelRectangle->getPtr())
+                   ? pixelRectangle->getSize()
+                   : 0;
+}
+}
+
+size_t DGLResourceTexture::getDataSize() const {
+    size_t size = 0;
+    for (size_t i = 0; i < m_FacesLevelsLayers.size(); i++) {
+        for (size_t j = 0; j < m_FacesLevelsLayers[i].size(); j++) {
+            for (size_t k = 0; k < m_FacesLevelsLayers[i][j].size(); k++) {
+                size += getPixelRectangleSize(
+                        m_FacesLevelsLayers[i][j][k].m_PixelRectangle);
+            }
+        }
+    }
+    return size;
+}
+
+size_t DGLResourceBuffer::getDataSize() const { return m_Data.size(); }
+
+size_t DGLResourceFramebuffer::getDataSize() const {
+    return getPixelRectangleSize(m_PixelRectangle);
+}
+
+size_t DGLResourceFBO::getDataSize() const {
+    size_t size = 0;
+    for (size_t i = 0; i < m_Attachments.size(); i++) {
+        size += getPixelRectangleSize(m_Attachments[i].m_PixelRectangle);
+    }
+    return size;
+}
+
+size_t DGLResourceRenderbuffer::getDataSize() const {
+    return getPixelRectangleSize(m_PixelRectangle);
+}
+
+bool utils::StateItem::operator==(const StateItem& rhs) const {
+    return m_Name == rhs.m_Name && m_Values == rhs.m_Values;
+}
+
+DGLResourceState::DGLResourceState() : m_SnapshotId(0), m_BaseSnapshotId(0) {}
+
+void DGLResourceState::makeDelta(
+        opaque_id_t baseId, const std::vector<utils::StateItem>& baseItems) {
+    if (m_BaseSnapshotId || !baseId || baseItems.size() != m_Items.size()) {
+        return;
+    }
+
+    std::vector<utils::StateItem> changed;
+    std::vector<uint32_t> indices;
+    for (size_t i = 0; i < m_Items.size(); i++) {
+        if (!(m_Items[i] == baseItems[i])) {
+            changed.push_back(m_Items[i]);
+            indices.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    m_Items.swap(changed);
+    m_Indices.swap(indices);
+    m_BaseSnapshotId = baseId;
+}
+
+std::vector<size_t> DGLResourceState::apply(
+        opaque_id_t itemsId, std::vector<utils::StateItem>& items) const {
+    std::vector<size_t> changed;
+    if (!m_BaseSnapshotId) {
+        // full snapshot: changes are known only if item lists are compatible
+        if (itemsId && items.size() == m_Items.size()) {
+            for (size_t i = 0; i < m_Items.size(); i++) {
+                if (!(m_Items[i] == items[i])) {
+                    changed.push_back(i);
+                }
+            }
+        }
+        items = m_Items;
+        return changed;
+    }
+
+    if (itemsId != m_BaseSnapshotId || m_Indices.size() != m_Items.size()) {
+        throw std::runtime_error("State delta does not match current snapshot");
+    }
+    for (size_t i = 0; i < m_Indices.size(); i++) {
+        if (m_Indices[i] >= items.size()) {
+            throw std::runtime_error("State delta does not match current snapshot");
+        }
+    }
+    for (size_t i = 0; i < m_Indices.size(); i++) {
+        items[m_Indices[i]] = m_Items[i];
+        changed.push_back(m_Indices[i]);
+    }
+    return changed;
+}
+
 }    // namespace resource
 }    // namespace dglnet
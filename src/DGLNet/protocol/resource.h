@@ -20,6 +20,7 @@
 
 #include <DGLNet/protocol/msgutils.h>
 #include <DGLNet/protocol/anyvalue.h>
+#include <DGLNet/protocol/entrypoint.h>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/binary_object.hpp>
 
@@ -34,6 +35,11 @@ class DGLResource : public message::utils::ReplyBase {
     }
 
     virtual ~DGLResource() {}
+
+    /**
+     * Size of bulk data (pixels, buffer contents) held by resource
+     */
+    virtual size_t getDataSize() const { return 0; }
 };
 
 class DGLBenchmarkBuffer : public message::utils::ReplyBase {
@@ -145,6 +151,8 @@ class DGLResourceTexture : public DGLResource {
     std::vector<std::vector<std::vector<TextureLayer> > > m_FacesLevelsLayers;
 
     gl_t m_Target;
+
+    virtual size_t getDataSize() const override;
 };
 
 class DGLResourceBuffer : public DGLResource {
@@ -156,6 +164,8 @@ class DGLResourceBuffer : public DGLResource {
     }
 
     std::vector<char> m_Data;
+
+    virtual size_t getDataSize() const override;
 };
 
 class DGLResourceFramebuffer : public DGLResource {
@@ -167,6 +177,8 @@ class DGLResourceFramebuffer : public DGLResource {
     }
 
     std::shared_ptr<dglnet::resource::DGLPixelRectangle> m_PixelRectangle;
+
+    virtual size_t getDataSize() const override;
 };
 
 class DGLResourceFBO : public DGLResource {
@@ -211,6 +223,8 @@ class DGLResourceFBO : public DGLResource {
 
     std::vector<FBOAttachment> m_Attachments;
     gl_t                       m_CompletenessStatus;
+
+    virtual size_t getDataSize() const override;
 };
 
 class DGLResourceRenderbuffer : public DGLResource {
@@ -229,6 +243,7 @@ public:
     gl_t m_Internalformat;
     value_t m_Samples;
 
+    virtual size_t getDataSize() const override;
 };
 
 class DGLResourceShader : public DGLResource {
@@ -335,6 +350,43 @@ public:
     std::vector<std::string> m_trace;
 };
 
+/**
+ * Result of request::SearchCallTrace
+ */
+class DGLResourceCallTraceSearch : public DGLResource {
+public:
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& ::boost::serialization::base_object<DGLResource>(*this);
+        ar& m_Offsets;
+        ar& m_Calls;
+        ar& m_NextOffset;
+        ar& m_Complete;
+    }
+
+    DGLResourceCallTraceSearch() : m_NextOffset(0), m_Complete(true) {}
+
+    /**
+     * Offsets of matching calls, in search order
+     */
+    std::vector<value_t> m_Offsets;
+
+    /**
+     * Matching calls, if requested
+     */
+    std::vector<CalledEntryPoint> m_Calls;
+
+    /**
+     * Offset to continue search from, if m_Complete is false
+     */
+    value_t m_NextOffset;
+
+    /**
+     * True if whole history was searched
+     */
+    bool m_Complete;
+};
+
 namespace utils {
     class StateItem {
        public:
@@ -343,20 +395,55 @@ namespace utils {
             ar& m_Name;
             ar& m_Values;
         }
+        bool operator==(const StateItem& rhs) const;
+
         std::string m_Name;
         std::vector<AnyValue> m_Values;
     };
 }
 
+/**
+ * GL state snapshot.
+ *
+ * Each snapshot has an unique id. If m_BaseSnapshotId is nonzero, the resource
+ * is a delta: m_Items hold only items changed since the base snapshot, and
+ * m_Indices their positions in the full item list.
+ */
 class DGLResourceState : public DGLResource {
    public:
+    DGLResourceState();
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
         ar& ::boost::serialization::base_object<DGLResource>(*this);
+        ar& m_SnapshotId;
+        ar& m_BaseSnapshotId;
         ar& m_Items;
+        ar& m_Indices;
     }
+
+    /**
+     * Turn full snapshot into delta against base snapshot holding baseItems.
+     *
+     * Snapshot stays full, if item lists are not compatible.
+     */
+    void makeDelta(opaque_id_t baseId,
+                   const std::vector<utils::StateItem>& baseItems);
+
+    /**
+     * Apply this snapshot (full or delta) on items, return indices of changed
+     * items.
+     *
+     * Throws, if delta does not match the base snapshot.
+     */
+    std::vector<size_t> apply(opaque_id_t itemsId,
+                              std::vector<utils::StateItem>& items) const;
+
    public:
+    opaque_id_t m_SnapshotId;
+    opaque_id_t m_BaseSnapshotId;
     std::vector<utils::StateItem> m_Items;
+    std::vector<uint32_t> m_Indices;
 };
 
 }    // namespace resource
@@ -407,6 +494,7 @@ REGISTER_CLASS(dglnet::resource::DGLResourceProgram,      dsRP)
 REGISTER_CLASS(dglnet::resource::DGLResourceGPU,          dsRGPU)
 REGISTER_CLASS(dglnet::resource::DGLResourceState,        dsRS)
 REGISTER_CLASS(dglnet::resource::DGLResourceBacktrace,    dsRBT)
+REGISTER_CLASS(dglnet::resource::DGLResourceCallTraceSearch, dsRCTS)
 #endif
 
 #endif    // RESOURCE_H
@@ -120,6 +120,14 @@ void Server<proto>::onAccept(const boost::system::error_code& ec) {
     }
 }
 
+template <class proto>
+void Server<proto>::closeDescriptors() {
+    // cancels pending accept, if parent was still listening
+    boost::system::error_code ec;
+    m_detail->m_acceptor.close(ec);
+    Transport<proto>::closeDescriptors();
+}
+
 template <class proto>
 std::shared_ptr<Server<proto> > Server<proto>::shared_from_this() {
     return std::static_pointer_cast<Server<proto> >(
@@ -31,6 +31,9 @@ class Server : public Transport<proto> {
 
     virtual void accept(bool wait);
 
+   protected:
+    virtual void closeDescriptors() override;
+
    private:
     virtual void onAccept(const boost::system::error_code& ec);
 
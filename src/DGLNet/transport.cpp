@@ -105,6 +105,27 @@ void Transport<boost::asio::ip::tcp>::abort() {
         m_detail->m_socket.shutdown(
             boost::asio::ip::tcp::socket::shutdown_both);
         m_detail->m_socket.close();
+        // io_service may be stopped by stop(), or after running out of work
+        if (m_detail->m_io_service.stopped()) {
+            m_detail->m_io_service.reset();
+        }
+        while (m_detail->m_io_service.run_one()) {
+        }
+    }
+    catch (...) {
+    }
+}
+
+template <class proto>
+void Transport<proto>::forkChild() {
+    m_Abort = true;
+    try {
+        m_detail->m_io_service.notify_fork(
+                boost::asio::io_service::fork_child);
+        closeDescriptors();
+        if (m_detail->m_io_service.stopped()) {
+            m_detail->m_io_service.reset();
+        }
         while (m_detail->m_io_service.run_one()) {
         }
     }
@@ -112,6 +133,14 @@ void Transport<boost::asio::ip::tcp>::abort() {
     }
 }
 
+template <class proto>
+void Transport<proto>::closeDescriptors() {
+    // close only descriptor of child: shutdown would break connection of
+    // parent
+    boost::system::error_code ec;
+    m_detail->m_socket.close(ec);
+}
+
 #ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
 template <>
 void Transport<boost::asio::local::stream_protocol>::abort() {
@@ -120,6 +149,10 @@ void Transport<boost::asio::local::stream_protocol>::abort() {
         m_detail->m_socket.shutdown(
             boost::asio::local::stream_protocol::socket::shutdown_both);
         m_detail->m_socket.close();
+        // io_service may be stopped by stop(), or after running out of work
+        if (m_detail->m_io_service.stopped()) {
+            m_detail->m_io_service.reset();
+        }
         while (m_detail->m_io_service.run_one()) {
         }
     }
@@ -139,6 +172,16 @@ bool Transport<proto>::run_one() {
     return m_detail->m_io_service.run_one() > 0;
 }
 
+template <class proto>
+void Transport<proto>::run() {
+    m_detail->m_io_service.run();
+}
+
+template <class proto>
+void Transport<proto>::stop() {
+    m_detail->m_io_service.stop();
+}
+
 template <class proto>
 void Transport<proto>::read() {
     TransportHeader* header = new TransportHeader();
@@ -190,9 +233,7 @@ void Transport<proto>::onReadArchive(boost::asio::streambuf* stream,
             archive >> msg;
         }
 
-        onMessage(*msg);
-
-        delete msg;
+        onMessage(msg);
 
         read();
     }
@@ -220,9 +261,7 @@ void Transport<proto>::onReadCompressedArchive(boost::asio::streambuf* stream,
             archive >> msg;
         }
 
-        onMessage(*msg);
-
-        delete msg;
+        onMessage(msg);
 
         read();
     }
@@ -232,7 +271,21 @@ void Transport<proto>::onReadCompressedArchive(boost::asio::streambuf* stream,
 
 template <class proto>
 void Transport<proto>::sendMessage(const Message* msg) {
-    // create and push new stream to queue
+    enqueue(serialize(msg));
+}
+
+template <class proto>
+void Transport<proto>::postMessage(const Message* msg) {
+    // serialization and compression are done by caller; only queueing is
+    // deferred to thread running io_service.
+    m_detail->m_io_service.post(std::bind(&Transport<proto>::enqueue,
+                                          shared_from_this(), serialize(msg)));
+}
+
+template <class proto>
+std::pair<TransportHeader*, boost::asio::streambuf*>
+Transport<proto>::serialize(const Message* msg) {
+    // create new stream
     boost::asio::streambuf* stream = new boost::asio::streambuf;
     {
         std::ostream oArchiveStream(stream);
@@ -258,8 +311,20 @@ void Transport<proto>::sendMessage(const Message* msg) {
     TransportHeader* header =
         new TransportHeader(static_cast<value_t>(stream->size()), compressed);
 
-    m_WriteQueue.push_back(std::pair<TransportHeader*, boost::asio::streambuf*>(
-        header, stream));
+    return std::pair<TransportHeader*, boost::asio::streambuf*>(header, stream);
+}
+
+template <class proto>
+void Transport<proto>::enqueue(
+        std::pair<TransportHeader*, boost::asio::streambuf*> data) {
+    // push stream to queue
+    if (m_Abort) {
+        delete data.first;
+        delete data.second;
+        return;
+    }
+
+    m_WriteQueue.push_back(data);
 
     if (m_WriteReady) {
         notifyStartSend();
@@ -311,8 +376,9 @@ void Transport<proto>::onWrite(
 }
 
 template <class proto>
-void Transport<proto>::onMessage(const Message& msg) {
-    msg.handle(m_messageHandler);
+void Transport<proto>::onMessage(Message* msg) {
+    msg->handle(m_messageHandler);
+    delete msg;
 }
 
 template <class proto>
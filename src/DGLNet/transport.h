@@ -45,9 +45,20 @@ class ITransport : public std::enable_shared_from_this<ITransport> {
    public:
     virtual ~ITransport() {}
     virtual void sendMessage(const Message* msg) = 0;
+    // thread-safe: serializes on calling thread, sends on transport thread
+    virtual void postMessage(const Message* msg) = 0;
     virtual void poll() = 0;
     virtual bool run_one() = 0;
+    // runs handlers on calling thread, until there is no more work (connection
+    // is closed) or stop() is called
+    virtual void run() = 0;
+    // thread-safe: makes run() return as soon as possible. abort() must be
+    // called after run() returns.
+    virtual void stop() = 0;
     virtual void abort() = 0;
+    // called in child process after fork(): closes connection shared with
+    // parent, without shutting it down (like abort() would).
+    virtual void forkChild() = 0;
 
     std::shared_ptr<ITransport> get_shared_from_base() {
         return shared_from_this();
@@ -60,9 +71,13 @@ class Transport : public ITransport {
     Transport(MessageHandler* messageHandler);
     virtual ~Transport();
     virtual void sendMessage(const Message* msg) override;
+    virtual void postMessage(const Message* msg) override;
     virtual void poll() override;
     virtual bool run_one() override;
+    virtual void run() override;
+    virtual void stop() override;
     virtual void abort() override;
+    virtual void forkChild() override;
 
    protected:
     void read();
@@ -71,9 +86,19 @@ class Transport : public ITransport {
     virtual void notifyStartSend();
     virtual void notifyEndSend();
 
+    // closes descriptors of child process in forkChild()
+    virtual void closeDescriptors();
+
+    // called with each received message, takes ownership of it. By default
+    // the message is handled by MessageHandler and deleted.
+    virtual void onMessage(Message* msg);
+
     std::shared_ptr<TransportDetail<proto> > m_detail;
 
    private:
+    std::pair<TransportHeader*, boost::asio::streambuf*> serialize(
+            const Message* msg);
+    void enqueue(std::pair<TransportHeader*, boost::asio::streambuf*> data);
     void writeQueue();
 
     void onReadHeader(TransportHeader* header,
@@ -88,8 +113,6 @@ class Transport : public ITransport {
             std::vector<std::pair<TransportHeader*, boost::asio::streambuf*> >,
             const boost::system::error_code& ec);
 
-    void onMessage(const Message& msg);
-
     std::shared_ptr<Transport<proto> > shared_from_this();
 
     MessageHandler* m_messageHandler;
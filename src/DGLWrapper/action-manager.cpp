@@ -60,6 +60,9 @@ ActionManager::ActionManager() {
     actions::ProgramPipelineAction::Register(*this);
     actions::ShaderAction::Register(*this);
 
+    //shadow state tracing
+    actions::StateAction::Register(*this);
+
     //debug output functionality tracing
     actions::DebugOutputCallback::Register(*this);
 }
@@ -61,47 +61,54 @@ RetValue DefaultAction::Pre(const CalledEntryPoint& call) {
 
     DGLDebugController& controller =  GlobalState::getDebugController();
 
-    do {
+    if (controller.needsServer(call.getEntrypoint())) {
+        do {
 
-        newConnection = false;
+            newConnection = false;
 
-        std::lock_guard<std::mutex> server_lock(
-            controller.getServer().getMutex());
+            std::lock_guard<std::mutex> server_lock(
+                    controller.getServerMutex());
 
-        // do a fast non-blocking poll to get "interrupt" message, etc.."
-        controller.poll();
+            // do a fast non-blocking poll to get "interrupt" message, etc.."
+            controller.poll();
 
-        // check if any break is pending
-        if (controller.getBreakState().mayBreakAt(call.getEntrypoint())) {
-            
-            // we just hit a break;
-
-            dglState::GLContext* ctx = gc;
-            dglnet::message::BreakedCall callStateMessage(
-                call, (value_t)controller.getCallHistory().size(),
-                ctx ? ctx->getId() : 0, DGLDisplayState::describeAll());
-           controller.getServer().getTransport()->sendMessage(
-                &callStateMessage);
-
-           //remove old backtrace
-           controller.invalidateBacktrace();
-        }
+            // check if any break is pending
+            if (controller.getBreakState().mayBreakAt(call.getEntrypoint())) {
+                
+                // we just hit a break;
+
+                dglState::GLContext* ctx = gc;
+                dglnet::message::BreakedCall callStateMessage(
+                    call, (value_t)controller.getCallHistory().size(),
+                    ctx ? ctx->getId() : 0, DGLDisplayState::describeAll());
+                if (GlobalState::getConfiguration().m_PushBoundResources) {
+                    // save client a round trip for views of bound objects
+                    callStateMessage.m_PushedResources =
+                            controller.queryBoundResources();
+                }
+               controller.getServer().getTransport()->sendMessage(
+                    &callStateMessage);
+
+               //remove old backtrace
+               controller.invalidateBacktrace();
+            }
 
-        while (controller.getBreakState().isBreaked()) {
-            // iterate block & loop until someone unbreaks us
+            while (controller.getBreakState().isBreaked()) {
+                // iterate block & loop until someone unbreaks us
 
-            controller.run_one(newConnection);
+                controller.run_one(newConnection);
 
-            if (newConnection) {
-                //in the meantime reconnection happened.
+                if (newConnection) {
+                    //in the meantime reconnection happened.
 
-                //In such case start processing this part of Pre() once again.
-                
-                break;
+                    //In such case start processing this part of Pre() once again.
+                    
+                    break;
+                }
             }
-        }
 
-    } while (newConnection);
+        } while (newConnection);
+    }
 
     // now there should be no breaks
 
@@ -115,9 +122,7 @@ void DefaultAction::Post(const CalledEntryPoint& call, const RetValue& ret) {
 
     DGLDebugController& controller =  GlobalState::getDebugController();
 
-    std::lock_guard<std::mutex> server_lock(
-            controller.getServer().getMutex());
-
+    // no server lock: history is per-thread, break state is atomic
     CallHistory& history = controller.getCallHistory();
 
     GLenum error;
@@ -306,8 +311,10 @@ void ContextAction::Post(const CalledEntryPoint& call, const RetValue& ret) {
             ret.get(ctx);
             if (NULL != ctx) {
                 HDC device;
+                HGLRC shareCtx;
                 const int* attribList;
                 call.getArgs()[0].get(device);
+                call.getArgs()[1].get(shareCtx);
                 call.getArgs()[2].get(attribList);
 
                 dglState::GLContextVersion::Type contextType = 
@@ -335,7 +342,8 @@ void ContextAction::Post(const CalledEntryPoint& call, const RetValue& ret) {
                                           entryp,
                                           (opaque_id_t)GetPixelFormat(device),
                                           attributes),
-                                  reinterpret_cast<opaque_id_t>(ctx));
+                                  reinterpret_cast<opaque_id_t>(ctx),
+                                  reinterpret_cast<opaque_id_t>(shareCtx));
             }
             break;
         case wglMakeCurrent_Call:
@@ -404,9 +412,11 @@ void ContextAction::Post(const CalledEntryPoint& call, const RetValue& ret) {
             ret.get(ctx);
             if (ctx) {
                 GLXFBConfig config;
+                GLXContext shareCtx;
                 const int* attribList;
                 call.getArgs()[0].get(dpy);
                 call.getArgs()[1].get(config);
+                call.getArgs()[2].get(shareCtx);
                 call.getArgs()[4].get(attribList);
 
                 std::vector<gl_t> attributes;
@@ -431,7 +441,8 @@ void ContextAction::Post(const CalledEntryPoint& call, const RetValue& ret) {
                                         dglState::GLContextCreationData(
                                                 entryp, (opaque_id_t)config,
                                                 attributes),
-                                        reinterpret_cast<opaque_id_t>(ctx));
+                                        reinterpret_cast<opaque_id_t>(ctx),
+                                        reinterpret_cast<opaque_id_t>(shareCtx));
             }
             break;
         case glXCreateContext_Call:
@@ -439,8 +450,10 @@ void ContextAction::Post(const CalledEntryPoint& call, const RetValue& ret) {
             if (ctx) {
                 GLXFBConfig* memToFree;
                 XVisualInfo* vis;
+                GLXContext shareCtx;
                 call.getArgs()[0].get(dpy);
                 call.getArgs()[1].get(vis);
+                call.getArgs()[2].get(shareCtx);
                 DGLDisplayState::get(reinterpret_cast<opaque_id_t>(dpy),
                                      DGLDisplayState::Type::GLX)
                         ->createContext(
@@ -454,7 +467,8 @@ void ContextAction::Post(const CalledEntryPoint& call, const RetValue& ret) {
                                                                   vis->visualid,
                                                                   &memToFree),
                                           std::vector<gl_t>()),
-                                  reinterpret_cast<opaque_id_t>(ctx));
+                                  reinterpret_cast<opaque_id_t>(ctx),
+                                  reinterpret_cast<opaque_id_t>(shareCtx));
                 if (memToFree) {
                     XFree(memToFree);
                 }
@@ -465,15 +479,18 @@ void ContextAction::Post(const CalledEntryPoint& call, const RetValue& ret) {
             ret.get(ctx);
             if (ctx) {
                 GLXFBConfig config;
+                GLXContext shareCtx;
                 call.getArgs()[0].get(dpy);
                 call.getArgs()[1].get(config);
+                call.getArgs()[3].get(shareCtx);
                 DGLDisplayState::get(reinterpret_cast<opaque_id_t>(dpy),
                                      DGLDisplayState::Type::GLX)
                         ->createContext(dglState::GLContextVersion::Type::DT,
                                         dglState::GLContextCreationData(
                                                 entryp, (opaque_id_t)config,
                                                 std::vector<gl_t>()),
-                                        reinterpret_cast<opaque_id_t>(ctx));
+                                        reinterpret_cast<opaque_id_t>(ctx),
+                                        reinterpret_cast<opaque_id_t>(shareCtx));
             }
             break;
         case glXMakeCurrent_Call:
@@ -555,9 +572,11 @@ void ContextAction::Post(const CalledEntryPoint& call, const RetValue& ret) {
             if (NULL != eglCtx) {
                 EGLDisplay eglDpy;
                 EGLConfig eglConfig;
+                EGLContext eglShareCtx;
                 EGLint const* attribList;
                 call.getArgs()[0].get(eglDpy);
                 call.getArgs()[1].get(eglConfig);
+                call.getArgs()[2].get(eglShareCtx);
                 call.getArgs()[3].get(attribList);
 
                 std::vector<gl_t> attributes;
@@ -597,7 +616,8 @@ void ContextAction::Post(const CalledEntryPoint& call, const RetValue& ret) {
                     dglState::GLContextCreationData(
                     entryp, (opaque_id_t)eglConfig,
                     attributes),
-                    reinterpret_cast<opaque_id_t>(eglCtx));
+                    reinterpret_cast<opaque_id_t>(eglCtx),
+                    reinterpret_cast<opaque_id_t>(eglShareCtx));
             }
             break;
         case eglMakeCurrent_Call:
@@ -929,7 +949,7 @@ void TextureAction::NoGLErrorPost(const CalledEntryPoint& call, const RetValue&
             call.getArgs()[1].get(names);
 
             for (size_t i = 0; i < static_cast<size_t>(n); i++) {
-                gc->ns().getShared()->get().m_Textures.getOrCreateObject<void>(names[i]);
+                gc->ns().getShared().get().m_Textures.getOrCreateObject<void>(names[i]);
             }
         } else if (entrp == glDeleteTextures_Call ||
                    entrp == glDeleteTexturesEXT_Call) {
@@ -941,7 +961,7 @@ void TextureAction::NoGLErrorPost(const CalledEntryPoint& call, const RetValue&
 
             for (size_t i = 0; i < static_cast<size_t>(n); i++) {
                 gc->shadow().getTexUnits().unbindTexture(names[i]);
-                gc->ns().getShared()->get().m_Textures.deleteObject(names[i]);
+                gc->ns().getShared().get().m_Textures.deleteObject(names[i]);
             }
         } else if (entrp == glBindTexture_Call ||
                    entrp == glBindTextureEXT_Call) {
@@ -949,8 +969,9 @@ void TextureAction::NoGLErrorPost(const CalledEntryPoint& call, const RetValue&
             call.getArgs()[0].get(target);
             GLuint name;
             call.getArgs()[1].get(name);
-            gc->ns().getShared()->get().m_Textures.getOrCreateObject<void>(name)->setTarget(target);
-            gc->shadow().getTexUnits().bindTexture(target, name);
+            gc->ns().getShared().get().m_Textures.getOrCreateObject<void>(name)->setTarget(target);
+            gc->shadow().getTexUnits().bindTexture(
+                    gc->shadow().getActiveTexture(), target, name);
         }
     }
     PrevPost(call, ret);
@@ -982,6 +1003,14 @@ void TextureFormatAction::Register(ActionManager& manager) {
     manager.RegisterAction(glTexStorage1DEXT_Call, obj);
     manager.RegisterAction(glTexStorage2DEXT_Call, obj);
     manager.RegisterAction(glTexStorage3DEXT_Call, obj);
+    manager.RegisterAction(glCopyTexImage1D_Call, obj);
+    manager.RegisterAction(glCopyTexImage1DEXT_Call, obj);
+    manager.RegisterAction(glCopyTexImage2D_Call, obj);
+    manager.RegisterAction(glCopyTexImage2DEXT_Call, obj);
+    manager.RegisterAction(glGenerateMipmap_Call, obj);
+    manager.RegisterAction(glGenerateMipmapEXT_Call, obj);
+    manager.RegisterAction(glGenerateMipmapOES_Call, obj);
+    manager.RegisterAction(glEGLImageTargetTexture2DOES_Call, obj);
 }
 
 void TextureFormatAction::NoGLErrorPost(const CalledEntryPoint& call, const RetValue& ret) {
@@ -1001,6 +1030,8 @@ void TextureFormatAction::NoGLErrorPost(const CalledEntryPoint& call, const RetV
         GLenum target;
         
         bool immutable = false;
+        bool mipmap = false;
+        bool untracked = false;
 
         const std::vector<AnyValue>& args = call.getArgs();
 
@@ -1056,18 +1087,21 @@ void TextureFormatAction::NoGLErrorPost(const CalledEntryPoint& call, const RetV
                 break;
             case glCompressedTexImage1D_Call:
             case glCompressedTexImage1DARB_Call:
+                args[1].get(level);
                 args[2].get(iFormat);
-                args[3].get(width);
+                args[3].get(width);
                 break;
             case glCompressedTexImage2D_Call:
             case glCompressedTexImage2DARB_Call:
+                args[1].get(level);
                 args[2].get(iFormat);
                 args[3].get(width);
-                args[3].get(height);
+                args[4].get(height);
                 break;
             case glCompressedTexImage3D_Call:
             case glCompressedTexImage3DARB_Call:
             case glCompressedTexImage3DOES_Call:
+                args[1].get(level);
                 args[2].get(iFormat);
                 args[3].get(width);
                 args[4].get(height);
@@ -1096,18 +1130,48 @@ void TextureFormatAction::NoGLErrorPost(const CalledEntryPoint& call, const RetV
                 args[4].get(height);
                 args[2].get(iFormat);  //GLenum
                 args[3].get(width);
+                level = 1;              //multisample textures have one level
                 immutable = true;
             break;
+            case glCopyTexImage2D_Call:
+            case glCopyTexImage2DEXT_Call:
+                args[6].get(height);
+                //fall through
+            case glCopyTexImage1D_Call:
+            case glCopyTexImage1DEXT_Call:
+                args[1].get(level);
+                args[2].get(iFormat);
+                args[5].get(width);
+                break;
+            case glGenerateMipmap_Call:
+            case glGenerateMipmapEXT_Call:
+            case glGenerateMipmapOES_Call:
+                mipmap = true;
+                break;
+            case glEGLImageTargetTexture2DOES_Call:
+                //level 0 defined by external image: size is not known
+                untracked = true;
+                break;
         }
 
         GLuint textureName;
         if (glutils::getBoundTexture(glutils::textTargetToBindableTarget(target), textureName)) {
 
-            dglState::GLTextureObj* tex = gc->ns().getShared()->get().m_Textures.getOrCreateObject<void>(textureName);
+            dglState::GLTextureObj* tex = gc->ns().getShared().get().m_Textures.getOrCreateObject<void>(textureName);
 
             tex->setTarget(target);
 
-            if (immutable) {
+            if (untracked) {
+                tex->resetLevels();
+            } else if (mipmap) {
+                GLint baseLevel = 0, maxLevel = 1000;
+                if (gc->getVersion().check(dglState::GLContextVersion::Type::DT) ||
+                    gc->getVersion().check(dglState::GLContextVersion::Type::ES, 3)) {
+                    DIRECT_CALL_CHK(glGetTexParameteriv)(glutils::textTargetToBindableTarget(target), GL_TEXTURE_BASE_LEVEL, &baseLevel);
+                    DIRECT_CALL_CHK(glGetTexParameteriv)(glutils::textTargetToBindableTarget(target), GL_TEXTURE_MAX_LEVEL, &maxLevel);
+                }
+                tex->generateMipmap(static_cast<GLuint>(baseLevel), static_cast<GLuint>(maxLevel));
+            } else if (immutable) {
                 tex->setTexStorage(level, width, height, depth, iFormat, format, type);
             } else {
                 tex->setTexImage(level, width, height, depth, iFormat, format, type);
@@ -1129,6 +1193,13 @@ void BufferAction::Register(ActionManager& manager) {
     manager.RegisterAction(glDeleteBuffersARB_Call, obj);
     manager.RegisterAction(glBindBuffer_Call, obj);
     manager.RegisterAction(glBindBufferARB_Call, obj);
+    manager.RegisterAction(glBufferData_Call, obj);
+    manager.RegisterAction(glBufferDataARB_Call, obj);
+    manager.RegisterAction(glBufferStorage_Call, obj);
+    manager.RegisterAction(glNamedBufferData_Call, obj);
+    manager.RegisterAction(glNamedBufferDataEXT_Call, obj);
+    manager.RegisterAction(glNamedBufferStorage_Call, obj);
+    manager.RegisterAction(glNamedBufferStorageEXT_Call, obj);
 }
 
 void BufferAction::NoGLErrorPost(const CalledEntryPoint& call, const RetValue& ret) {
@@ -1143,7 +1214,7 @@ void BufferAction::NoGLErrorPost(const CalledEntryPoint& call, const RetValue& r
             call.getArgs()[1].get(names);
 
             for (size_t i = 0; i < static_cast<size_t>(n); i++) {
-                gc->ns().getShared()->get().m_Buffers.getOrCreateObject<void>(names[i]);
+                gc->ns().getShared().get().m_Buffers.getOrCreateObject<void>(names[i]);
             }
         } else if (entrp == glDeleteBuffers_Call ||
                    entrp == glDeleteBuffersARB_Call) {
@@ -1154,7 +1225,7 @@ void BufferAction::NoGLErrorPost(const CalledEntryPoint& call, const RetValue& r
             call.getArgs()[1].get(names);
 
             for (size_t i = 0; i < static_cast<size_t>(n); i++) {
-                gc->ns().getShared()->get().m_Buffers.deleteObject(names[i]);
+                gc->ns().getShared().get().m_Buffers.deleteObject(names[i]);
             }
         } else if (entrp == glBindBuffer_Call ||
                    entrp == glBindBufferARB_Call) {
@@ -1163,7 +1234,30 @@ void BufferAction::NoGLErrorPost(const CalledEntryPoint& call, const RetValue& r
             GLuint name;
             call.getArgs()[1].get(name);
             if (name) {
-                gc->ns().getShared()->get().m_Buffers.getOrCreateObject<void>(name)->setTarget(target);
+                gc->ns().getShared().get().m_Buffers.getOrCreateObject<void>(name)->setTarget(target);
+            }
+        } else if (entrp == glBufferData_Call ||
+                   entrp == glBufferDataARB_Call ||
+                   entrp == glBufferStorage_Call) {
+            GLenum target;
+            call.getArgs()[0].get(target);
+            GLsizeiptr size;
+            call.getArgs()[1].get(size);
+            // binding is tracked by StateAction: no driver round trip here
+            GLuint name;
+            if (gc->shadow().getBoundBuffer(target, &name) && name) {
+                gc->ns().getShared().get().m_Buffers.getOrCreateObject<void>(name)->setSize(size);
+            }
+        } else if (entrp == glNamedBufferData_Call ||
+                   entrp == glNamedBufferDataEXT_Call ||
+                   entrp == glNamedBufferStorage_Call ||
+                   entrp == glNamedBufferStorageEXT_Call) {
+            GLuint name;
+            call.getArgs()[0].get(name);
+            GLsizeiptr size;
+            call.getArgs()[1].get(size);
+            if (name) {
+                gc->ns().getShared().get().m_Buffers.getOrCreateObject<void>(name)->setSize(size);
             }
         }
     }
@@ -1561,6 +1655,455 @@ void RenderbufferAction::NoGLErrorPost(const CalledEntryPoint& call, const RetVa
     PrevPost(call, ret);
 }
 
+void StateAction::Register(ActionManager& manager) {
+    std::shared_ptr<StateAction> obj
+        = std::make_shared<StateAction>();
+
+    //capabilities
+    manager.RegisterAction(glEnable_Call, obj);
+    manager.RegisterAction(glDisable_Call, obj);
+    manager.RegisterAction(glEnablei_Call, obj);
+    manager.RegisterAction(glDisablei_Call, obj);
+    manager.RegisterAction(glEnableiEXT_Call, obj);
+    manager.RegisterAction(glDisableiEXT_Call, obj);
+    manager.RegisterAction(glEnableIndexedEXT_Call, obj);
+    manager.RegisterAction(glDisableIndexedEXT_Call, obj);
+
+    //viewport & scissor
+    manager.RegisterAction(glViewport_Call, obj);
+    manager.RegisterAction(glViewportIndexedf_Call, obj);
+    manager.RegisterAction(glViewportIndexedfv_Call, obj);
+    manager.RegisterAction(glViewportArrayv_Call, obj);
+    manager.RegisterAction(glScissor_Call, obj);
+    manager.RegisterAction(glScissorIndexed_Call, obj);
+    manager.RegisterAction(glScissorIndexedv_Call, obj);
+    manager.RegisterAction(glScissorArrayv_Call, obj);
+
+    //blending
+    manager.RegisterAction(glBlendFunc_Call, obj);
+    manager.RegisterAction(glBlendFuncSeparate_Call, obj);
+    manager.RegisterAction(glBlendFuncSeparateEXT_Call, obj);
+    manager.RegisterAction(glBlendFuncSeparateINGR_Call, obj);
+    manager.RegisterAction(glBlendFuncSeparateOES_Call, obj);
+    manager.RegisterAction(glBlendFunci_Call, obj);
+    manager.RegisterAction(glBlendFunciARB_Call, obj);
+    manager.RegisterAction(glBlendFuncSeparatei_Call, obj);
+    manager.RegisterAction(glBlendFuncSeparateiARB_Call, obj);
+    manager.RegisterAction(glBlendEquation_Call, obj);
+    manager.RegisterAction(glBlendEquationEXT_Call, obj);
+    manager.RegisterAction(glBlendEquationOES_Call, obj);
+    manager.RegisterAction(glBlendEquationSeparate_Call, obj);
+    manager.RegisterAction(glBlendEquationSeparateEXT_Call, obj);
+    manager.RegisterAction(glBlendEquationSeparateOES_Call, obj);
+    manager.RegisterAction(glBlendEquationi_Call, obj);
+    manager.RegisterAction(glBlendEquationiARB_Call, obj);
+    manager.RegisterAction(glBlendEquationSeparatei_Call, obj);
+    manager.RegisterAction(glBlendEquationSeparateiARB_Call, obj);
+    manager.RegisterAction(glBlendColor_Call, obj);
+    manager.RegisterAction(glBlendColorEXT_Call, obj);
+
+    //depth
+    manager.RegisterAction(glDepthFunc_Call, obj);
+    manager.RegisterAction(glDepthMask_Call, obj);
+    manager.RegisterAction(glDepthRange_Call, obj);
+    manager.RegisterAction(glDepthRangef_Call, obj);
+    manager.RegisterAction(glDepthRangefOES_Call, obj);
+    manager.RegisterAction(glDepthRangeIndexed_Call, obj);
+    manager.RegisterAction(glDepthRangeArrayv_Call, obj);
+
+    //pixel store
+    manager.RegisterAction(glPixelStorei_Call, obj);
+    manager.RegisterAction(glPixelStoref_Call, obj);
+
+    //bindings
+    manager.RegisterAction(glActiveTexture_Call, obj);
+    manager.RegisterAction(glActiveTextureARB_Call, obj);
+    manager.RegisterAction(glBindBuffer_Call, obj);
+    manager.RegisterAction(glBindBufferARB_Call, obj);
+    manager.RegisterAction(glBindBufferBase_Call, obj);
+    manager.RegisterAction(glBindBufferBaseEXT_Call, obj);
+    manager.RegisterAction(glBindBufferBaseNV_Call, obj);
+    manager.RegisterAction(glBindBufferRange_Call, obj);
+    manager.RegisterAction(glBindBufferRangeEXT_Call, obj);
+    manager.RegisterAction(glBindBufferRangeNV_Call, obj);
+    manager.RegisterAction(glDeleteBuffers_Call, obj);
+    manager.RegisterAction(glDeleteBuffersARB_Call, obj);
+    manager.RegisterAction(glBindVertexArray_Call, obj);
+    manager.RegisterAction(glBindVertexArrayOES_Call, obj);
+    manager.RegisterAction(glBindVertexArrayAPPLE_Call, obj);
+    manager.RegisterAction(glDeleteVertexArrays_Call, obj);
+    manager.RegisterAction(glDeleteVertexArraysOES_Call, obj);
+    manager.RegisterAction(glDeleteVertexArraysAPPLE_Call, obj);
+    manager.RegisterAction(glVertexArrayElementBuffer_Call, obj);
+    manager.RegisterAction(glBindFramebuffer_Call, obj);
+    manager.RegisterAction(glBindFramebufferEXT_Call, obj);
+    manager.RegisterAction(glBindFramebufferOES_Call, obj);
+    manager.RegisterAction(glDeleteFramebuffers_Call, obj);
+    manager.RegisterAction(glDeleteFramebuffersEXT_Call, obj);
+    manager.RegisterAction(glDeleteFramebuffersOES_Call, obj);
+    manager.RegisterAction(glBindRenderbuffer_Call, obj);
+    manager.RegisterAction(glBindRenderbufferEXT_Call, obj);
+    manager.RegisterAction(glBindRenderbufferOES_Call, obj);
+    manager.RegisterAction(glDeleteRenderbuffers_Call, obj);
+    manager.RegisterAction(glDeleteRenderbuffersEXT_Call, obj);
+    manager.RegisterAction(glDeleteRenderbuffersOES_Call, obj);
+    manager.RegisterAction(glBindTransformFeedback_Call, obj);
+    manager.RegisterAction(glDeleteTransformFeedbacks_Call, obj);
+
+    //attribute stacks
+    manager.RegisterAction(glPopAttrib_Call, obj);
+    manager.RegisterAction(glPopClientAttrib_Call, obj);
+
+    //display lists
+    manager.RegisterAction(glNewList_Call, obj);
+    manager.RegisterAction(glEndList_Call, obj);
+    manager.RegisterAction(glCallList_Call, obj);
+    manager.RegisterAction(glCallLists_Call, obj);
+}
+
+bool StateAction::isCompiledIntoList(Entrypoint entrp) {
+    switch (entrp) {
+        case glPixelStorei_Call:
+        case glPixelStoref_Call:
+        case glBindBuffer_Call:
+        case glBindBufferARB_Call:
+        case glBindBufferBase_Call:
+        case glBindBufferBaseEXT_Call:
+        case glBindBufferBaseNV_Call:
+        case glBindBufferRange_Call:
+        case glBindBufferRangeEXT_Call:
+        case glBindBufferRangeNV_Call:
+        case glDeleteBuffers_Call:
+        case glDeleteBuffersARB_Call:
+        case glBindVertexArray_Call:
+        case glBindVertexArrayOES_Call:
+        case glBindVertexArrayAPPLE_Call:
+        case glDeleteVertexArrays_Call:
+        case glDeleteVertexArraysOES_Call:
+        case glDeleteVertexArraysAPPLE_Call:
+        case glVertexArrayElementBuffer_Call:
+        case glBindFramebuffer_Call:
+        case glBindFramebufferEXT_Call:
+        case glBindFramebufferOES_Call:
+        case glDeleteFramebuffers_Call:
+        case glDeleteFramebuffersEXT_Call:
+        case glDeleteFramebuffersOES_Call:
+        case glBindRenderbuffer_Call:
+        case glBindRenderbufferEXT_Call:
+        case glBindRenderbufferOES_Call:
+        case glDeleteRenderbuffers_Call:
+        case glDeleteRenderbuffersEXT_Call:
+        case glDeleteRenderbuffersOES_Call:
+        case glBindTransformFeedback_Call:
+        case glDeleteTransformFeedbacks_Call:
+            return false;
+        default:
+            return true;
+    }
+}
+
+void StateAction::NoGLErrorPost(const CalledEntryPoint& call, const RetValue& ret) {
+    if (gc) {
+        dglState::GLContextShadowState& shadow = gc->shadow();
+        const std::vector<AnyValue>& args = call.getArgs();
+
+        switch (call.getEntrypoint()) {
+            case glNewList_Call: {
+                GLenum mode;
+                args[1].get(mode);
+                shadow.setListCompileMode(mode == GL_COMPILE);
+                PrevPost(call, ret);
+                return;
+            }
+            case glEndList_Call:
+                shadow.setListCompileMode(false);
+                PrevPost(call, ret);
+                return;
+            default:
+                break;
+        }
+
+        if (shadow.inListCompileMode() &&
+            isCompiledIntoList(call.getEntrypoint())) {
+            //call is only compiled into display list, not executed
+            PrevPost(call, ret);
+            return;
+        }
+
+        switch (call.getEntrypoint()) {
+            case glEnable_Call:
+            case glDisable_Call: {
+                GLenum cap;
+                args[0].get(cap);
+                shadow.setEnabled(cap, call.getEntrypoint() == glEnable_Call);
+                break;
+            }
+            case glEnablei_Call:
+            case glDisablei_Call:
+            case glEnableiEXT_Call:
+            case glDisableiEXT_Call:
+            case glEnableIndexedEXT_Call:
+            case glDisableIndexedEXT_Call: {
+                //index 0 is visible through glIsEnabled()
+                GLenum cap;
+                args[0].get(cap);
+                shadow.invalidateEnabled(cap);
+                break;
+            }
+            case glViewport_Call: {
+                GLint x, y;
+                GLsizei width, height;
+                args[0].get(x);
+                args[1].get(y);
+                args[2].get(width);
+                args[3].get(height);
+                shadow.setViewport(x, y, width, height);
+                break;
+            }
+            case glViewportIndexedf_Call:
+            case glViewportIndexedfv_Call:
+            case glViewportArrayv_Call:
+                shadow.invalidate(GL_VIEWPORT);
+                break;
+            case glScissor_Call: {
+                GLint x, y;
+                GLsizei width, height;
+                args[0].get(x);
+                args[1].get(y);
+                args[2].get(width);
+                args[3].get(height);
+                shadow.setScissor(x, y, width, height);
+                break;
+            }
+            case glScissorIndexed_Call:
+            case glScissorIndexedv_Call:
+            case glScissorArrayv_Call:
+                shadow.invalidate(GL_SCISSOR_BOX);
+                break;
+            case glBlendFunc_Call: {
+                GLenum src, dst;
+                args[0].get(src);
+                args[1].get(dst);
+                shadow.setBlendFunc(src, dst, src, dst);
+                break;
+            }
+            case glBlendFuncSeparate_Call:
+            case glBlendFuncSeparateEXT_Call:
+            case glBlendFuncSeparateINGR_Call:
+            case glBlendFuncSeparateOES_Call: {
+                GLenum srcRGB, dstRGB, srcAlpha, dstAlpha;
+                args[0].get(srcRGB);
+                args[1].get(dstRGB);
+                args[2].get(srcAlpha);
+                args[3].get(dstAlpha);
+                shadow.setBlendFunc(srcRGB, dstRGB, srcAlpha, dstAlpha);
+                break;
+            }
+            case glBlendFunci_Call:
+            case glBlendFunciARB_Call:
+            case glBlendFuncSeparatei_Call:
+            case glBlendFuncSeparateiARB_Call:
+                shadow.invalidate(GL_BLEND_SRC_RGB);
+                shadow.invalidate(GL_BLEND_DST_RGB);
+                shadow.invalidate(GL_BLEND_SRC_ALPHA);
+                shadow.invalidate(GL_BLEND_DST_ALPHA);
+                break;
+            case glBlendEquation_Call:
+            case glBlendEquationEXT_Call:
+            case glBlendEquationOES_Call: {
+                GLenum mode;
+                args[0].get(mode);
+                shadow.setBlendEquation(mode, mode);
+                break;
+            }
+            case glBlendEquationSeparate_Call:
+            case glBlendEquationSeparateEXT_Call:
+            case glBlendEquationSeparateOES_Call: {
+                GLenum modeRGB, modeAlpha;
+                args[0].get(modeRGB);
+                args[1].get(modeAlpha);
+                shadow.setBlendEquation(modeRGB, modeAlpha);
+                break;
+            }
+            case glBlendEquationi_Call:
+            case glBlendEquationiARB_Call:
+            case glBlendEquationSeparatei_Call:
+            case glBlendEquationSeparateiARB_Call:
+                shadow.invalidate(GL_BLEND_EQUATION_RGB);
+                shadow.invalidate(GL_BLEND_EQUATION_ALPHA);
+                break;
+            case glBlendColor_Call:
+            case glBlendColorEXT_Call:
+                //may be clamped, depending on API version
+                shadow.invalidate(GL_BLEND_COLOR);
+                break;
+            case glDepthFunc_Call: {
+                GLenum func;
+                args[0].get(func);
+                shadow.setDepthFunc(func);
+                break;
+            }
+            case glDepthMask_Call: {
+                GLboolean flag;
+                args[0].get(flag);
+                shadow.setDepthMask(flag);
+                break;
+            }
+            case glDepthRange_Call:
+            case glDepthRangef_Call:
+            case glDepthRangefOES_Call:
+            case glDepthRangeIndexed_Call:
+            case glDepthRangeArrayv_Call:
+                //clamped and stored in implementation-specific precision
+                shadow.invalidate(GL_DEPTH_RANGE);
+                break;
+            case glPixelStorei_Call: {
+                GLenum pname;
+                GLint param;
+                args[0].get(pname);
+                args[1].get(param);
+                shadow.setPixelStore(pname, param);
+                break;
+            }
+            case glPixelStoref_Call: {
+                GLenum pname;
+                args[0].get(pname);
+                shadow.invalidate(pname);
+                break;
+            }
+            case glActiveTexture_Call:
+            case glActiveTextureARB_Call: {
+                GLenum texture;
+                args[0].get(texture);
+                shadow.setActiveTexture(texture);
+                break;
+            }
+            case glBindBuffer_Call:
+            case glBindBufferARB_Call: {
+                GLenum target;
+                GLuint name;
+                args[0].get(target);
+                args[1].get(name);
+                shadow.bindBuffer(target, name);
+                break;
+            }
+            case glBindBufferBase_Call:
+            case glBindBufferBaseEXT_Call:
+            case glBindBufferBaseNV_Call:
+            case glBindBufferRange_Call:
+            case glBindBufferRangeEXT_Call:
+            case glBindBufferRangeNV_Call: {
+                //indexed binding also changes generic binding point
+                GLenum target;
+                GLuint name;
+                args[0].get(target);
+                args[2].get(name);
+                shadow.bindBuffer(target, name);
+                break;
+            }
+            case glDeleteBuffers_Call:
+            case glDeleteBuffersARB_Call: {
+                GLsizei n = 0;
+                const GLuint* names;
+                args[0].get(n);
+                args[1].get(names);
+                for (size_t i = 0; i < static_cast<size_t>(n); i++) {
+                    shadow.deleteBuffer(names[i]);
+                }
+                break;
+            }
+            case glBindVertexArray_Call:
+            case glBindVertexArrayOES_Call:
+            case glBindVertexArrayAPPLE_Call: {
+                GLuint name;
+                args[0].get(name);
+                shadow.bindVertexArray(name);
+                break;
+            }
+            case glDeleteVertexArrays_Call:
+            case glDeleteVertexArraysOES_Call:
+            case glDeleteVertexArraysAPPLE_Call: {
+                GLsizei n = 0;
+                const GLuint* names;
+                args[0].get(n);
+                args[1].get(names);
+                for (size_t i = 0; i < static_cast<size_t>(n); i++) {
+                    shadow.deleteVertexArray(names[i]);
+                }
+                break;
+            }
+            case glBindFramebuffer_Call:
+            case glBindFramebufferEXT_Call:
+            case glBindFramebufferOES_Call: {
+                GLenum target;
+                GLuint name;
+                args[0].get(target);
+                args[1].get(name);
+                shadow.bindFramebuffer(
+                        target, name,
+                        gc->hasCapability(dglState::GLContext::ContextCap::
+                                                  SeparateReadDrawFramebufferObjects));
+                break;
+            }
+            case glDeleteFramebuffers_Call:
+            case glDeleteFramebuffersEXT_Call:
+            case glDeleteFramebuffersOES_Call: {
+                GLsizei n = 0;
+                const GLuint* names;
+                args[0].get(n);
+                args[1].get(names);
+                for (size_t i = 0; i < static_cast<size_t>(n); i++) {
+                    shadow.deleteFramebuffer(names[i]);
+                }
+                break;
+            }
+            case glBindRenderbuffer_Call:
+            case glBindRenderbufferEXT_Call:
+            case glBindRenderbufferOES_Call: {
+                GLenum target;
+                GLuint name;
+                args[0].get(target);
+                args[1].get(name);
+                shadow.bindRenderbuffer(name);
+                break;
+            }
+            case glDeleteRenderbuffers_Call:
+            case glDeleteRenderbuffersEXT_Call:
+            case glDeleteRenderbuffersOES_Call: {
+                GLsizei n = 0;
+                const GLuint* names;
+                args[0].get(n);
+                args[1].get(names);
+                for (size_t i = 0; i < static_cast<size_t>(n); i++) {
+                    shadow.deleteRenderbuffer(names[i]);
+                }
+                break;
+            }
+            case glBindTransformFeedback_Call:
+            case glDeleteTransformFeedbacks_Call:
+                shadow.invalidate(GL_TRANSFORM_FEEDBACK_BUFFER_BINDING);
+                break;
+            case glVertexArrayElementBuffer_Call: {
+                GLuint vaobj, buffer;
+                args[0].get(vaobj);
+                args[1].get(buffer);
+                shadow.vertexArrayElementBuffer(vaobj, buffer);
+                break;
+            }
+            case glPopAttrib_Call:
+            case glPopClientAttrib_Call:
+            case glCallList_Call:
+            case glCallLists_Call:
+                //display lists may contain any state calls
+                shadow.invalidateAll();
+                break;
+            default:
+                break;
+        }
+    }
+    PrevPost(call, ret);
+}
+
 void DebugOutputCallback::Register(ActionManager& manager) {
     std::shared_ptr<DebugOutputCallback> obj
         = std::make_shared<DebugOutputCallback>();
@@ -173,6 +173,24 @@ private:
     virtual void NoGLErrorPost(const CalledEntryPoint&, const RetValue& ret);
 };
 
+/**
+ * Maintains GLContextShadowState: every call modifying shadowed state must be
+ * registered here.
+ */
+class StateAction : public ErrorAwareGLAction {
+public:
+    static void Register(ActionManager& mgr);
+private:
+    virtual void NoGLErrorPost(const CalledEntryPoint&, const RetValue& ret);
+
+    /**
+     * True if call is only compiled (not executed) inside
+     * glNewList(GL_COMPILE). Pixel store, buffer, vertex array, framebuffer,
+     * renderbuffer and transform feedback calls execute immediately.
+     */
+    static bool isCompiledIntoList(Entrypoint entrp);
+};
+
 class DebugOutputCallback : public ActionBase {
 public:
     static void Register(ActionManager& mgr);
@@ -20,11 +20,15 @@
 #include "ipc.h"
 #include "globalstate.h"
 #include "backtrace.h"
+#include "display.h"
 
 #include <DGLNet/server.h>
 #include <DGLNet/protocol/message.h>
 #include <DGLNet/protocol/resource.h>
 
+#include <algorithm>
+#include <iterator>
+#include <chrono>
 #include <sstream>
 #include <boost/interprocess/sync/named_semaphore.hpp>
 
@@ -33,12 +37,32 @@ BreakState::BreakState()
         : m_break(true), //always give initial break
           m_BreakingEnabled(false), //initially all breaks are masked until connection is made.
           m_StepModeEnabled(false),
-          m_StepMode(dglnet::message::StepMode::CALL) {}
+          m_StepMode(dglnet::message::StepMode::CALL),
+          m_BreakPoints(new std::atomic<bool>[NUM_ENTRYPOINTS]) {
+    for (int i = 0; i < NUM_ENTRYPOINTS; i++) {
+        m_BreakPoints[i] = false;
+    }
+}
+
+void BreakState::reset() {
+    m_break = true;
+    m_BreakingEnabled = false;
+    m_StepModeEnabled = false;
+    m_StepMode = dglnet::message::StepMode::CALL;
+    for (int i = 0; i < NUM_ENTRYPOINTS; i++) {
+        m_BreakPoints[i] = false;
+    }
+}
 
 void BreakState::setEnabled(bool enabled) {
     m_BreakingEnabled = enabled;
 }
 
+bool BreakState::needsBreakCheck(const Entrypoint& e) {
+    return m_BreakingEnabled &&
+           (m_break || m_StepModeEnabled || m_BreakPoints[e]);
+}
+
 bool BreakState::mayBreakAt(const Entrypoint& e) {
     if (m_StepModeEnabled) {
         switch (m_StepMode) {
@@ -54,7 +78,7 @@ bool BreakState::mayBreakAt(const Entrypoint& e) {
         }
     }
 
-    if (m_BreakPoints.find(e) != m_BreakPoints.end()) {
+    if (m_BreakPoints[e]) {
         setBreak();
     }
     return isBreaked();
@@ -77,16 +101,26 @@ void BreakState::setBreakAtCompilerError() {
 bool BreakState::isBreaked() { return m_break && m_BreakingEnabled; }
 
 void BreakState::handle(const dglnet::message::ContinueBreak& msg) {
-    m_break = msg.isBreaked();
-    if (!m_break) {
+    bool breaked = msg.isBreaked();
+    if (!breaked) {
+        // step mode is set before break is released, so threads checking
+        // needsBreakCheck() do not run past it
         if ((m_StepModeEnabled = msg.getStep().first) != false) {
             m_StepMode = msg.getStep().second;
         }
     }
+    m_break = breaked;
 }
 
 void BreakState::handle(const dglnet::message::SetBreakPoints& msg) {
-    m_BreakPoints = msg.get();
+    for (int i = 0; i < NUM_ENTRYPOINTS; i++) {
+        m_BreakPoints[i] = false;
+    }
+    const std::set<Entrypoint>& breakPoints = msg.get();
+    for (std::set<Entrypoint>::const_iterator i = breakPoints.begin();
+         i != breakPoints.end(); ++i) {
+        m_BreakPoints[*i] = true;
+    }
 }
 
 void BreakState::setBreak(bool _break) {
@@ -97,49 +131,250 @@ void BreakState::setBreak(bool _break) {
     }
 }
 
-CallHistory::CallHistory() {
-    m_cb = boost::circular_buffer<CalledEntryPoint>(CALL_HISTORY_LEN);
+namespace {
+/**
+ * Source of unique CallHistory ids. Id 0 is never used.
+ */
+std::atomic<uint64_t> s_CallHistoryIds(1);
+
+bool bySequence(const ThreadCallHistory::Entry& lhs,
+                const ThreadCallHistory::Entry& rhs) {
+    return lhs.first < rhs.first;
+}
+}
+
+ThreadCallHistory::ThreadCallHistory()
+        : m_cb(CALL_HISTORY_LEN), m_Version(0) {}
+
+CallHistory::CallHistory()
+        : m_Retired(CALL_HISTORY_LEN),
+          m_MergedVersion(0),
+          m_MergedValid(false),
+          m_Sequence(0),
+          m_ClearedSequence(0),
+          m_Id(s_CallHistoryIds++) {}
+
+ThreadCallHistory* CallHistory::getThreadHistory() {
+    DGLThreadState* state = DGLThreadState::get();
+    if (state->privDebugger.m_HistoryId != m_Id) {
+        std::shared_ptr<ThreadCallHistory> history =
+                std::make_shared<ThreadCallHistory>();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // thread list grows only here, so it is bounded by live threads
+        retireExited();
+        m_Threads.push_back(history);
+        state->setCallHistory(history, m_Id);
+    }
+    return state->privDebugger.m_History;
+}
+
+void CallHistory::retireExited() {
+    for (size_t i = 0; i < m_Threads.size();) {
+        // only the owning thread holds other reference, and it never takes
+        // a new one: sole reference means thread has exited
+        if (m_Threads[i].use_count() > 1) {
+            i++;
+            continue;
+        }
+        const ThreadCallHistory::Buffer& calls = m_Threads[i]->m_cb;
+        std::vector<ThreadCallHistory::Entry> folded;
+        folded.reserve(m_Retired.size() + calls.size());
+        std::merge(m_Retired.begin(), m_Retired.end(), calls.begin(),
+                   calls.end(), std::back_inserter(folded), bySequence);
+        // buffer keeps last CALL_HISTORY_LEN calls
+        m_Retired.clear();
+        for (size_t j = 0; j < folded.size(); j++) {
+            m_Retired.push_back(folded[j]);
+        }
+        m_Threads.erase(m_Threads.begin() + i);
+        m_MergedValid = false;
+    }
+}
+
+void CallHistory::merge() {
+    retireExited();
+
+    for (size_t i = 0; i < m_Threads.size(); i++) {
+        m_Threads[i]->m_mutex.lock();
+    }
+
+    uint64_t version = 0;
+    for (size_t i = 0; i < m_Threads.size(); i++) {
+        version += m_Threads[i]->m_Version;
+    }
+
+    if (!m_MergedValid || version != m_MergedVersion) {
+        std::vector<const ThreadCallHistory::Buffer*> buffers;
+        buffers.push_back(&m_Retired);
+        for (size_t i = 0; i < m_Threads.size(); i++) {
+            buffers.push_back(&m_Threads[i]->m_cb);
+        }
+
+        // k-way merge from newest call back, until CALL_HISTORY_LEN calls
+        // are taken. Only calls kept in merged history are copied.
+        std::vector<size_t> left(buffers.size());
+        for (size_t i = 0; i < buffers.size(); i++) {
+            left[i] = buffers[i]->size();
+        }
+        m_Merged.clear();
+        while (m_Merged.size() < CALL_HISTORY_LEN) {
+            size_t newest = buffers.size();
+            for (size_t i = 0; i < buffers.size(); i++) {
+                if (left[i] &&
+                    (newest == buffers.size() ||
+                     (*buffers[i])[left[i] - 1].first >
+                             (*buffers[newest])[left[newest] - 1].first)) {
+                    newest = i;
+                }
+            }
+            if (newest == buffers.size()) {
+                break;
+            }
+            m_Merged.push_back((*buffers[newest])[--left[newest]].second);
+        }
+        std::reverse(m_Merged.begin(), m_Merged.end());
+
+        m_MergedVersion = version;
+        m_MergedValid = true;
+    }
+
+    for (size_t i = m_Threads.size(); i > 0; i--) {
+        m_Threads[i - 1]->m_mutex.unlock();
+    }
 }
 
 void CallHistory::add(const CalledEntryPoint& entryp) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_cb.push_back(entryp);
+    ThreadCallHistory* thread = getThreadHistory();
+    uint64_t sequence = m_Sequence++;
+
+    std::lock_guard<std::mutex> lock(thread->m_mutex);
+    thread->m_cb.push_back(ThreadCallHistory::Entry(sequence, entryp));
+    thread->m_Version++;
 }
 
 void CallHistory::query(const dglnet::message::QueryCallTrace& traceQuery,
                         dglnet::message::CallTrace& reply) {
     std::lock_guard<std::mutex> lock(m_mutex);
+    merge();
 
     size_t startOffset = static_cast<size_t>(reply.m_StartOffset = traceQuery.m_StartOffset);
-    if (startOffset >= m_cb.size()) return;    // queried non existent elements
+    if (startOffset >= m_Merged.size()) return;    // queried non existent elements
 
     // trim query to sane range:
     size_t endOffset =
-            std::min(static_cast<size_t>(traceQuery.m_EndOffset), m_cb.size());
+            std::min(static_cast<size_t>(traceQuery.m_EndOffset), m_Merged.size());
 
-    boost::circular_buffer<CalledEntryPoint>::iterator begin, end;
-    end = m_cb.end() - startOffset;
-    begin = m_cb.end() - endOffset;
+    std::vector<CalledEntryPoint>::iterator begin, end;
+    end = m_Merged.end() - startOffset;
+    begin = m_Merged.end() - endOffset;
     std::back_insert_iterator<std::vector<CalledEntryPoint> > replyHistory(
             reply.m_Trace);
     std::copy(begin, end, replyHistory);
 }
 
-size_t CallHistory::size() { return m_cb.size(); }
+void CallHistory::search(const dglnet::request::SearchCallTrace& request,
+                         dglnet::resource::DGLResourceCallTraceSearch& reply) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    merge();
+
+    ptrdiff_t size = static_cast<ptrdiff_t>(m_Merged.size());
+    ptrdiff_t offset = request.m_StartOffset;
+    ptrdiff_t step = request.m_Backward ? 1 : -1;
+    if (!request.m_Backward) {
+        offset = std::min(offset, size - 1);
+    }
+
+    reply.m_Complete = true;
+    for (; offset >= 0 && offset < size; offset += step) {
+        if (request.m_MaxResults > 0 &&
+            reply.m_Offsets.size() >=
+                    static_cast<size_t>(request.m_MaxResults)) {
+            reply.m_Complete = false;
+            reply.m_NextOffset = static_cast<value_t>(offset);
+            break;
+        }
+        const CalledEntryPoint& call = m_Merged[size - 1 - offset];
+        if (request.matches(call)) {
+            reply.m_Offsets.push_back(static_cast<value_t>(offset));
+            if (request.m_WithCalls) {
+                reply.m_Calls.push_back(call);
+            }
+        }
+    }
+}
+
+size_t CallHistory::size() {
+    // Each buffer keeps last CALL_HISTORY_LEN calls, so merged history has
+    // all calls made since clear(), up to CALL_HISTORY_LEN.
+    uint64_t calls = m_Sequence - m_ClearedSequence;
+    return static_cast<size_t>(
+            std::min(calls, static_cast<uint64_t>(CALL_HISTORY_LEN)));
+}
 
 void CallHistory::setRetVal(const RetValue& ret) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_cb.back().setRetVal(ret);
+    ThreadCallHistory* thread = getThreadHistory();
+    std::lock_guard<std::mutex> lock(thread->m_mutex);
+    if (!thread->m_cb.empty()) {
+        thread->m_cb.back().second.setRetVal(ret);
+        thread->m_Version++;
+    }
 }
 
 void CallHistory::setError(GLenum error) {
+    ThreadCallHistory* thread = getThreadHistory();
+    std::lock_guard<std::mutex> lock(thread->m_mutex);
+    if (!thread->m_cb.empty()) {
+        thread->m_cb.back().second.setError(error);
+        thread->m_Version++;
+    }
+}
+
+void CallHistory::clear() {
     std::lock_guard<std::mutex> lock(m_mutex);
-    m_cb.back().setError(error);
+    for (size_t i = 0; i < m_Threads.size(); i++) {
+        std::lock_guard<std::mutex> threadLock(m_Threads[i]->m_mutex);
+        m_Threads[i]->m_cb.clear();
+        m_Threads[i]->m_Version++;
+    }
+    m_Retired.clear();
+    m_MergedValid = false;
+    m_ClearedSequence = m_Sequence.load();
+}
+
+void CallHistory::lock() {
+    m_mutex.lock();
+    for (size_t i = 0; i < m_Threads.size(); i++) {
+        m_Threads[i]->m_mutex.lock();
+    }
+}
+
+void CallHistory::unlock() {
+    for (size_t i = m_Threads.size(); i > 0; i--) {
+        m_Threads[i - 1]->m_mutex.unlock();
+    }
+    m_mutex.unlock();
+}
+
+void CallHistory::forkChild() {
+    // Other threads of parent do not exist here, but their references to
+    // histories were copied and would never be dropped. Start over with new
+    // id, so threads of child register again (history of parent's threads
+    // is leaked once).
+    m_Threads.clear();
+    m_Retired.clear();
+    m_Merged.clear();
+    m_MergedValid = false;
+    m_ClearedSequence = m_Sequence.load();
+    m_Id = s_CallHistoryIds++;
 }
 
 void CallHistory::setDebugOutput(const std::string& message) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_cb.back().setDebugOutput(message);
+    ThreadCallHistory* thread = getThreadHistory();
+    std::lock_guard<std::mutex> lock(thread->m_mutex);
+    if (!thread->m_cb.empty()) {
+        thread->m_cb.back().second.setDebugOutput(message);
+        thread->m_Version++;
+    }
 }
 
 DGLDebugServer::DGLDebugServer(DGLDebugController* parrent)
@@ -173,14 +408,35 @@ void DGLDebugServer::abort() {
     }
 }
 
+void DGLDebugServer::forkChild() {
+    // Mutex may have been held by other thread of parent, which does not
+    // exist here: child starts with fresh one.
+    new (&m_ServerMutex) std::mutex();
+
+    if (m_Transport) {
+        m_Transport->forkChild();
+        m_Transport.reset();
+    }
+}
+
 DGLDebugController::DGLDebugController()
         : m_BreakState(),
           m_Disconnected(false),
           m_Server(this), 
-          m_LastPid(0), 
-          m_ListenMode(DGLIPC::DebuggerListenMode::NO_LISTEN) {}
-
-DGLDebugController::~DGLDebugController() { m_Server.abort(); }
+          m_Pid(0), 
+          m_NewProcess(true),
+          m_SessionReady(false),
+          m_LastPoll(0),
+          m_PollRequested(false),
+          m_ListenMode(DGLIPC::DebuggerListenMode::NO_LISTEN),
+          m_LastStateSnapshotContext(0),
+          m_StateSnapshotCounter(0),
+          m_QueryWorkers(new QueryWorkers(QueryWorkers::defaultCount())) {}
+
+DGLDebugController::~DGLDebugController() {
+    m_QueryWorkers->wait();
+    m_Server.abort();
+}
 
 void DGLDebugController::doHandleListen(const std::string& port) {
     std::string semaphore = Os::getEnv("dgl_semaphore");
@@ -205,6 +461,9 @@ void DGLDebugController::doHandleConnect() {
 
     getBreakState().setEnabled(true);
 
+    // new client has no state snapshots
+    m_LastStateSnapshot.reset();
+
     dglnet::message::Hello hello(Os::getProcessName());
 
     getServer().getTransport()->sendMessage(&hello);
@@ -219,18 +478,20 @@ void DGLDebugController::doHandleDisconnect(const std::string&) {
 }
 
 DGLDebugServer& DGLDebugController::getServer() {
-    int pid;
-    bool newProcess = false;
 
-    if (m_LastPid != (pid = Os::getProcessPid())) {
-        //fork occurred. Reset connection.
-        m_Server.abort();
-        m_LastPid = pid;
+    if (m_NewProcess) {
+        //First call in this process, or in child after fork(). Drop anything
+        //left from parent's session.
+        m_NewProcess = false;
+        m_Pid = Os::getProcessPid();
 
-        newProcess = true;
-    }
+        m_Server.abort();
+        m_Disconnected = false;
+        m_BreakState.reset();
+        m_CallHistory.clear();
+        m_BufferedBacktrace.reset();
+        m_LastStateSnapshot.reset();
 
-    if (newProcess) {
         //Notify process skipper (for posix, exec-less forks of process).
         getIPC()->newProcessNotify();
         m_ListenMode = getIPC()->getCurrentProcessListenMode();
@@ -279,7 +540,7 @@ DGLDebugServer& DGLDebugController::getServer() {
             size_t pos = 0;
             while ((pos = port.find("%p")) != std::string::npos) {
                 std::ostringstream pidStr;
-                pidStr << pid;
+                pidStr << m_Pid;
                 port.replace(pos, 2, pidStr.str());
             }
         }
@@ -305,9 +566,49 @@ DGLDebugServer& DGLDebugController::getServer() {
                 DGL_ASSERT(0);
         }
     }
+
+    // other threads may skip server now, unless they have to wait for
+    // connection
+    m_SessionReady = m_ListenMode == DGLIPC::DebuggerListenMode::NO_LISTEN ||
+                     m_Server.getTransport();
     return m_Server;
 }
 
+std::mutex& DGLDebugController::getServerMutex() {
+    return m_Server.getMutex();
+}
+
+const unsigned int DGLDebugController::kClockCheckInterval = 64;
+
+const std::chrono::steady_clock::duration DGLDebugController::kPollPeriod =
+        std::chrono::milliseconds(5);
+
+bool DGLDebugController::needsServer(const Entrypoint& entryp) {
+    if (!m_SessionReady || m_BreakState.needsBreakCheck(entryp) ||
+        m_PollRequested || IsFrameDelimiter(entryp)) {
+        return true;
+    }
+
+    // reading clock on each call is too expensive, check it every few calls
+    unsigned int& calls =
+            DGLThreadState::get()->privDebugger.m_CallsSinceClockCheck;
+    if (++calls < kClockCheckInterval) {
+        return false;
+    }
+    calls = 0;
+
+    std::chrono::steady_clock::rep now =
+            std::chrono::steady_clock::now().time_since_epoch().count();
+    std::chrono::steady_clock::rep last = m_LastPoll;
+    if (now - last < kPollPeriod.count()) {
+        return false;
+    }
+    // only one of the threads hitting the deadline polls
+    return m_LastPoll.compare_exchange_strong(last, now);
+}
+
+void DGLDebugController::requestPoll() { m_PollRequested = true; }
+
 void DGLDebugController::run_one(bool& newConnection) {
     getServer().getTransport()->run_one();
     
@@ -319,6 +620,9 @@ void DGLDebugController::run_one(bool& newConnection) {
 }
 
 void DGLDebugController::poll() {
+    m_PollRequested = false;
+    m_LastPoll = std::chrono::steady_clock::now().time_since_epoch().count();
+
     dglnet::ITransport* transport = getServer().getTransport().get();
     if (transport) {
         transport->poll();
@@ -337,7 +641,9 @@ void DGLDebugController::onConnectionLost() {
 
     statusPresenter()->setStatus(Os::getProcessName() + ": connection lost");
     
+    m_QueryWorkers->wait();
     m_Server.abort();
+    m_SessionReady = false;
 
     //Disable breaks.
     // So, for example, -nowait application will never break if not connected
@@ -351,18 +657,50 @@ BreakState& DGLDebugController::getBreakState() { return m_BreakState; }
 
 CallHistory& DGLDebugController::getCallHistory() { return m_CallHistory; }
 
+void DGLDebugController::onForkPrepare() {
+    // Server is not locked here: it may be held for long (break waiting for
+    // client, busy query workers) and child drops it anyway. History is
+    // locked per thread only for single calls.
+    m_CallHistory.lock();
+}
+
+void DGLDebugController::onForkParent() { m_CallHistory.unlock(); }
+
+void DGLDebugController::onForkChild() {
+    m_CallHistory.unlock();
+    m_CallHistory.forkChild();
+
+    // Connection is shared with parent: child must not shut it down, even if
+    // it exits without any GL call. Server state is not consistent here, if
+    // other thread of parent was using it, so it is only torn down.
+    m_Server.forkChild();
+
+    // Worker threads do not exist in child, so they cannot be joined: leak
+    // them with their synchronization objects and start from scratch.
+    m_QueryWorkers.release();
+    m_QueryWorkers.reset(new QueryWorkers(QueryWorkers::defaultCount()));
+
+    // Rest of session is dropped on first call in child (see getServer()).
+    m_NewProcess = true;
+    m_SessionReady = false;
+}
+
 void DGLDebugController::doHandleConfiguration(
         const dglnet::message::Configuration& msg) {
     GlobalState::getConfiguration() = msg.m_config;
 }
 void DGLDebugController::doHandleContinueBreak(
         const dglnet::message::ContinueBreak& msg) {
+    // application may not touch GL objects, before workers are done
+    m_QueryWorkers->wait();
     m_BreakState.handle(msg);
 }
 
 void DGLDebugController::doHandleTerminate(
     const dglnet::message::Terminate&) {
 
+    m_QueryWorkers->wait();
+
     //Exiting here would cause locked mutexes and dead thread owning them problem. 
     //So throw, and exit few frames higher, where no locks exist.
     throw TeardownException();
@@ -387,9 +725,14 @@ void DGLDebugController::doHandleRequest(const dglnet::message::Request& msg) {
         // only one request type for now
         if (dynamic_cast<const dglnet::request::QueryResource*>(
                     msg.m_Request.get())) {
-            reply.m_Reply = doHandleRequest(
+            const dglnet::request::QueryResource& query =
                     *dynamic_cast<const dglnet::request::QueryResource*>(
-                             msg.m_Request.get()));
+                             msg.m_Request.get());
+            if (postWorkerQuery(msg.getId(), query)) {
+                // reply will be sent by query worker
+                return;
+            }
+            reply.m_Reply = doHandleRequest(query);
         } else if (dynamic_cast<const dglnet::request::EditShaderSource*>(
                            msg.m_Request.get())) {
             doHandleRequest(
@@ -407,6 +750,16 @@ void DGLDebugController::doHandleRequest(const dglnet::message::Request& msg) {
                 dynamic_cast<const dglnet::request::RequestBenchmarkBuffer*>(
                 msg.m_Request.get())->m_Size);
 
+        } else if (dynamic_cast<const dglnet::request::SearchCallTrace*>(
+                           msg.m_Request.get())) {
+            std::shared_ptr<dglnet::resource::DGLResourceCallTraceSearch>
+                    result = std::make_shared<
+                            dglnet::resource::DGLResourceCallTraceSearch>();
+            getCallHistory().search(
+                    *dynamic_cast<const dglnet::request::SearchCallTrace*>(
+                             msg.m_Request.get()),
+                    *result);
+            reply.m_Reply = result;
         } else {
             reply.error("Cannot handle: unsupported request");
         }
@@ -428,20 +781,15 @@ std::shared_ptr<dglnet::DGLResource> DGLDebugController::doHandleRequest(
 
     std::shared_ptr<dglnet::DGLResource> resource;
 
-    dglState::GLContext* ctx = gc;
+    dglState::GLContext* ctx = getQueryContext(request);
 
-    if (!ctx) {
-        throw std::runtime_error(
-                "No OpenGL Context present, cannot issue query");
-    }
-    if (request.m_ObjectName.m_Context &&
-        ctx->getId() != request.m_ObjectName.m_Context) {
-        throw std::runtime_error(
-                "Object's parent context is not current now, cannot issue "
-                "query");
-    }
     try {
         ctx->startQuery();
+
+        // saves application state touched by query once. Batch of queries
+        // (like pushed resources) may hold outer session.
+        dglState::state_setters::QuerySession session(ctx);
+
         switch (request.m_Type) {
             case dglnet::message::ObjectType::Buffer:
                 resource = ctx->queryBuffer(request.m_ObjectName.m_Name);
@@ -468,6 +816,8 @@ std::shared_ptr<dglnet::DGLResource> DGLDebugController::doHandleRequest(
                 resource = ctx->queryGPU();
                 break;
             case dglnet::message::ObjectType::State:
+                // state of application is reported, not of the queries
+                ctx->getQuerySession()->restore();
                 resource = ctx->queryState(request.m_ObjectName.m_Name);
                 break;
             default:
@@ -486,9 +836,249 @@ std::shared_ptr<dglnet::DGLResource> DGLDebugController::doHandleRequest(
         throw std::runtime_error(message);
     }
 
+    if (request.m_Type == dglnet::message::ObjectType::State) {
+        deltaStateSnapshot(
+                ctx->getId(), request.m_BaseSnapshotId,
+                dynamic_cast<dglnet::resource::DGLResourceState*>(
+                        resource.get()));
+    }
+
     return resource;
 }
 
+bool DGLDebugController::postWorkerQuery(
+        int requestId, const dglnet::request::QueryResource& request) {
+
+    if (request.m_Type != dglnet::message::ObjectType::Buffer &&
+        request.m_Type != dglnet::message::ObjectType::Texture) {
+        return false;
+    }
+
+    dglState::GLContext* ctx = getQueryContext(request);
+
+    std::vector<dglState::GLAuxContext*> auxContexts =
+            ctx->getWorkerAuxContexts(m_QueryWorkers->size());
+    if (auxContexts.empty()) {
+        return false;
+    }
+
+    dglState::GLContext::WorkerQuery query;
+    std::string message;
+    try {
+        ctx->startQuery();
+        if (request.m_Type == dglnet::message::ObjectType::Buffer) {
+            query = ctx->prepareWorkerQueryBuffer(request.m_ObjectName.m_Name);
+        } else {
+            query = ctx->prepareWorkerQueryTexture(request.m_ObjectName.m_Name);
+        }
+    } catch (const std::runtime_error& e) {
+        ctx->endQuery(message);
+        throw e;
+    }
+    if (!ctx->endQuery(message)) {
+        throw std::runtime_error(message);
+    }
+
+    if (!query) {
+        return false;
+    }
+
+    std::shared_ptr<dglnet::ITransport> transport = getServer().getTransport();
+
+    m_QueryWorkers->post(
+            auxContexts, query,
+            [this, transport, requestId](std::shared_ptr<dglnet::DGLResource> resource,
+                                   const std::string& error) {
+                dglnet::message::RequestReply reply;
+                if (error.size()) {
+                    reply.error(error);
+                } else {
+                    reply.m_Reply = resource;
+                }
+                reply.m_RequestId = requestId;
+                transport->postMessage(&reply);
+                requestPoll();
+            });
+
+    return true;
+}
+
+dglState::GLContext* DGLDebugController::getQueryContext(
+        const dglnet::request::QueryResource& request) {
+
+    dglState::GLContext* ctx = gc;
+
+    if (!ctx) {
+        throw std::runtime_error(
+                "No OpenGL Context present, cannot issue query");
+    }
+    if (request.m_ObjectName.m_Context &&
+        ctx->getId() != request.m_ObjectName.m_Context) {
+
+        // textures and buffers of contexts from the same share group can be
+        // queried on current context.
+        bool shareable =
+                request.m_Type == dglnet::message::ObjectType::Buffer ||
+                request.m_Type == dglnet::message::ObjectType::Texture;
+
+        std::shared_ptr<dglState::GLContext> owner;
+        if (shareable) {
+            owner = DGLDisplayState::findContext(request.m_ObjectName.m_Context);
+        }
+
+        if (!owner || !ctx->ns().sharesWith(owner->ns())) {
+            throw std::runtime_error(
+                    "Object's parent context is not current now, cannot issue "
+                    "query");
+        }
+    }
+    return ctx;
+}
+
+const size_t DGLDebugController::kPushedResourcesBudget = 4 * 1024 * 1024;
+
+std::vector<dglnet::message::PushedResource>
+DGLDebugController::queryBoundResources() {
+    std::vector<dglnet::message::PushedResource> ret;
+
+    dglState::GLContext* ctx = gc;
+    if (!ctx) {
+        return ret;
+    }
+
+    std::vector<dglnet::request::QueryResource> queries;
+    try {
+        ctx->startQuery();
+
+        // binding not supported by context reads as 0 and is skipped
+        const struct {
+            GLenum pname;
+            dglnet::message::ObjectType type;
+        } bindings[] = {
+            {GL_DRAW_FRAMEBUFFER_BINDING, dglnet::message::ObjectType::FBO},
+            {GL_CURRENT_PROGRAM, dglnet::message::ObjectType::Program},
+            {GL_ARRAY_BUFFER_BINDING, dglnet::message::ObjectType::Buffer},
+            {GL_ELEMENT_ARRAY_BUFFER_BINDING,
+             dglnet::message::ObjectType::Buffer},
+        };
+        for (size_t i = 0; i < sizeof(bindings) / sizeof(bindings[0]); i++) {
+            GLint name = ctx->getShadowedInteger(bindings[i].pname);
+            if (name) {
+                queries.push_back(dglnet::request::QueryResource(
+                        bindings[i].type,
+                        dglnet::ContextObjectName(ctx->getId(), name)));
+            }
+        }
+
+        const std::vector<std::set<dglnet::ContextObjectName> >& units =
+                ctx->shadow().getTexUnits().report(ctx->getId());
+        for (size_t i = 0; i < units.size(); i++) {
+            for (std::set<dglnet::ContextObjectName>::iterator j =
+                         units[i].begin();
+                 j != units[i].end(); ++j) {
+                queries.push_back(dglnet::request::QueryResource(
+                        dglnet::message::ObjectType::Texture, *j));
+            }
+        }
+    } catch (const std::runtime_error&) {
+        // context cannot be queried now (ex. immediate mode) - push nothing
+        std::string sink;
+        ctx->endQuery(sink);
+        return ret;
+    }
+    std::string sink;
+    ctx->endQuery(sink);
+
+    // application state is saved on first query and restored after last
+    dglState::state_setters::QuerySession session(ctx);
+
+    size_t pushedSize = 0;
+    for (size_t i = 0; i < queries.size(); i++) {
+        bool duplicate = false;
+        for (size_t j = 0; j < ret.size(); j++) {
+            if (ret[j].m_Type == queries[i].m_Type &&
+                ret[j].m_ObjectName == queries[i].m_ObjectName) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate) {
+            continue;
+        }
+
+        // do not read objects known to be too big
+        if (pushedSize + estimateDataSize(ctx, queries[i]) >
+            kPushedResourcesBudget) {
+            continue;
+        }
+
+        std::shared_ptr<dglnet::DGLResource> resource;
+        try {
+            resource = doHandleRequest(queries[i]);
+        } catch (const std::runtime_error&) {
+            // client will get the error, when it requests this object
+            continue;
+        }
+        if (pushedSize + resource->getDataSize() > kPushedResourcesBudget) {
+            continue;
+        }
+        pushedSize += resource->getDataSize();
+        ret.push_back(dglnet::message::PushedResource(
+                queries[i].m_Type, queries[i].m_ObjectName, resource));
+    }
+
+    // restore in query mode, so errors do not leak to application
+    try {
+        ctx->startQuery();
+        session.restore();
+    } catch (const std::runtime_error&) {
+        // cannot happen after successful queries above; session restores
+        // state when destroyed anyway.
+    }
+    ctx->endQuery(sink);
+    return ret;
+}
+
+size_t DGLDebugController::estimateDataSize(
+        dglState::GLContext* ctx, const dglnet::request::QueryResource& query) {
+    GLuint name = static_cast<GLuint>(query.m_ObjectName.m_Name);
+    dglState::GLShareableObjectsAccessor accessor = ctx->ns().getShared();
+    switch (query.m_Type) {
+        case dglnet::message::ObjectType::Texture: {
+            dglState::GLTextureObj* tex =
+                    accessor.get().m_Textures.getObject(name);
+            return tex ? tex->getKnownDataSize() : 0;
+        }
+        case dglnet::message::ObjectType::Buffer: {
+            dglState::GLBufferObj* buff =
+                    accessor.get().m_Buffers.getObject(name);
+            if (buff && buff->getSize() != dglState::GLBufferObj::kUnknownSize) {
+                return static_cast<size_t>(buff->getSize());
+            }
+            return 0;
+        }
+        default:
+            return 0;
+    }
+}
+
+void DGLDebugController::deltaStateSnapshot(
+        opaque_id_t context, opaque_id_t clientSnapshotId,
+        dglnet::resource::DGLResourceState* state) {
+    state->m_SnapshotId = ++m_StateSnapshotCounter;
+
+    std::shared_ptr<dglnet::resource::DGLResourceState> snapshot =
+            std::make_shared<dglnet::resource::DGLResourceState>(*state);
+
+    if (m_LastStateSnapshot && m_LastStateSnapshotContext == context &&
+        m_LastStateSnapshot->m_SnapshotId == clientSnapshotId) {
+        state->makeDelta(clientSnapshotId, m_LastStateSnapshot->m_Items);
+    }
+
+    m_LastStateSnapshot = snapshot;
+    m_LastStateSnapshotContext = context;
+}
+
 void DGLDebugController::doHandleRequest(
         const dglnet::request::EditShaderSource& request) {
     dglState::GLContext* ctx = gc;
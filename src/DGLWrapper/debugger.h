@@ -28,7 +28,10 @@
 #include <DGLCommon/ipc.h>
 
 #include "gl-context.h"
+#include "query-workers.h"
 
+#include <atomic>
+#include <chrono>
 #include <mutex>
 
 /**
@@ -42,11 +45,25 @@ class BreakState {
      */
     BreakState();
 
+    /**
+     * Return to initial state (of new session)
+     */
+    void reset();
+
     /**
      * Enable/disable breaking.
      */
     void setEnabled(bool enabled);
 
+    /**
+     * Lock-free check, if application may be breaked at given entrypoint: break
+     * is pending, step mode is enabled or breakpoint is set on entrypoint.
+     *
+     * Does not modify break state. If true, mayBreakAt() should be called
+     * (under server lock).
+     */
+    bool needsBreakCheck(const Entrypoint&);
+
     /**
      * Method deciding if application should be breaked at given entrypoint
      * this method considers earlier set breaks and breakpoint list
@@ -105,7 +122,7 @@ class BreakState {
     /**
      * application break state (true if breaked, false otherwise)
      */
-    bool m_break;
+    std::atomic<bool> m_break;
 
     /** 
      * Breaking enable.
@@ -113,13 +130,13 @@ class BreakState {
      * May break only if this is set to true.
      * Set to false when running disconnected in -nowait mode.
      */
-    bool m_BreakingEnabled;
+    std::atomic<bool> m_BreakingEnabled;
 
     /**
      * True if in step mode (pending break, despite m_break == false)
      * irrelevant, if m_break == true
      */
-    bool m_StepModeEnabled;
+    std::atomic<bool> m_StepModeEnabled;
 
     /**
      * Actual step mode (call, draw call, frame) if in step mode
@@ -128,9 +145,9 @@ class BreakState {
     dglnet::message::StepMode m_StepMode;
 
     /**
-     * List of actually set breakpoints
+     * Actually set breakpoints, indexed by entrypoint (read without lock)
      */
-    std::set<Entrypoint> m_BreakPoints;
+    std::unique_ptr<std::atomic<bool>[]> m_BreakPoints;
 };
 
 /**
@@ -138,8 +155,44 @@ class BreakState {
  */
 #define CALL_HISTORY_LEN 5000
 
+/**
+ * Call history of single thread
+ */
+struct ThreadCallHistory {
+    ThreadCallHistory();
+
+    /**
+     * Called entrypoint with its sequence number (order of calls of all
+     * threads)
+     */
+    typedef std::pair<uint64_t, CalledEntryPoint> Entry;
+
+    typedef boost::circular_buffer_space_optimized<Entry> Buffer;
+
+    /**
+     * Round buffer with called entrypoints, in sequence order
+     */
+    Buffer m_cb;
+
+    /**
+     * Bumped on each modification of m_cb
+     */
+    uint64_t m_Version;
+
+    /**
+     * Mutex locked by owning thread on modification, and when history is
+     * merged
+     */
+    std::mutex m_mutex;
+};
+
 /**
  * round buffer with call history
+ *
+ * Each thread adds calls to its own buffer, so threads do not contend on
+ * history. Calls are ordered by global sequence number. Buffers are merged
+ * only when calls are read (query, search); histories of exited threads are
+ * folded into one buffer.
  */
 class CallHistory {
    public:
@@ -160,7 +213,13 @@ class CallHistory {
                dglnet::message::CallTrace& reply);
 
     /**
-     * Getter for call history size
+     * Search history for calls matching request
+     */
+    void search(const dglnet::request::SearchCallTrace& request,
+                dglnet::resource::DGLResourceCallTraceSearch& reply);
+
+    /**
+     * Getter for call history size (does not merge history)
      */
     size_t size();
 
@@ -179,14 +238,88 @@ class CallHistory {
      */
     void setDebugOutput(const std::string& message);
 
+    /**
+     * Remove all elements from history (child process starts with empty one)
+     */
+    void clear();
+
+    /**
+     * Lock history, so it is not modified (used across fork())
+     */
+    void lock();
+
+    /**
+     * Unlock history locked with lock()
+     */
+    void unlock();
+
+    /**
+     * Drop histories of parent's threads in child process, after fork().
+     * Threads of child register again.
+     */
+    void forkChild();
+
    private:
     /**
-     * Actual round buffer with called entrypoints
+     * Get history of calling thread, register one if needed
+     */
+    ThreadCallHistory* getThreadHistory();
+
+    /**
+     * Fold histories of exited threads into m_Retired. Called with m_mutex
+     * locked.
+     */
+    void retireExited();
+
+    /**
+     * Rebuild m_Merged, if any thread history was modified since last merge.
+     * Called with m_mutex locked.
+     */
+    void merge();
+
+    /**
+     * Histories of threads, that called GL. Exited threads drop their
+     * references.
+     */
+    std::vector<std::shared_ptr<ThreadCallHistory> > m_Threads;
+
+    /**
+     * Last CALL_HISTORY_LEN calls of exited threads, in sequence order
+     */
+    ThreadCallHistory::Buffer m_Retired;
+
+    /**
+     * Last CALL_HISTORY_LEN calls of all threads, in call order
+     */
+    std::vector<CalledEntryPoint> m_Merged;
+
+    /**
+     * Sum of thread history versions, m_Merged was built from
+     */
+    uint64_t m_MergedVersion;
+
+    /**
+     * False if threads were retired or history was cleared since last merge
+     */
+    bool m_MergedValid;
+
+    /**
+     * Sequence number of next call
+     */
+    std::atomic<uint64_t> m_Sequence;
+
+    /**
+     * Value of m_Sequence, when history was last cleared
      */
-    boost::circular_buffer<CalledEntryPoint> m_cb;
+    std::atomic<uint64_t> m_ClearedSequence;
 
     /**
-     * Mutex used to access this class
+     * Unique id of this object (thread states refer to it)
+     */
+    uint64_t m_Id;
+
+    /**
+     * Mutex guarding thread list and merged history
      */
     std::mutex m_mutex;
 };
@@ -229,6 +362,12 @@ class DGLDebugServer {
      */
     void abort();
 
+    /**
+     * Drop connection inherited from parent process, after fork(). Does not
+     * wait for server mutex (it is reset).
+     */
+    void forkChild();
+
    private:
     /**
      * Server object
@@ -296,6 +435,31 @@ class DGLDebugController : public dglnet::MessageHandler {
      */
     DGLDebugServer& getServer();
 
+    /**
+     * Getter for mutex guarding server. Unlike getServer().getMutex(), does
+     * not touch server, so server can be used under this lock.
+     */
+    std::mutex& getServerMutex();
+
+    /**
+     * Lock-free check, if call of entrypoint needs server: session is not
+     * started yet, break is pending (or breakpoint set) or it is time to poll
+     * client messages. Other calls do not take server lock, so threads making
+     * them run concurrently.
+     *
+     * Client messages are polled on frame boundaries, when poll was requested
+     * by requestPoll(), and otherwise at most once per kPollPeriod. This
+     * bounds latency of run-mode commands (like break request) to kPollPeriod
+     * plus time of kClockCheckInterval calls.
+     */
+    bool needsServer(const Entrypoint& entryp);
+
+    /**
+     * Thread-safe: make next call poll server, for work posted to transport
+     * from other threads.
+     */
+    void requestPoll();
+
     /**
      * Run one event on associated server;
      */
@@ -316,6 +480,25 @@ class DGLDebugController : public dglnet::MessageHandler {
      */
     CallHistory& getCallHistory();
 
+    /**
+     * fork() prepare handler. Locks history, so child gets consistent copy of
+     * it. Server is not locked: child drops session inherited from parent.
+     */
+    void onForkPrepare();
+
+    /**
+     * fork() handler called in parent process. Unlocks state locked in
+     * onForkPrepare().
+     */
+    void onForkParent();
+
+    /**
+     * fork() handler called in child process. Unlocks state locked in
+     * onForkPrepare(), tears down session inherited from parent and marks
+     * it dirty. New session is started on first call in child.
+     */
+    void onForkChild();
+
     /**
      * Message handler - pass configuration message to global configuration
      * object
@@ -355,6 +538,42 @@ class DGLDebugController : public dglnet::MessageHandler {
     std::shared_ptr<dglnet::DGLResource> doHandleRequest(
             const dglnet::request::QueryResource&);
 
+    /**
+     * Request handler - try to pass query resource request to query workers.
+     * Returns false, if query must be handled on application thread. Reply
+     * is sent by query worker.
+     */
+    bool postWorkerQuery(int requestId,
+                         const dglnet::request::QueryResource& request);
+
+    /**
+     * Getter for context, where resource query can be issued. This is current
+     * context, or any context sharing given resource with it.
+     */
+    dglState::GLContext* getQueryContext(
+            const dglnet::request::QueryResource& request);
+
+    /**
+     * Query resources of objects bound to current context (draw FBO, program,
+     * textures on texture units, array and element buffers), so they can be
+     * pushed to client together with BreakedCall. Objects, that cannot be
+     * queried or do not fit in kPushedResourcesBudget are skipped - client
+     * will request them as usual.
+     */
+    std::vector<dglnet::message::PushedResource> queryBoundResources();
+
+    /**
+     * Lower bound of data size of queried resource, estimated from tracked
+     * object metadata without touching GL (0 if not known).
+     */
+    size_t estimateDataSize(dglState::GLContext* ctx,
+                            const dglnet::request::QueryResource& query);
+
+    /**
+     * Limit of pixel and buffer data pushed with single break
+     */
+    static const size_t kPushedResourcesBudget;
+
     /**
      * Request handler - edit shader request
      */
@@ -365,6 +584,13 @@ class DGLDebugController : public dglnet::MessageHandler {
      */
     void doHandleRequest(const dglnet::request::ForceLinkProgram&);
 
+    /**
+     * part of state resource handler - reduce state snapshot to delta against
+     * snapshot already held by client
+     */
+    void deltaStateSnapshot(opaque_id_t context, opaque_id_t clientSnapshotId,
+                            dglnet::resource::DGLResourceState* state);
+
     /**
      * part of backtrace resource handler - get current backtrace
      */
@@ -416,11 +642,44 @@ class DGLDebugController : public dglnet::MessageHandler {
     DGLDebugServer m_Server;
 
     /**
-     * Last pid of process
-     *
-     * Used for fork() detection and restaring Transport on process change
+     * Pid of process, set when session is started
+     */
+    int m_Pid;
+
+    /**
+     * True if session should be (re)started on next call: in new process, or
+     * in child after fork().
+     */
+    bool m_NewProcess;
+
+    /**
+     * True if session is started and calls may skip server, false if they
+     * should wait for (or establish) the connection
+     */
+    std::atomic<bool> m_SessionReady;
+
+    /**
+     * Time of last poll of client messages (in steady_clock ticks)
+     */
+    std::atomic<std::chrono::steady_clock::rep> m_LastPoll;
+
+    /**
+     * True if some work was posted to transport, and should be polled on
+     * next call
+     */
+    std::atomic<bool> m_PollRequested;
+
+    /**
+     * Number of calls made by thread, after which it checks clock for
+     * periodic poll
+     */
+    static const unsigned int kClockCheckInterval;
+
+    /**
+     * Maximal time between polls of client messages, while application is
+     * making calls
      */
-    int m_LastPid;
+    static const std::chrono::steady_clock::duration kPollPeriod;
 
     /**
      * Current listen mode of debugger.
@@ -432,6 +691,26 @@ class DGLDebugController : public dglnet::MessageHandler {
      * Backtrace valid for current debugger state;
      */
     std::shared_ptr<dglnet::DGLResource> m_BufferedBacktrace;
+
+    /**
+     * Last full state snapshot sent on current connection
+     */
+    std::shared_ptr<dglnet::resource::DGLResourceState> m_LastStateSnapshot;
+
+    /**
+     * Context of last state snapshot
+     */
+    opaque_id_t m_LastStateSnapshotContext;
+
+    /**
+     * Id generator for state snapshots
+     */
+    opaque_id_t m_StateSnapshotCounter;
+
+    /**
+     * Workers performing resource queries concurrently on auxiliary contexts.
+     */
+    std::unique_ptr<QueryWorkers> m_QueryWorkers;
 };
 
 /**
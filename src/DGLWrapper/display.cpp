@@ -51,17 +51,25 @@ DGLDisplayState* DGLDisplayState::get(opaque_id_t dpy,
 
 void DGLDisplayState::createContext(
         dglState::GLContextVersion version,
-        dglState::GLContextCreationData creationData, opaque_id_t id) {
+        dglState::GLContextCreationData creationData, opaque_id_t id,
+        opaque_id_t shareId) {
     std::lock_guard<std::mutex> lock(m_ContextListMutex);
 
     ContextListIter i = m_ContextList.find(id);
     if (i == m_ContextList.end()) {
-        m_ContextList.insert(std::pair<opaque_id_t,
+        i = m_ContextList.insert(std::pair<opaque_id_t,
                                        std::shared_ptr<dglState::GLContext> >(
                                      id,
                                      std::make_shared<dglState::GLContext>(
                                              this, version, id, creationData)))
                 .first;
+
+        if (shareId) {
+            ContextListIter shared = m_ContextList.find(shareId);
+            if (shared != m_ContextList.end()) {
+                i->second->ns().shareWith(shared->second->ns());
+            }
+        }
     }
 }
 
@@ -183,6 +191,24 @@ DGLDisplayState::describeAll() {
     return ret;
 }
 
+std::shared_ptr<dglState::GLContext> DGLDisplayState::findContext(
+        opaque_id_t id) {
+    std::lock_guard<std::mutex> quard(s_DisplaysMutex);
+
+    for (std::map<opaque_id_t, std::shared_ptr<DGLDisplayState> >::iterator
+                 i = s_Displays.begin();
+         i != s_Displays.end(); ++i) {
+
+        std::lock_guard<std::mutex> contextQuard(i->second->m_ContextListMutex);
+
+        ContextListIter ctx = i->second->m_ContextList.find(id);
+        if (ctx != i->second->m_ContextList.end()) {
+            return ctx->second;
+        }
+    }
+    return std::shared_ptr<dglState::GLContext>();
+}
+
 DGLDisplayState::Type DGLDisplayState::getType() const { return m_type; }
 
 std::map<opaque_id_t, std::shared_ptr<DGLDisplayState> >
@@ -70,11 +70,12 @@ class DGLDisplayState {
     static DGLDisplayState* get(opaque_id_t dpy, DGLDisplayState::Type type);
 
     /**
-     * Creates new context
+     * Creates new context. If shareId is given, new context joins share group
+     * of that context.
      */
     void createContext(dglState::GLContextVersion version,
                        dglState::GLContextCreationData creationData,
-                       opaque_id_t id);
+                       opaque_id_t id, opaque_id_t shareId = 0);
 
     /**
      * Getter for ctx object by given id
@@ -123,6 +124,12 @@ class DGLDisplayState {
     static std::vector<dglnet::message::utils::ContextReport>
             describeAll();
 
+    /**
+     * Lookup of context object by given id on all displays. Returns null
+     * pointer, if context is not known.
+     */
+    static std::shared_ptr<dglState::GLContext> findContext(opaque_id_t id);
+
     /**
      * Getter for display type
      */
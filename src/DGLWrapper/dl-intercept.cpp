@@ -183,7 +183,7 @@ class ELFAnalyzer {
  */
 DLIntercept g_DLIntercept;
 
-DLIntercept::DLIntercept() : m_initialized(false) {}
+DLIntercept::DLIntercept() : mSupportedLibraries(nullptr), m_initialized(false) {}
 
 void *DLIntercept::real_dlsym(void *handle, const char *name) {
     if (!m_initialized) {
@@ -227,26 +227,32 @@ void *DLIntercept::dlvsym(void *handle, const char *name, const char *version) {
 }
 
 void *DLIntercept::dlsymImpl(void *handle, const char *name, void *ptr) {
-    std::lock_guard<std::recursive_mutex> lock(mutex);
 
-    std::map<uint64_t, int>::iterator i =
-            mSupportedLibraries.find(reinterpret_cast<uint64_t>(handle));
+    // Most of dlsym calls are for libraries & symbols unrelated to GL. These
+    // are rejected here without locking or allocating anything.
+    int libraries = LIBRARY_NONE;
+    if (ptr) {    // entrypoint pointer is not NULL
+        libraries = getSupportedLibraries(handle);
+    }
 
-    Entrypoint entryp = GetEntryPointEnum(name);
+    Entrypoint entryp = NO_ENTRYPOINT;
+    if (libraries != LIBRARY_NONE) {    // library from handle is supported
+                                        // by debugger
+        entryp = GetEntryPointEnum(name);
+    }
 
-    if (ptr &&                        // entrypoint pointer is not NULL
-        entryp != NO_ENTRYPOINT &&    // entrypoint is supported by debugger
-        !DGLThreadState::get()->inActionProcessing() &&    // dlsym was not
-                                                           // emited by GL
-                                                           // implementation
-        i != mSupportedLibraries.end() &&    // library from handle is supported
-                                             // by debugger
-        (i->second &
+    if (entryp != NO_ENTRYPOINT &&    // entrypoint is supported by debugger
+        (libraries &
          EarlyGlobalState::getApiLoader().getEntryPointLibrary(
-                 entryp))    // library from handle match entrypoint library
-                             // mask
+                 entryp)) &&    // library from handle match entrypoint library
+                                // mask
+        !DGLThreadState::get()->inActionProcessing()    // dlsym was not
+                                                        // emited by GL
+                                                        // implementation
         ) {
 
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+
         // set debugger to use new entrypoint
         EarlyGlobalState::getApiLoader().setPointer(
                 entryp, reinterpret_cast<dgl_func_ptr>((ptrdiff_t)ptr));
@@ -303,7 +309,7 @@ void *DLIntercept::dlopen(const char *filename, int flag) {
         }
 #endif
         if (libraries != LIBRARY_NONE) {
-            mSupportedLibraries[reinterpret_cast<uint64_t>(ret)] = libraries;
+            addSupportedLibrary(ret, libraries);
         }
     }
 
@@ -314,6 +320,50 @@ void *DLIntercept::dlopen(const char *filename, int flag) {
     return ret;
 }
 
+int DLIntercept::getSupportedLibraries(void *handle) const {
+    const SupportedLibraries *libraries =
+            mSupportedLibraries.load(std::memory_order_acquire);
+    if (libraries) {
+        for (SupportedLibraries::const_iterator i = libraries->begin();
+             i != libraries->end(); ++i) {
+            if (i->first == handle) {
+                return i->second;
+            }
+        }
+    }
+    return LIBRARY_NONE;
+}
+
+void DLIntercept::addSupportedLibrary(void *handle, int libraries) {
+    const SupportedLibraries *current =
+            mSupportedLibraries.load(std::memory_order_relaxed);
+
+    std::shared_ptr<SupportedLibraries> updated =
+            std::make_shared<SupportedLibraries>();
+    if (current) {
+        *updated = *current;
+    }
+
+    bool found = false;
+    for (SupportedLibraries::iterator i = updated->begin();
+         i != updated->end(); ++i) {
+        if (i->first == handle) {
+            if (i->second == libraries) {
+                // library opened again - nothing to publish
+                return;
+            }
+            i->second = libraries;
+            found = true;
+        }
+    }
+    if (!found) {
+        updated->push_back(std::make_pair(handle, libraries));
+    }
+
+    mSupportedLibrariesTables.push_back(updated);
+    mSupportedLibraries.store(updated.get(), std::memory_order_release);
+}
+
 void DLIntercept::initializeInternal() {
     m_initialized = true;
 #ifndef __ANDROID__
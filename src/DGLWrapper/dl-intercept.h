@@ -17,6 +17,9 @@
 
 #ifndef _WIN32
 #include <map>
+#include <vector>
+#include <memory>
+#include <atomic>
 #include <dlfcn.h>
 #include <mutex>
 
@@ -105,6 +108,18 @@ class DLIntercept {
      */
     void* dlsymImpl(void* handle, const char* name, void* ptr);
 
+    /**
+     * Get ApiLibrary mask of library opened with given handle. Lock-free,
+     * LIBRARY_NONE for handles of libraries not supported by debugger.
+     */
+    int getSupportedLibraries(void* handle) const;
+
+    /**
+     * Publish copy of supported libraries table with given library added.
+     * Must be called with mutex locked.
+     */
+    void addSupportedLibrary(void* handle, int libraries);
+
     /**
      * Internal, ad-hoc initialization of class singleton
      */
@@ -126,9 +141,21 @@ class DLIntercept {
     void* (*m_real_dlopen)(const char* filename, int flag);
 
     /**
-     * Map of all matched libraries, gathered by overriding dlopen calls
+     * Table of all matched libraries, gathered by overriding dlopen calls
+     */
+    typedef std::vector<std::pair<void*, int> > SupportedLibraries;    // handle -> ApiLibrary mask
+
+    /**
+     * Current table of supported libraries. Tables are never modified after
+     * publishing (copy-on-write), so dlsym may read it without locking.
+     */
+    std::atomic<const SupportedLibraries*> mSupportedLibraries;
+
+    /**
+     * All published tables. These are kept alive, as concurrent dlsym may
+     * still read them. There are only a few: GL libraries are rarely opened.
      */
-    std::map<uint64_t, int> mSupportedLibraries;    // handle -> ApiLibrary mask
+    std::vector<std::shared_ptr<const SupportedLibraries> > mSupportedLibrariesTables;
 
     /**
      * True if initialized, false if initializeInternal should be called before
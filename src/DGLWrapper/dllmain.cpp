@@ -21,6 +21,7 @@
 #include "globalstate.h"
 #include "exechook.h"
 #include "dl-intercept.h"
+#include "tls.h"
 #include "DGLWrapper.h"
 #include <boost/interprocess/sync/named_semaphore.hpp>
 
@@ -30,6 +31,9 @@
 
 #include <DGLCommon/os.h>
 #include <atomic>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
 #include <thread>
 #include <condition_variable>
 
@@ -54,6 +58,10 @@ void Initialize(void) {
 #ifdef _WIN32
     // catch all CreateProcess calls on Windows
     ExecHook::initialize();
+#else
+    // fork() starts new debugging session in child, see GlobalState::forkChild
+    pthread_atfork(GlobalState::forkPrepare, GlobalState::forkParent,
+                   GlobalState::forkChild);
 #endif
 
     //Notify process skipper (for newly executed processes).
@@ -184,6 +192,7 @@ DllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID /*lpReserved*/
 #if DGL_HAVE_WA(ARM_MALI_EMU_LOADERTHREAD_KEEP)
             g_ThreadWatcher.onDettachThread();
 #endif
+            DGLThreadState::releaseThread();
             break;
         case DLL_PROCESS_DETACH:
             TearDown();
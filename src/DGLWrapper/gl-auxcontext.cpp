@@ -20,6 +20,7 @@
 #include "pointers.h"
 
 #include <DGLNet/protocol/pixeltransfer.h>
+#include <DGLNet/protocol/resource.h>
 
 #include <sstream>
 #include <DGLCommon/def.h>
@@ -104,9 +105,35 @@ GLAuxWGLContextSurface::~GLAuxWGLContextSurface() {
 
 #endif 
 
+#ifdef HAVE_LIBRARY_GLX
+
+GLAuxGLXContextSurface::GLAuxGLXContextSurface(const DGLDisplayState* display,
+                                               opaque_id_t pixfmt, GLint width, GLint height)
+        : GLAuxContextSurfaceBase(display) {
+
+    const int attributes[] = {GLX_PBUFFER_WIDTH, width, GLX_PBUFFER_HEIGHT,
+                              height, GLX_PRESERVED_CONTENTS, True, None};
+
+    m_Id = (opaque_id_t)DIRECT_CALL_CHK(glXCreatePbuffer)(
+            (Display*)m_DisplayId, (GLXFBConfig)pixfmt, attributes);
+    if (!m_Id) {
+        throw std::runtime_error("Cannot allocate axualiary pbuffer surface");
+    }
+}
+
+GLAuxGLXContextSurface::~GLAuxGLXContextSurface() {
+    if (m_Id) {
+        DIRECT_CALL_CHK(glXDestroyPbuffer)((Display*)m_DisplayId,
+                                           (GLXPbuffer)m_Id);
+    }
+}
+
+#endif
+
 GLAuxContext::GLAuxContext(const GLContext* parrent)
         : queries(this),
           m_MakeCurrentRef(0),
+          m_Detached(false),
           m_Id(0),
           m_PixelFormat(0),
           m_Parrent(parrent) {}
@@ -129,6 +156,12 @@ std::shared_ptr<GLAuxContext> GLAuxContext::Create(const GLContext* parrent) {
     }
 #endif
 
+#ifdef HAVE_LIBRARY_GLX
+    if (parrent->getDisplay()->getType() == DGLDisplayState::Type::GLX) {
+        return std::make_shared<GLGLXAuxContext>(parrent);
+    }
+#endif
+
     throw std::runtime_error("auxaliary contexts not implemented for this platform");
 }
 
@@ -143,7 +176,11 @@ void GLAuxContext::resizeAuxSurface(GLint width, GLint height) {
     try {
 
         //ubnind the surface
-        unmakeCurrent();
+        if (m_Detached) {
+            releaseCurrent();
+        } else {
+            unmakeCurrent();
+        }
 
         //allocate new surface of proper size
         m_AuxSurface = createNewSurface(width, height);
@@ -164,6 +201,8 @@ void GLAuxContext::resizeAuxSurface(GLint width, GLint height) {
 
 }
 
+void GLAuxContext::setDetached(bool detached) { m_Detached = detached; }
+
 void GLAuxContext::doRefCurrent() {
 
     if (!m_MakeCurrentRef) {
@@ -180,7 +219,7 @@ bool GLAuxContext::doUnrefCurrent() {
         m_MakeCurrentRef--;
     }
     if (!m_MakeCurrentRef) {
-        if (!unmakeCurrent()) {
+        if (!(m_Detached ? releaseCurrent() : unmakeCurrent())) {
             return false;
         }
     }
@@ -287,6 +326,16 @@ std::shared_ptr<GLAuxContextSurfaceBase> GLEGLAuxContext::createNewSurface(GLint
 }
 
 bool GLEGLAuxContext::makeCurrent() {
+    if (m_Detached) {
+        // rendering API is per-thread state: worker threads start with
+        // OpenGL ES bound.
+        if (!DIRECT_CALL_CHK(eglBindAPI)(
+                    m_Parrent->getVersion().check(GLContextVersion::Type::DT)
+                            ? EGL_OPENGL_API
+                            : EGL_OPENGL_ES_API)) {
+            return false;
+        }
+    }
     EGLBoolean status = DIRECT_CALL_CHK(eglMakeCurrent)(
             (EGLDisplay)m_Parrent->getDisplay()->getId(),
             (EGLSurface)m_AuxSurface->getId(),
@@ -305,6 +354,14 @@ bool GLEGLAuxContext::unmakeCurrent() {
     return status == EGL_TRUE;
 }
 
+bool GLEGLAuxContext::releaseCurrent() {
+    EGLBoolean status = DIRECT_CALL_CHK(eglMakeCurrent)(
+            (EGLDisplay)m_Parrent->getDisplay()->getId(), EGL_NO_SURFACE,
+            EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+    return status == EGL_TRUE;
+}
+
 #ifdef _WIN32
 
 GLWGLAuxContext::GLWGLAuxContext(const GLContext* parrent)
@@ -423,6 +480,130 @@ bool GLWGLAuxContext::unmakeCurrent() {
     return status != FALSE;
 }
 
+bool GLWGLAuxContext::releaseCurrent() {
+    BOOL status = DIRECT_CALL_CHK(wglMakeCurrent)(NULL, NULL);
+    return status != FALSE;
+}
+
+#endif
+
+#ifdef HAVE_LIBRARY_GLX
+
+GLGLXAuxContext::GLGLXAuxContext(const GLContext* parrent)
+        : GLAuxContext(parrent) {
+
+    const GLContextCreationData& ctxCreationData = m_Parrent->getContextCreationData();
+    const std::vector<gl_t>& ctxAttributes = ctxCreationData.getAttribs();
+
+    std::vector<int> glxAttributes(ctxAttributes.size());
+
+    for (size_t i = 0; i < ctxAttributes.size(); i++) {
+        glxAttributes[i] = (int)ctxAttributes[i];
+    }
+    glxAttributes.push_back(None);
+
+    Display* dpy = (Display*)m_Parrent->getDisplay()->getId();
+
+    m_PixelFormat = choosePixelFormat(ctxCreationData.getPixelFormat(),
+                                      m_Parrent->getDisplay()->getId());
+
+    // contexts are always created with shared object namespace, so aux
+    // context can access all objects of parrent
+    switch (ctxCreationData.getEntryPoint()) {
+        case glXCreateContext_Call:
+        case glXCreateNewContext_Call:
+            m_Id = (opaque_id_t)DIRECT_CALL_CHK(glXCreateNewContext)(
+                    dpy, (GLXFBConfig)m_PixelFormat, GLX_RGBA_TYPE,
+                    (GLXContext)m_Parrent->getId(), True);
+            break;
+        case glXCreateContextAttribsARB_Call:
+            m_Id = (opaque_id_t)DIRECT_CALL_CHK(glXCreateContextAttribsARB)(
+                    dpy, (GLXFBConfig)m_PixelFormat,
+                    (GLXContext)m_Parrent->getId(), True, &glxAttributes[0]);
+            break;
+    }
+
+    if (!m_Id) {
+        throw std::runtime_error("Cannot allocate auxiliary context");
+    }
+
+    m_AuxSurface = createNewSurface();
+}
+
+GLGLXAuxContext::~GLGLXAuxContext() {
+    if (m_Id) {
+        DIRECT_CALL_CHK(glXDestroyContext)(
+                (Display*)m_Parrent->getDisplay()->getId(), (GLXContext)m_Id);
+    }
+}
+
+opaque_id_t GLGLXAuxContext::choosePixelFormat(opaque_id_t preferred,
+                                               opaque_id_t displayId) {
+    Display* dpy = (Display*)displayId;
+    GLXFBConfig preferredConfig = (GLXFBConfig)preferred;
+    int supportedDrawableType = 0;
+
+    if (DIRECT_CALL_CHK(glXGetFBConfigAttrib)(dpy, preferredConfig,
+                                              GLX_DRAWABLE_TYPE,
+                                              &supportedDrawableType) != Success) {
+        throw std::runtime_error("Cannot query GLXFBConfig associated with ctx");
+    }
+
+    if (supportedDrawableType & GLX_PBUFFER_BIT) {
+        return preferred;
+    }
+
+    const int attributes[] = {GLX_DRAWABLE_TYPE, GLX_PBUFFER_BIT,
+                              GLX_RENDER_TYPE,   GLX_RGBA_BIT,
+                              None};
+    int numConfigs = 0;
+    GLXFBConfig* configs = DIRECT_CALL_CHK(glXChooseFBConfig)(
+            dpy, DefaultScreen(dpy), attributes, &numConfigs);
+
+    if (!configs || numConfigs < 1) {
+        if (configs) {
+            XFree(configs);
+        }
+        throw std::runtime_error(
+                "Cannot choose GLXFBConfig capable of driving auxaliary "
+                "context");
+    }
+    GLXFBConfig ret = configs[0];
+    XFree(configs);
+    return (opaque_id_t)ret;
+}
+
+std::shared_ptr<GLAuxContextSurfaceBase> GLGLXAuxContext::createNewSurface(GLint width, GLint height) {
+    return std::make_shared<GLAuxGLXContextSurface>(
+            m_Parrent->getDisplay(), m_PixelFormat, width, height);
+}
+
+bool GLGLXAuxContext::makeCurrent() {
+    Bool status = DIRECT_CALL_CHK(glXMakeContextCurrent)(
+            (Display*)m_Parrent->getDisplay()->getId(),
+            (GLXDrawable)m_AuxSurface->getId(),
+            (GLXDrawable)m_AuxSurface->getId(), (GLXContext)m_Id);
+
+    return status == True;
+}
+
+bool GLGLXAuxContext::unmakeCurrent() {
+    Bool status = DIRECT_CALL_CHK(glXMakeContextCurrent)(
+            (Display*)m_Parrent->getDisplay()->getId(),
+            (GLXDrawable)m_Parrent->getNativeDrawSurface()->getId(),
+            (GLXDrawable)m_Parrent->getNativeReadSurface()->getId(),
+            (GLXContext)m_Parrent->getId());
+
+    return status == True;
+}
+
+bool GLGLXAuxContext::releaseCurrent() {
+    Bool status = DIRECT_CALL_CHK(glXMakeContextCurrent)(
+            (Display*)m_Parrent->getDisplay()->getId(), None, None, NULL);
+
+    return status == True;
+}
+
 #endif
 
 const size_t GLAuxContext::GLQueries::kBufferGetterChunkSize = 256;
@@ -547,11 +728,13 @@ void GLAuxContext::GLQueries::setupInitialState() {
                 "}\n";
 
             const char* fsh =
+                "#ifdef GL_ES                     \n"
                 "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
                 "precision highp float;           \n"
                 "#else                            \n"
                 "precision mediump float;         \n"
                 "#endif                           \n"
+                "#endif                           \n"
                 "varying vec4 out_Color;\n"
                 "void main() {\n"
                 " gl_FragColor = out_Color;\n"
@@ -754,6 +937,148 @@ void GLAuxContext::GLQueries::auxGetBufferData(GLuint name,
     }
 }
 
+void GLAuxContext::GLQueries::auxReadMultisampleTexture(
+        GLuint name, GLenum target, GLint level, GLint layer,
+        GLenum internalFormat, GLenum format, GLenum type, int width,
+        int height, void* ptr) {
+
+    if (!DIRECT_CALL_CHK(glIsTexture)(name)) {
+        throw std::runtime_error(
+                "Texture object not found in auxaliary context");
+    }
+
+    // framebuffers are not shared: resolve using fbos local to this context
+    GLuint resolveFbos[2], resolveRb;
+    DIRECT_CALL_CHK(glGenFramebuffers)(2, resolveFbos);
+    DIRECT_CALL_CHK(glGenRenderbuffers)(1, &resolveRb);
+
+    DIRECT_CALL_CHK(glBindRenderbuffer)(GL_RENDERBUFFER, resolveRb);
+    DIRECT_CALL_CHK(glRenderbufferStorage)(GL_RENDERBUFFER, internalFormat,
+                                           width, height);
+
+    DIRECT_CALL_CHK(glBindFramebuffer)(GL_READ_FRAMEBUFFER, resolveFbos[0]);
+    if (target == GL_TEXTURE_2D_MULTISAMPLE_ARRAY) {
+        DIRECT_CALL_CHK(glFramebufferTextureLayer)(
+                GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, name, level, layer);
+    } else {
+        DIRECT_CALL_CHK(glFramebufferTexture2D)(GL_READ_FRAMEBUFFER,
+                                                GL_COLOR_ATTACHMENT0, target,
+                                                name, level);
+    }
+
+    DIRECT_CALL_CHK(glBindFramebuffer)(GL_DRAW_FRAMEBUFFER, resolveFbos[1]);
+    DIRECT_CALL_CHK(glFramebufferRenderbuffer)(
+            GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+            resolveRb);
+
+    DIRECT_CALL_CHK(glBlitFramebuffer)(0, 0, width, height, 0, 0, width,
+                                       height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+    DIRECT_CALL_CHK(glBindFramebuffer)(GL_READ_FRAMEBUFFER, resolveFbos[1]);
+    DIRECT_CALL_CHK(glReadBuffer)(GL_COLOR_ATTACHMENT0);
+    if (ptr) {
+        DIRECT_CALL_CHK(glReadPixels)(0, 0, width, height, format, type, ptr);
+    }
+
+    DIRECT_CALL_CHK(glBindFramebuffer)(GL_FRAMEBUFFER, 0);
+    DIRECT_CALL_CHK(glBindRenderbuffer)(GL_RENDERBUFFER, 0);
+    DIRECT_CALL_CHK(glDeleteFramebuffers)(2, resolveFbos);
+    DIRECT_CALL_CHK(glDeleteRenderbuffers)(1, &resolveRb);
+
+    if (DIRECT_CALL_CHK(glGetError)() != GL_NO_ERROR) {
+        throw std::runtime_error("Got GL error on auxiliary context");
+    }
+}
+
+void GLAuxContext::GLQueries::auxGetBufferSubData(GLuint name,
+                                                  std::vector<char>& ret) {
+
+    if (!DIRECT_CALL_CHK(glIsBuffer)(name)) {
+        throw std::runtime_error("Buffer object not found in auxaliary context");
+    }
+
+    // binding points are not shared, so any target can be used here
+    DIRECT_CALL_CHK(glBindBuffer)(GL_ARRAY_BUFFER, name);
+
+    GLint size = 0;
+    DIRECT_CALL_CHK(glGetBufferParameteriv)(GL_ARRAY_BUFFER, GL_BUFFER_SIZE,
+                                            &size);
+    if (!size) {
+        DIRECT_CALL_CHK(glBindBuffer)(GL_ARRAY_BUFFER, 0);
+        throw std::runtime_error("Buffer empty (GL_BUFFER_SIZE is 0)");
+    }
+
+    ret.resize(static_cast<size_t>(size));
+
+    // mapping is object state, so it is visible here, as in application
+    // context. Application mapping is never read here: application may
+    // unmap it or write through it meanwhile. Non-persistently mapped
+    // buffers are queried on application context instead.
+    GLint mapped = 0;
+    if (m_AuxCtx->m_Parrent->hasCapability(GLContext::ContextCap::MapBuffer)) {
+        DIRECT_CALL_CHK(glGetBufferParameteriv)(GL_ARRAY_BUFFER,
+                                                GL_BUFFER_MAPPED, &mapped);
+    }
+
+    GLint accessFlags = 0;
+    if (mapped) {
+        DIRECT_CALL_CHK(glGetBufferParameteriv)(
+                GL_ARRAY_BUFFER, GL_BUFFER_ACCESS_FLAGS, &accessFlags);
+    }
+
+    if (mapped && !(accessFlags & GL_MAP_PERSISTENT_BIT)) {
+        DIRECT_CALL_CHK(glBindBuffer)(GL_ARRAY_BUFFER, 0);
+        throw std::runtime_error(
+                "Cannot perform query - buffer was mapped by application");
+    }
+
+    DIRECT_CALL_CHK(glGetBufferSubData)(GL_ARRAY_BUFFER, 0,
+                                        static_cast<GLsizeiptr>(size), &ret[0]);
+
+    DIRECT_CALL_CHK(glBindBuffer)(GL_ARRAY_BUFFER, 0);
+
+    if (DIRECT_CALL_CHK(glGetError)() != GL_NO_ERROR) {
+        throw std::runtime_error("Got GL error on auxiliary context");
+    }
+}
+
+void GLAuxContext::GLQueries::auxWaitSync(GLsync fence) {
+    if (fence) {
+        DIRECT_CALL_CHK(glWaitSync)(fence, 0, GL_TIMEOUT_IGNORED);
+        DIRECT_CALL_CHK(glDeleteSync)(fence);
+    }
+}
+
+void GLAuxContext::GLQueries::auxGetTexture(
+        GLuint name, GLenum target, dglnet::resource::DGLResourceTexture* ret) {
+
+    if (!DIRECT_CALL_CHK(glIsTexture)(name)) {
+        throw std::runtime_error(
+                "Texture object not found in auxaliary context");
+    }
+
+    DIRECT_CALL_CHK(glBindTexture)(target, name);
+
+    ret->m_Target = target;
+    ret->m_FacesLevelsLayers.resize(target == GL_TEXTURE_CUBE_MAP ? 6 : 1);
+
+    for (size_t face = 0; face < ret->m_FacesLevelsLayers.size(); face++) {
+        for (GLint level = 0;; level++) {
+            // same readback as in application context
+            std::vector<dglnet::resource::DGLResourceTexture::TextureLayer>
+                    currentLevel = m_AuxCtx->m_Parrent->readTextureLevelGetters(
+                            GLTextureObj::getTextureLevelTarget(target, face),
+                            level);
+            if (currentLevel.empty()) {
+                break;
+            }
+            ret->m_FacesLevelsLayers[face].push_back(currentLevel);
+        }
+    }
+
+    DIRECT_CALL_CHK(glBindTexture)(target, 0);
+}
+
 GLuint GLAuxContext::GLQueries::getTextureShaderProgram(
         GLenum target, GLenum textureBaseFormat) {
 
@@ -802,11 +1127,13 @@ GLuint GLAuxContext::GLQueries::getTextureShaderProgram(
     if (glsl300) {
         fsh << "#version 300 es\n";
     }
-    fsh << "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
+    fsh << "#ifdef GL_ES                     \n"
+           "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
            "precision highp float;           \n"
            "#else                            \n"
            "precision mediump float;         \n"
            "#endif                           \n"
+           "#endif                           \n"
            "uniform sampler" << suffix << " s;\n"
            "uniform float level;\n"
            "uniform int   face;\n";
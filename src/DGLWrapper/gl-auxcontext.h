@@ -23,6 +23,12 @@
 
 class DGLDisplayState;
 
+namespace dglnet {
+namespace resource {
+class DGLResourceTexture;
+}
+}
+
 namespace dglState {
 
 class GLContext;
@@ -69,13 +75,13 @@ private:
 };
 #endif
 
-/*
+#ifdef HAVE_LIBRARY_GLX
 class GLAuxGLXContextSurface: public GLAuxContextSurfaceBase  {
 public:
-    GLAuxGLXContextSurface(const DGLDisplayState* display, opaque_id_t pixfmt);
+    GLAuxGLXContextSurface(const DGLDisplayState* display, opaque_id_t pixfmt, GLint width, GLint height);
     ~GLAuxGLXContextSurface();
 };
-*/
+#endif
 
 class GLAuxContext {
    public:
@@ -88,6 +94,13 @@ class GLAuxContext {
 
     void resizeAuxSurface(GLint width, GLint height);
 
+    /**
+     * Detached auxiliary contexts are used on query worker threads: ending a
+     * session releases the context from calling thread, instead of switching
+     * back to the parrent context.
+     */
+    void setDetached(bool detached);
+
     class GLQueries {
        public:
         GLQueries(GLAuxContext*);
@@ -99,6 +112,22 @@ class GLAuxContext {
 
         void auxGetBufferData(GLuint name, std::vector<char>& ret);
 
+        void auxReadMultisampleTexture(GLuint name, GLenum target, GLint level,
+                                       GLint layer, GLenum internalFormat,
+                                       GLenum format, GLenum type, int width,
+                                       int height, void* ptr);
+
+        void auxGetBufferSubData(GLuint name, std::vector<char>& ret);
+
+        /**
+         * Make this context wait for fence created by parrent (and delete
+         * it). Does nothing for NULL fence.
+         */
+        void auxWaitSync(GLsync fence);
+
+        void auxGetTexture(GLuint name, GLenum target,
+                           dglnet::resource::DGLResourceTexture* ret);
+
        private:
 
         static const size_t kBufferGetterChunkSize;
@@ -128,10 +157,12 @@ class GLAuxContext {
 
     virtual bool makeCurrent() = 0;
     virtual bool unmakeCurrent() = 0;
+    virtual bool releaseCurrent() = 0;
    
     int m_MakeCurrentRef;
 
 protected:
+    bool m_Detached;
     opaque_id_t m_Id, m_PixelFormat;
     const GLContext* m_Parrent;
     std::shared_ptr<GLAuxContextSurfaceBase> m_AuxSurface;
@@ -149,6 +180,7 @@ private:
     virtual std::shared_ptr<GLAuxContextSurfaceBase> createNewSurface(GLint width = 1, GLint height = 1) override;
     virtual bool makeCurrent();
     virtual bool unmakeCurrent();
+    virtual bool releaseCurrent();
 };
 
 #ifdef _WIN32
@@ -162,6 +194,22 @@ private:
     virtual std::shared_ptr<GLAuxContextSurfaceBase> createNewSurface(GLint width = 1, GLint height = 1) override;
     virtual bool makeCurrent();
     virtual bool unmakeCurrent();
+    virtual bool releaseCurrent();
+};
+#endif
+
+#ifdef HAVE_LIBRARY_GLX
+class GLGLXAuxContext: public GLAuxContext {
+public:
+    GLGLXAuxContext(const GLContext*);
+    ~GLGLXAuxContext();
+
+private:
+    opaque_id_t choosePixelFormat(opaque_id_t preferred, opaque_id_t displayId);
+    virtual std::shared_ptr<GLAuxContextSurfaceBase> createNewSurface(GLint width = 1, GLint height = 1) override;
+    virtual bool makeCurrent();
+    virtual bool unmakeCurrent();
+    virtual bool releaseCurrent();
 };
 #endif
 
@@ -26,6 +26,9 @@
 #include "gl-utils.h"
 #include "gl-auxcontext.h"
 #include "tls.h"
+#include "globalstate.h"
+
+#include <DGLNet/protocol/dglconfiguration.h>
 
 #include <cstring>
 #include <sstream>
@@ -181,7 +184,10 @@ GLContext::GLContext(const DGLDisplayState* display, GLContextVersion version,
           m_RefCount(0),
           m_ToBeDeleted(false),
           m_InQuery(false),
+          m_QuerySession(NULL),
           m_CreationData(creationData),
+          m_AuxContextFailed(false),
+          m_WorkerAuxContextsFailed(false),
           m_Display(display) {}
 
 
@@ -192,8 +198,8 @@ GLContext::~GLContext() {
 
 dglnet::message::utils::ContextReport GLContext::describe() {
     dglnet::message::utils::ContextReport ret(m_Id);
-    ret.m_TextureSpace      = ns().getShared()->get().m_Textures.getReport(m_Id);
-    ret.m_BufferSpace       = ns().getShared()->get().m_Buffers.getReport(m_Id);
+    ret.m_TextureSpace      = ns().getShared().get().m_Textures.getReport(m_Id);
+    ret.m_BufferSpace       = ns().getShared().get().m_Buffers.getReport(m_Id);
     ret.m_ShaderSpace       = ns().m_Shaders.getReport(m_Id);
     ret.m_ProgramSpace      = ns().m_Programs.getReport(m_Id);
     ret.m_FBOSpace          = ns().m_FBOs.getReport(m_Id);
@@ -333,6 +339,10 @@ void GLContext::startQuery() {
     }
 }
 
+state_setters::QuerySession* GLContext::getQuerySession() {
+    return m_QuerySession;
+}
+
 void GLContext::queryCheckError() {
     GLenum error;
     if ((error = DIRECT_CALL_CHK(glGetError)()) != GL_NO_ERROR) {
@@ -394,7 +404,7 @@ std::shared_ptr<dglnet::DGLResource> GLContext::queryTexture(gl_t _name) {
     }
 
     // check if we know about a texture target
-    GLTextureObj* tex = ns().getShared()->get().m_Textures.getObject(name);
+    GLTextureObj* tex = ns().getShared().get().m_Textures.getObject(name);
 
     resource->m_Target = tex->getTarget();
 
@@ -432,11 +442,26 @@ std::shared_ptr<dglnet::DGLResource> GLContext::queryTexture(gl_t _name) {
         resource->m_FacesLevelsLayers.resize(1);
     }
 
+    bool multisampled = tex->getTarget() == GL_TEXTURE_2D_MULTISAMPLE ||
+                        tex->getTarget() == GL_TEXTURE_2D_MULTISAMPLE_ARRAY;
+
     for (size_t face = 0; face < resource->m_FacesLevelsLayers.size(); face++) {
         for (int level = 0;; level++) {
 
             std::vector<dglnet::resource::DGLResourceTexture::TextureLayer> currentLevel;
 
+            if (hasCapability(ContextCap::TextureGetters) && !multisampled) {
+                // all layers are read at once, same as on query workers
+                currentLevel = readTextureLevelGetters(
+                        tex->getTextureLevelTarget(face), level);
+                if (currentLevel.size()) {
+                    resource->m_FacesLevelsLayers[face].push_back(currentLevel);
+                    continue;
+                } else {
+                    break;
+                }
+            }
+
             GLint samples, internalFormat;
             tex->getFormat(this, level, tex->getTextureLevelTarget(face), internalFormat, samples);
 
@@ -520,12 +545,31 @@ void GLContext::queryTextureLevelSize(const GLTextureObj* tex, GLuint level,
             }
         }
     } else {
-        
+
         // We cannot easily get texture size without level getters.
-        // At first try to bisect the texture size using TexSubImage. If it
-        // fails (bisection fails,
-        // when TexImage does not set proper errors, so maxSize is returned), go
-        // with requested texture sizes.
+        // Level sizes tracked from TexImage/TexStorage/CopyTexImage/
+        // GenerateMipmap calls are used, if present.
+
+        const GLTextureObj::GLTextureLevel* requestedLevel =
+                tex->getRequestedLevel(level);
+
+        if (requestedLevel && requestedLevel->m_Known) {
+            if (width) {
+                *width = requestedLevel->m_Width;
+            }
+            if (height) {
+                *height = isTexture1Dim(levelTarget) ? 1 : requestedLevel->m_Height;
+            }
+            if (depth) {
+                *depth = isTexture2Dim(levelTarget) ? 1 : requestedLevel->m_Depth;
+            }
+            return;
+        }
+
+        // Level was not tracked: try to bisect the texture size using
+        // TexSubImage. If it fails (bisection fails, when TexImage does not set
+        // proper errors, so maxSize is returned), go with requested texture
+        // sizes.
 
         GLint maxSize = 16384;
         DIRECT_CALL_CHK(glGetIntegerv)(GL_MAX_TEXTURE_SIZE, &maxSize);
@@ -533,9 +577,6 @@ void GLContext::queryTextureLevelSize(const GLTextureObj* tex, GLuint level,
         GLenum formatToRequest = GL_RGBA;
         GLenum typeToRequest = GL_UNSIGNED_BYTE;
 
-        const GLTextureObj::GLTextureLevel* requestedLevel =
-                tex->getRequestedLevel(level);
-
         if (requestedLevel) {
             const GLInternalFormat* internalFormatDesc =
                 GLFormats::getInternalFormat(
@@ -783,6 +824,86 @@ GLContext::queryTextureLevelAuxCtx(const GLTextureObj* tex, int level,
     return ret;
 }
 
+std::vector<dglnet::resource::DGLResourceTexture::TextureLayer>
+GLContext::readTextureLevelGetters(GLenum levelTarget, int level) const {
+
+    std::vector<dglnet::resource::DGLResourceTexture::TextureLayer> ret;
+
+    GLint width = 0, height = 1, depth = 1;
+    DIRECT_CALL_CHK(glGetTexLevelParameteriv)(levelTarget, level,
+                                              GL_TEXTURE_WIDTH, &width);
+    if (!isTexture1Dim(levelTarget)) {
+        DIRECT_CALL_CHK(glGetTexLevelParameteriv)(levelTarget, level,
+                                                  GL_TEXTURE_HEIGHT, &height);
+    }
+    if (!isTexture2Dim(levelTarget)) {
+        DIRECT_CALL_CHK(glGetTexLevelParameteriv)(levelTarget, level,
+                                                  GL_TEXTURE_DEPTH, &depth);
+    }
+
+    // levels above GL_MAX_TEXTURE_SIZE log set GL_INVALID_VALUE
+    if (DIRECT_CALL_CHK(glGetError)() != GL_NO_ERROR || !width || !height ||
+        !depth) {
+        return ret;
+    }
+
+    std::vector<GLint> rgbaSizes(GLFormats::kNumChannelsRGBA, 0);
+    DIRECT_CALL_CHK(glGetTexLevelParameteriv)(
+            levelTarget, level, GL_TEXTURE_RED_SIZE, &rgbaSizes[0]);
+    DIRECT_CALL_CHK(glGetTexLevelParameteriv)(
+            levelTarget, level, GL_TEXTURE_GREEN_SIZE, &rgbaSizes[1]);
+    DIRECT_CALL_CHK(glGetTexLevelParameteriv)(
+            levelTarget, level, GL_TEXTURE_BLUE_SIZE, &rgbaSizes[2]);
+    DIRECT_CALL_CHK(glGetTexLevelParameteriv)(
+            levelTarget, level, GL_TEXTURE_ALPHA_SIZE, &rgbaSizes[3]);
+
+    std::vector<GLint> deptStencilSizes(GLFormats::kNumChannelsDS, 0);
+    DIRECT_CALL_CHK(glGetTexLevelParameteriv)(
+            levelTarget, level, GL_TEXTURE_DEPTH_SIZE, &deptStencilSizes[0]);
+
+    if (hasCapability(ContextCap::TextureQueryStencilBits)) {
+        DIRECT_CALL_CHK(glGetTexLevelParameteriv)(levelTarget, level,
+                                                  GL_TEXTURE_STENCIL_SIZE,
+                                                  &deptStencilSizes[1]);
+    }
+
+    GLint internalFormat, samples;
+    GLTextureObj::queryFormat(this, level, levelTarget, internalFormat,
+                              samples);
+
+    DGLPixelTransfer transfer;
+    transfer.initializeOGL(internalFormat, rgbaSizes, deptStencilSizes);
+
+    // pack alignment is default (4)
+    const size_t rowBytes = DGL_ALIGNED(width * transfer.getPixelSize(), 4);
+    const size_t layerSize = rowBytes * static_cast<size_t>(height);
+
+    // whole level (all layers) is read at once
+    std::vector<uint8_t> levelData(layerSize * static_cast<size_t>(depth));
+    DIRECT_CALL_CHK(glGetTexImage)(levelTarget, level,
+                                   (GLenum)transfer.getFormat(),
+                                   (GLenum)transfer.getType(), &levelData[0]);
+
+    if (DIRECT_CALL_CHK(glGetError)() != GL_NO_ERROR) {
+        throw std::runtime_error("Got GL error on texture level readback");
+    }
+
+    ret.resize(static_cast<size_t>(depth));
+    for (size_t layer = 0; layer < ret.size(); layer++) {
+        ret[layer].m_Samples = samples;
+        ret[layer].m_InternalFormat = internalFormat;
+        ret[layer].m_PixelRectangle =
+                std::make_shared<dglnet::resource::DGLPixelRectangle>(
+                        width, height, rowBytes, transfer.getFormat(),
+                        transfer.getType());
+        void* ptr = ret[layer].m_PixelRectangle->getPtr();
+        if (ptr) {
+            memcpy(ptr, &levelData[layer * layerSize], layerSize);
+        }
+    }
+    return ret;
+}
+
 std::shared_ptr<dglnet::resource::DGLPixelRectangle>
 GLContext::queryTextureLevelGetters(
         const GLTextureObj* tex, int level, int layer, size_t face,
@@ -829,52 +950,28 @@ GLContext::queryTextureLevelGetters(
 
     bool multisampled = (levelTarget == GL_TEXTURE_2D_MULTISAMPLE || levelTarget == GL_TEXTURE_2D_MULTISAMPLE_ARRAY);
 
-    if (!multisampled) {
-
-        //glGetTexImage path
-        DGLPixelTransfer transfer;
-        if (getVersion().check(GLContextVersion::Type::ES)) {
-            GLint implReadFormat, implTypeType;
-            DIRECT_CALL_CHK(glGetIntegerv)(GL_IMPLEMENTATION_COLOR_READ_FORMAT,
-                &implReadFormat);
-            DIRECT_CALL_CHK(glGetIntegerv)(GL_IMPLEMENTATION_COLOR_READ_TYPE,
-                &implTypeType);
-            transfer.initializeOGLES(internalFormat, implReadFormat, implTypeType);
-        } else {
-            transfer.initializeOGL(internalFormat, rgbaSizes, deptStencilSizes);
+    // auxiliary context resolves color buffers only
+    bool colorFormat = !deptStencilSizes[0] && !deptStencilSizes[1];
+
+    if (multisampled && colorFormat &&
+        getVersion().check(GLContextVersion::Type::DT)) {
+        // resolve on auxiliary context, so no application state has to be
+        // saved and restored. Fall back to this context, if that fails.
+        ret = queryTextureLevelMultisampleAuxCtx(tex, levelTarget, level, layer,
+                                                 internalFormat, rgbaSizes,
+                                                 deptStencilSizes, width, height);
+        if (ret) {
+            return ret;
         }
+    }
 
-        ret = std::shared_ptr<dglnet::resource::DGLPixelRectangle>(
-            new dglnet::resource::DGLPixelRectangle(
-            width, height,
-            defAlignment.getAligned(width * transfer.getPixelSize()),
-            transfer.getFormat(), transfer.getType()));
-
-        GLvoid* ptr;
-        if ((ptr = ret->getPtr()) != NULL) {
-
-            std::vector<uint8_t> tmpBuffer;
-            uint8_t* readPtr; 
-
-            const size_t layerSize = ret->getSize();
-
-            if (depth == 1) {
-                //only one 2D layer, read it in place
-                readPtr = reinterpret_cast<uint8_t*>(ptr); 
-            } else {
-                //more 2D layers present, prepare a tmp buffer for them
-                tmpBuffer.resize(layerSize * static_cast<size_t>(depth));
-                readPtr = &tmpBuffer[0];
-            }
-
-            DIRECT_CALL_CHK(glGetTexImage)(levelTarget, level,
-                (GLenum)transfer.getFormat(),
-                (GLenum)transfer.getType(), readPtr);
-
-            if (readPtr != ptr) {
-                memcpy(ptr, &readPtr[static_cast<size_t>(layer) * layerSize], layerSize);
-            }
+    if (!multisampled) {
 
+        //glGetTexImage path
+        std::vector<dglnet::resource::DGLResourceTexture::TextureLayer> layers =
+                readTextureLevelGetters(levelTarget, level);
+        if (static_cast<size_t>(layer) < layers.size()) {
+            ret = layers[static_cast<size_t>(layer)].m_PixelRectangle;
         }
     } else {
         //downsample MSAA && glReadPixels path.
@@ -941,6 +1038,50 @@ GLContext::queryTextureLevelGetters(
     return ret;
 }
 
+std::shared_ptr<dglnet::resource::DGLPixelRectangle>
+GLContext::queryTextureLevelMultisampleAuxCtx(
+        const GLTextureObj* tex, GLenum levelTarget, int level, int layer,
+        GLint internalFormat, const std::vector<GLint>& rgbaSizes,
+        const std::vector<GLint>& deptStencilSizes, GLint width, GLint height) {
+
+    GLAuxContext* auxCtx = tryGetAuxContext();
+    if (!auxCtx) {
+        return nullptr;
+    }
+
+    DGLPixelTransfer transfer;
+    transfer.initializeOGL(internalFormat, rgbaSizes, deptStencilSizes);
+
+    // auxiliary context has default pack alignment of 4
+    std::shared_ptr<dglnet::resource::DGLPixelRectangle> ret =
+            std::make_shared<dglnet::resource::DGLPixelRectangle>(
+                    width, height,
+                    DGL_ALIGNED(width * transfer.getPixelSize(), 4),
+                    transfer.getFormat(), transfer.getType());
+    try {
+        GLAuxContextSession auxsess = auxCtx->createAuxCtxSession();
+        try {
+            auxCtx->queries.auxReadMultisampleTexture(
+                    tex->getName(), levelTarget, level, layer,
+                    static_cast<GLenum>(internalFormat),
+                    static_cast<GLenum>(transfer.getFormat()),
+                    static_cast<GLenum>(transfer.getType()), width, height,
+                    ret->getPtr());
+        } catch (const std::runtime_error& e) {
+            // only this texture cannot be resolved there, context is fine
+            OS_DEBUG("Multisample texture resolve on auxiliary context "
+                     "failed: %s\n", e.what());
+            ret.reset();
+        }
+        auxsess.dispose();
+    } catch (const std::runtime_error& e) {
+        OS_DEBUG("Cannot switch to auxiliary context: %s\n", e.what());
+        m_AuxContextFailed = true;
+        return nullptr;
+    }
+    return ret;
+}
+
 std::shared_ptr<dglnet::DGLResource> GLContext::queryBufferGetters(GLBufferObj* buff) {
 
     dglnet::resource::DGLResourceBuffer* resource;
@@ -1130,8 +1271,8 @@ std::shared_ptr<dglnet::DGLResource> GLContext::queryBuffer(gl_t _name) {
     }
 
     // check if we know about a texture target
-    std::unique_ptr<GLShareableObjectsAccessor> accessor  = ns().getShared();
-    GLBufferObj* buff = accessor->get().m_Buffers.getOrCreateObject<void>(name);
+    GLShareableObjectsAccessor accessor  = ns().getShared();
+    GLBufferObj* buff = accessor.get().m_Buffers.getOrCreateObject<void>(name);
 
     if (hasCapability(ContextCap::GetBufferSubData) || hasCapability(ContextCap::MapBuffer) ) {
         return queryBufferGetters(buff);
@@ -1381,7 +1522,7 @@ std::shared_ptr<dglnet::resource::DGLPixelRectangle> GLContext::queryFramebuffer
              throw std::runtime_error("Attached texture object does not exist");
          }
 
-         GLTextureObj* tex = ns().getShared()->get().m_Textures.getObject(attachmentObject);
+         GLTextureObj* tex = ns().getShared().get().m_Textures.getObject(attachmentObject);
          attTarget = tex->getTarget();
 
          GLenum bindableTarget =
@@ -1426,7 +1567,7 @@ std::shared_ptr<dglnet::resource::DGLPixelRectangle> GLContext::queryFramebuffer
                  "Attached renderbuffer object does not exist");
          }
 
-         state_setters::RenderBuffer renderBuffer;
+         state_setters::RenderBuffer renderBuffer(this);
 
 
          DIRECT_CALL_CHK(glBindRenderbuffer)(GL_RENDERBUFFER, attachmentObject);
@@ -1640,7 +1781,7 @@ std::shared_ptr<dglnet::DGLResource> GLContext::queryRenderbuffer(gl_t name) {
         resource = new dglnet::resource::DGLResourceRenderbuffer);
 
     //we are going to change renderbuffer binding
-    state_setters::RenderBuffer renderBuffer;
+    state_setters::RenderBuffer renderBuffer(this);
 
     if (!DIRECT_CALL_CHK(glIsRenderbuffer)(static_cast<GLuint>(name))) {
         throw std::runtime_error("Renderbuffer does not exist");
@@ -2213,19 +2354,96 @@ std::shared_ptr<dglnet::DGLResource> GLContext::queryGPU() {
     return ret;
 }
 
+namespace {
+
+/**
+ * Shadow state validation mode - compare each shadowed value with driver
+ */
+bool shadowValidationEnabled() {
+    return GlobalState::getConfiguration().m_ValidateShadowState;
+}
+
+/**
+ * Compare shadowed state value with value reported by driver. Throws on
+ * mismatch.
+ */
+template <typename T>
+void validateShadowValue(const char* name, const std::vector<T>& shadowed,
+                         const std::vector<T>& driver) {
+    if (DIRECT_CALL_CHK(glGetError)() != GL_NO_ERROR) {
+        throw std::runtime_error(std::string("Shadow state mismatch on ") +
+                                 name + ": driver query failed");
+    }
+    if (shadowed != driver) {
+        std::ostringstream msg;
+        msg << "Shadow state mismatch on " << name << ": shadow (";
+        for (size_t i = 0; i < shadowed.size(); i++) {
+            msg << (i ? ", " : "") << static_cast<double>(shadowed[i]);
+        }
+        msg << "), driver (";
+        for (size_t i = 0; i < driver.size(); i++) {
+            msg << (i ? ", " : "") << static_cast<double>(driver[i]);
+        }
+        msg << ")";
+        throw std::runtime_error(msg.str());
+    }
+}
+
+}    // namespace
+
+GLint GLContext::getShadowedInteger(GLenum pname) {
+    GLint ret = 0;
+    if (shadow().getIntegerv(pname, &ret, 1)) {
+        if (m_InQuery && shadowValidationEnabled()) {
+            std::vector<GLint> driverVal(1, 0);
+            DIRECT_CALL_CHK(glGetIntegerv)(pname, &driverVal[0]);
+            validateShadowValue(GetGLEnumName(pname).c_str(),
+                                std::vector<GLint>(1, ret), driverVal);
+        }
+    } else {
+        DIRECT_CALL_CHK(glGetIntegerv)(pname, &ret);
+        // outside of query GL errors belong to application
+        if (m_InQuery && DIRECT_CALL_CHK(glGetError)() == GL_NO_ERROR) {
+            shadow().learnIntegerv(pname, &ret, 1);
+        }
+    }
+    return ret;
+}
+
 void GLContext::getStateIntegerv(
         const char* name, GLenum value, size_t length, 
         dglnet::resource::utils::StateItem* ret) {
     ret->m_Name = name;
     std::vector<GLint> val(length, 0);
 
-    DIRECT_CALL_CHK(glGetIntegerv)(value, &val[0]);
-
-    if (DIRECT_CALL_CHK(glGetError)() == GL_NO_ERROR) {
-        ret->m_Values.resize(val.size());
-        for (size_t i = 0; i < length; i++) {
-            ret->m_Values[i] = val[i];
+    if (shadow().getIntegerv(value, &val[0], length)) {
+        if (shadowValidationEnabled()) {
+            std::vector<GLint> driverVal(length, 0);
+            DIRECT_CALL_CHK(glGetIntegerv)(value, &driverVal[0]);
+            validateShadowValue(name, val, driverVal);
+        }
+    } else {
+        DIRECT_CALL_CHK(glGetIntegerv)(value, &val[0]);
+        if (DIRECT_CALL_CHK(glGetError)() != GL_NO_ERROR) {
+            return;
         }
+        shadow().learnIntegerv(value, &val[0], length);
+    }
+
+    ret->m_Values.resize(val.size());
+    for (size_t i = 0; i < length; i++) {
+        ret->m_Values[i] = val[i];
+    }
+}
+
+void GLContext::getDriverInteger64v(GLenum value, GLint64* val,
+                                    size_t length) {
+    if (hasCapability(ContextCap::Has64BitGetters)) {
+        DIRECT_CALL_CHK(glGetInteger64v)(value, val);
+    } else {
+        std::vector<GLint> valInt(length, 0);
+        DIRECT_CALL_CHK(glGetIntegerv)(value, &valInt[0]);
+        std::copy(valInt.begin(), valInt.end(), val);
     }
 }
 
@@ -2235,19 +2453,23 @@ void GLContext::getStateInteger64v(
     ret->m_Name = name;
     std::vector<GLint64> val(length, 0);
 
-    if (hasCapability(ContextCap::Has64BitGetters)) {
-        DIRECT_CALL_CHK(glGetInteger64v)(value, &val[0]);
+    if (shadow().getInteger64v(value, &val[0], length)) {
+        if (shadowValidationEnabled()) {
+            std::vector<GLint64> driverVal(length, 0);
+            getDriverInteger64v(value, &driverVal[0], length);
+            validateShadowValue(name, val, driverVal);
+        }
     } else {
-        std::vector<GLint> valInt(length, 0);
-        DIRECT_CALL_CHK(glGetIntegerv)(value, &valInt[0]);
-        std::copy(valInt.begin(), valInt.end(), val.begin());
+        getDriverInteger64v(value, &val[0], length);
+        if (DIRECT_CALL_CHK(glGetError)() != GL_NO_ERROR) {
+            return;
+        }
+        shadow().learnInteger64v(value, &val[0], length);
     }
 
-    if (DIRECT_CALL_CHK(glGetError)() == GL_NO_ERROR) {
-        ret->m_Values.resize(val.size());
-        for (size_t i = 0; i < length; i++) {
-            ret->m_Values[i] = val[i];
-        }
+    ret->m_Values.resize(val.size());
+    for (size_t i = 0; i < length; i++) {
+        ret->m_Values[i] = val[i];
     }
 }
 
@@ -2257,13 +2479,23 @@ void GLContext::getStateFloatv(
     ret->m_Name = name;
     std::vector<GLfloat> val(length, 0);
 
-    DIRECT_CALL_CHK(glGetFloatv)(value, &val[0]);
-
-    if (DIRECT_CALL_CHK(glGetError)() == GL_NO_ERROR) {
-        ret->m_Values.resize(val.size());
-        for (size_t i = 0; i < length; i++) {
-            ret->m_Values[i] = val[i];
+    if (shadow().getFloatv(value, &val[0], length)) {
+        if (shadowValidationEnabled()) {
+            std::vector<GLfloat> driverVal(length, 0);
+            DIRECT_CALL_CHK(glGetFloatv)(value, &driverVal[0]);
+            validateShadowValue(name, val, driverVal);
         }
+    } else {
+        DIRECT_CALL_CHK(glGetFloatv)(value, &val[0]);
+        if (DIRECT_CALL_CHK(glGetError)() != GL_NO_ERROR) {
+            return;
+        }
+        shadow().learnFloatv(value, &val[0], length);
+    }
+
+    ret->m_Values.resize(val.size());
+    for (size_t i = 0; i < length; i++) {
+        ret->m_Values[i] = val[i];
     }
 }
 
@@ -2273,13 +2505,23 @@ void GLContext::getStateDoublev(
     ret->m_Name = name;
     std::vector<GLdouble> val(length, 0);
 
-    DIRECT_CALL_CHK(glGetDoublev)(value, &val[0]);
-
-    if (DIRECT_CALL_CHK(glGetError)() == GL_NO_ERROR) {
-        ret->m_Values.resize(val.size());
-        for (size_t i = 0; i < length; i++) {
-            ret->m_Values[i] = val[i];
+    if (shadow().getDoublev(value, &val[0], length)) {
+        if (shadowValidationEnabled()) {
+            std::vector<GLdouble> driverVal(length, 0);
+            DIRECT_CALL_CHK(glGetDoublev)(value, &driverVal[0]);
+            validateShadowValue(name, val, driverVal);
+        }
+    } else {
+        DIRECT_CALL_CHK(glGetDoublev)(value, &val[0]);
+        if (DIRECT_CALL_CHK(glGetError)() != GL_NO_ERROR) {
+            return;
         }
+        shadow().learnDoublev(value, &val[0], length);
+    }
+
+    ret->m_Values.resize(val.size());
+    for (size_t i = 0; i < length; i++) {
+        ret->m_Values[i] = val[i];
     }
 }
 
@@ -2289,13 +2531,23 @@ void GLContext::getStateBooleanv(
     ret->m_Name = name;
     std::vector<GLboolean> val(length, 0);
 
-    DIRECT_CALL_CHK(glGetBooleanv)(value, &val[0]);
-
-    if (DIRECT_CALL_CHK(glGetError)() == GL_NO_ERROR) {
-        ret->m_Values.resize(val.size());
-        for (size_t i = 0; i < length; i++) {
-            ret->m_Values[i] = val[i];
+    if (shadow().getBooleanv(value, &val[0], length)) {
+        if (shadowValidationEnabled()) {
+            std::vector<GLboolean> driverVal(length, 0);
+            DIRECT_CALL_CHK(glGetBooleanv)(value, &driverVal[0]);
+            validateShadowValue(name, val, driverVal);
         }
+    } else {
+        DIRECT_CALL_CHK(glGetBooleanv)(value, &val[0]);
+        if (DIRECT_CALL_CHK(glGetError)() != GL_NO_ERROR) {
+            return;
+        }
+        shadow().learnBooleanv(value, &val[0], length);
+    }
+
+    ret->m_Values.resize(val.size());
+    for (size_t i = 0; i < length; i++) {
+        ret->m_Values[i] = val[i];
     }
 }
 
@@ -2303,10 +2555,23 @@ void GLContext::getStateIsEnabled(
         const char* name, GLenum value, size_t,
         dglnet::resource::utils::StateItem* ret) {
     ret->m_Name = name;
-    GLboolean val = DIRECT_CALL_CHK(glIsEnabled)(value);
-    if (DIRECT_CALL_CHK(glGetError)() == GL_NO_ERROR) {
-        ret->m_Values.resize(1, val);
+    GLboolean val;
+
+    if (shadow().getEnabled(value, &val)) {
+        if (shadowValidationEnabled()) {
+            std::vector<GLboolean> driverVal(
+                    1, DIRECT_CALL_CHK(glIsEnabled)(value));
+            validateShadowValue(name, std::vector<GLboolean>(1, val),
+                                driverVal);
+        }
+    } else {
+        val = DIRECT_CALL_CHK(glIsEnabled)(value);
+        if (DIRECT_CALL_CHK(glGetError)() != GL_NO_ERROR) {
+            return;
+        }
+        shadow().learnEnabled(value, val);
     }
+    ret->m_Values.resize(1, val);
 }
 
 std::shared_ptr<dglnet::DGLResource> GLContext::queryState(gl_t) {
@@ -3380,7 +3645,7 @@ void GLContext::firstUse() {
             break;
     }
 
-    shadow().getTexUnits().init();
+    shadow().init();
 }
 
 bool GLContext::hasCapability(ContextCap cap) const {
@@ -3454,6 +3719,10 @@ bool GLContext::hasCapability(ContextCap cap) const {
             return version.check(GLContextVersion::Type::DT, 2) ||
                 version.check(GLContextVersion::Type::ES, 2);
 
+        case ContextCap::SyncObjects:
+            return version.check(GLContextVersion::Type::DT, 3, 2) ||
+                version.check(GLContextVersion::Type::ES, 3);
+
         default:
             DGL_ASSERT(0);
             return false;
@@ -3471,6 +3740,152 @@ GLAuxContext* GLContext::getAuxContext() {
     return m_AuxContext.get();
 }
 
+GLAuxContext* GLContext::tryGetAuxContext() {
+    if (m_AuxContextFailed) {
+        return NULL;
+    }
+    try {
+        return getAuxContext();
+    } catch (const std::runtime_error& e) {
+        OS_DEBUG("Auxiliary context not available: %s\n", e.what());
+        m_AuxContextFailed = true;
+        return NULL;
+    }
+}
+
+std::vector<GLAuxContext*> GLContext::getWorkerAuxContexts(size_t count) {
+    std::vector<GLAuxContext*> ret;
+    if (m_WorkerAuxContextsFailed) {
+        return ret;
+    }
+    try {
+        // created here, on application thread: some platforms (WGL) need
+        // parrent context to be current.
+        while (m_WorkerAuxContexts.size() < count) {
+            std::shared_ptr<GLAuxContext> auxCtx = GLAuxContext::Create(this);
+            auxCtx->setDetached(true);
+            m_WorkerAuxContexts.push_back(auxCtx);
+        }
+    } catch (const std::runtime_error& e) {
+        OS_DEBUG("Query worker auxiliary context not available: %s\n",
+                 e.what());
+        m_WorkerAuxContextsFailed = true;
+        m_WorkerAuxContexts.clear();
+        return ret;
+    }
+    for (size_t i = 0; i < count; i++) {
+        ret.push_back(m_WorkerAuxContexts[i].get());
+    }
+    return ret;
+}
+
+GLsync GLContext::fenceForWorkers() {
+    // glFlush alone does not order commands between contexts: worker has to
+    // wait on a fence, or rendering must be complete before it starts.
+    if (hasCapability(ContextCap::SyncObjects)) {
+        GLsync fence = DIRECT_CALL_CHK(glFenceSync)(
+                GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        // fence must reach the server before other context waits on it
+        DIRECT_CALL_CHK(glFlush)();
+        return fence;
+    }
+    DIRECT_CALL_CHK(glFinish)();
+    return NULL;
+}
+
+GLContext::WorkerQuery GLContext::prepareWorkerQueryTexture(gl_t _name) {
+
+    GLuint name = static_cast<GLuint>(_name);
+
+    // glGetTexImage path only, no need to render anything
+    if (!hasCapability(ContextCap::TextureGetters) ||
+        DIRECT_CALL_CHK(glIsTexture)(name) != GL_TRUE) {
+        return WorkerQuery();
+    }
+
+    GLenum target = 0;
+    {
+        GLShareableObjectsAccessor accessor = ns().getShared();
+        GLTextureObj* tex = accessor.get().m_Textures.getObject(name);
+        if (tex) {
+            target = tex->getTarget();
+        }
+    }
+
+    switch (target) {
+        case GL_TEXTURE_1D:
+        case GL_TEXTURE_2D:
+        case GL_TEXTURE_3D:
+        case GL_TEXTURE_1D_ARRAY:
+        case GL_TEXTURE_2D_ARRAY:
+        case GL_TEXTURE_RECTANGLE:
+        case GL_TEXTURE_CUBE_MAP:
+            break;
+        default:
+            // multisampled and unknown targets are queried in this context
+            return WorkerQuery();
+    }
+
+    GLsync fence = fenceForWorkers();
+
+    return [name, target, fence](GLAuxContext* auxCtx) {
+        dglnet::resource::DGLResourceTexture* resource;
+        std::shared_ptr<dglnet::DGLResource> ret(
+                resource = new dglnet::resource::DGLResourceTexture());
+
+        GLAuxContextSession auxsess = auxCtx->createAuxCtxSession();
+        auxCtx->queries.auxWaitSync(fence);
+        auxCtx->queries.auxGetTexture(name, target, resource);
+        auxsess.dispose();
+
+        return ret;
+    };
+}
+
+GLContext::WorkerQuery GLContext::prepareWorkerQueryBuffer(gl_t _name) {
+
+    GLuint name = static_cast<GLuint>(_name);
+
+    if (!hasCapability(ContextCap::GetBufferSubData) ||
+        DIRECT_CALL_CHK(glIsBuffer)(name) != GL_TRUE) {
+        return WorkerQuery();
+    }
+
+    // Buffers mapped by application (other than persistently) are queried
+    // in this context: worker must not touch application's mapping.
+    if (hasCapability(ContextCap::MapBuffer)) {
+        GLint binding = getShadowedInteger(GL_ARRAY_BUFFER_BINDING);
+        DIRECT_CALL_CHK(glBindBuffer)(GL_ARRAY_BUFFER, name);
+        GLint mapped = 0, accessFlags = 0;
+        DIRECT_CALL_CHK(glGetBufferParameteriv)(GL_ARRAY_BUFFER,
+                                                GL_BUFFER_MAPPED, &mapped);
+        if (mapped) {
+            DIRECT_CALL_CHK(glGetBufferParameteriv)(
+                    GL_ARRAY_BUFFER, GL_BUFFER_ACCESS_FLAGS, &accessFlags);
+        }
+        DIRECT_CALL_CHK(glBindBuffer)(GL_ARRAY_BUFFER,
+                                      static_cast<GLuint>(binding));
+        if (mapped && !(accessFlags & GL_MAP_PERSISTENT_BIT)) {
+            return WorkerQuery();
+        }
+    }
+
+    GLsync fence = fenceForWorkers();
+
+    return [name, fence](GLAuxContext* auxCtx) {
+        dglnet::resource::DGLResourceBuffer* resource;
+        std::shared_ptr<dglnet::DGLResource> ret(
+                resource = new dglnet::resource::DGLResourceBuffer());
+
+        GLAuxContextSession auxsess = auxCtx->createAuxCtxSession();
+        auxCtx->queries.auxWaitSync(fence);
+        auxCtx->queries.auxGetBufferSubData(name, resource->m_Data);
+        auxsess.dispose();
+
+        return ret;
+    };
+}
+
 const DGLDisplayState* GLContext::getDisplay() const { return m_Display; }
 
 }    // namespace dglState
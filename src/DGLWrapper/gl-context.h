@@ -24,11 +24,13 @@
 #include <DGLCommon/gl-types.h>
 #include <DGLCommon/gl-entrypoints.h>
 #include <DGLNet/protocol/msgutils.h>
+#include <DGLNet/protocol/resource.h>
 
 #include <vector>
 #include <queue>
 #include <map>
 #include <memory>
+#include <functional>
 
 
 class DGLDisplayState;
@@ -136,14 +138,35 @@ class GLContext {
                     const GLTextureObj* tex, int level, int layer, size_t face,
                     state_setters::PixelStoreAlignment& defAlignment);
 
+    /**
+     * Read back all layers of texture level with glGetTexImage (OpenGL, not
+     * multisampled). Texture must be bound to its target on current context:
+     * this one, or its auxiliary context on query worker. Pack state must be
+     * default. Returns empty vector, if level does not exist.
+     */
+    std::vector<dglnet::resource::DGLResourceTexture::TextureLayer>
+            readTextureLevelGetters(GLenum levelTarget, int level) const;
+
     /**
      * texture level query (OpenGL ES, using auxiliary context)
      */
     std::shared_ptr<dglnet::resource::DGLPixelRectangle>
             queryTextureLevelAuxCtx(const GLTextureObj* tex, int level, int layer, size_t face);
 
-    bool isTexture1Dim(GLenum target);
-    bool isTexture2Dim(GLenum target);
+    /**
+     * multisample texture level query (OpenGL, resolved on auxiliary context).
+     * Returns NULL, if auxiliary context cannot be used.
+     */
+    std::shared_ptr<dglnet::resource::DGLPixelRectangle>
+            queryTextureLevelMultisampleAuxCtx(
+                    const GLTextureObj* tex, GLenum levelTarget, int level,
+                    int layer, GLint internalFormat,
+                    const std::vector<GLint>& rgbaSizes,
+                    const std::vector<GLint>& deptStencilSizes, GLint width,
+                    GLint height);
+
+    static bool isTexture1Dim(GLenum target);
+    static bool isTexture2Dim(GLenum target);
 
     /**
      * texture level size query (using getters, or bisection)
@@ -204,6 +227,11 @@ class GLContext {
     void startQuery();
     bool endQuery(std::string& message);
 
+    /**
+     * Outermost query session open on this context, or NULL.
+     */
+    state_setters::QuerySession* getQuerySession();
+
     /**
      * Called to tell ctx when if is bound to current thread
      */
@@ -245,6 +273,7 @@ class GLContext {
         MapBuffer,
         GLSLShaders,
         GenericVertexAttribs,
+        SyncObjects,
     };
 
     /**
@@ -262,6 +291,44 @@ class GLContext {
      */
     GLAuxContext* getAuxContext();
 
+    /**
+     * Auxiliary context getter, returns NULL if auxiliary context cannot be
+     * used on this platform.
+     */
+    GLAuxContext* tryGetAuxContext();
+
+    /**
+     * Getter for auxiliary contexts of query workers (one per worker). Returns
+     * empty vector, if auxiliary contexts cannot be used on this platform.
+     */
+    std::vector<GLAuxContext*> getWorkerAuxContexts(size_t count);
+
+    /**
+     * Resource query, that is run on query worker thread with given
+     * auxiliary context.
+     */
+    typedef std::function<std::shared_ptr<dglnet::DGLResource>(GLAuxContext*)>
+            WorkerQuery;
+
+    /**
+     * Prepare texture query to be run on query worker. Returns empty
+     * function, if texture must be queried on this context.
+     */
+    WorkerQuery prepareWorkerQueryTexture(gl_t name);
+
+    /**
+     * Prepare buffer query to be run on query worker. Returns empty function,
+     * if buffer must be queried on this context.
+     */
+    WorkerQuery prepareWorkerQueryBuffer(gl_t name);
+
+    /**
+     * Make rendering done so far complete for query workers. Returns fence
+     * worker has to wait for (see GLAuxContext::GLQueries::auxWaitSync), or
+     * NULL if rendering was finished here (sync objects not supported).
+     */
+    GLsync fenceForWorkers();
+
     /**
      *  Getter for parent display
      */
@@ -277,6 +344,12 @@ class GLContext {
      */
     inline GLObjectNameSpaces& ns() { return m_ObjectNamespace; }
 
+    /**
+     * Get single integer state value. Shadowed value is used, if known,
+     * otherwise driver is queried.
+     */
+    GLint getShadowedInteger(GLenum pname);
+
    private:
     void queryCheckError();
 
@@ -342,6 +415,12 @@ class GLContext {
             const char* name, GLenum value, size_t length, 
             dglnet::resource::utils::StateItem* ret);
 
+    /**
+     * Read 64-bit integer state from driver (using glGetIntegerv, if 64-bit
+     * getters are not supported)
+     */
+    void getDriverInteger64v(GLenum value, GLint64* val, size_t length);
+
     /**
      * Get state element (using glGetFloatv)
      */
@@ -390,6 +469,13 @@ class GLContext {
      */
     bool m_InQuery;
 
+    /**
+     * Outermost open query session (application state saved for batch of
+     * queries)
+     */
+    state_setters::QuerySession* m_QuerySession;
+    friend class state_setters::QuerySession;
+
     /**
      * Context creation data - context attributes used on creation of this ctx.
      */
@@ -401,6 +487,22 @@ class GLContext {
      */
     std::shared_ptr<GLAuxContext> m_AuxContext;
 
+    /**
+     * True if auxiliary context failed to create or to make current.
+     */
+    bool m_AuxContextFailed;
+
+    /**
+     * Auxiliary contexts of query workers. These are never current on
+     * application thread.
+     */
+    std::vector<std::shared_ptr<GLAuxContext> > m_WorkerAuxContexts;
+
+    /**
+     * True if any of query worker auxiliary contexts failed to create.
+     */
+    bool m_WorkerAuxContextsFailed;
+
     /**
      * Parent display
      */
@@ -17,13 +17,36 @@
 
 namespace dglState {
 
-GLShareableObjectsAccessor::GLShareableObjectsAccessor(GLObjectNameSpaces& ns):m_lock(ns.m_SharedMutex), m_Namespaces(ns.m_Shared) {}
+GLShareableObjectsAccessor::GLShareableObjectsAccessor(GLObjectNameSpaces& ns):m_Namespaces(ns.m_Shared.get()), m_LockedMutex(&m_Namespaces->m_Mutex) {
+    // Always lock: share group may grow at any time (other thread creating a
+    // shared context), so its current size cannot tell if locking is needed.
+    // Lock of unshared namespace is uncontended and cheap.
+    m_LockedMutex->lock();
+}
+
+GLShareableObjectsAccessor::GLShareableObjectsAccessor(GLShareableObjectsAccessor&& other):m_Namespaces(other.m_Namespaces), m_LockedMutex(other.m_LockedMutex) {
+    other.m_LockedMutex = nullptr;
+}
+
+GLShareableObjectsAccessor::~GLShareableObjectsAccessor() {
+    if (m_LockedMutex) {
+        m_LockedMutex->unlock();
+    }
+}
 
 
 GLObjectNameSpaces::GLObjectNameSpaces():m_Shared(std::make_shared<GLShareableObjectNS>()) {}
 
-std::unique_ptr<GLShareableObjectsAccessor> GLObjectNameSpaces::getShared() {
-    return std::unique_ptr<GLShareableObjectsAccessor>(new GLShareableObjectsAccessor(*this));
+GLShareableObjectsAccessor GLObjectNameSpaces::getShared() {
+    return GLShareableObjectsAccessor(*this);
+}
+
+void GLObjectNameSpaces::shareWith(const GLObjectNameSpaces& other) {
+    m_Shared = other.m_Shared;
+}
+
+bool GLObjectNameSpaces::sharesWith(const GLObjectNameSpaces& other) const {
+    return m_Shared == other.m_Shared;
 }
 
 void GLObjectNameSpaces::clear() {
@@ -23,9 +23,21 @@
 #include <memory>
 #include <mutex>
 #include <type_traits>
+#include <vector>
 
 namespace dglState {
 
+/**
+ * Objects of one kind, keyed by GL name.
+ *
+ * Names are kept in an open-addressed table (linear probing, backward shift
+ * deletion). Slot of a name is the name itself modulo table size: GL
+ * implementations hand out names sequentially, so the table is effectively
+ * a dense array indexed by name.
+ *
+ * Objects are allocated separately, so pointers returned stay valid until
+ * object is deleted (programs keep pointers to attached shaders).
+ */
 template<class ObjType>
 class GLObjectNS {
 public:
@@ -35,14 +47,11 @@ public:
     }
 
     ObjType* getObject(GLuint name) {
-        if (name < kFastLookupSize) {
-            return m_ObjectsFastLookup[name];
-        }
-
-        typename std::map<GLuint, ObjType>::iterator i  = m_Objects.find(name);
-
-        if (i != m_Objects.end()) {
-            return &(*i).second;
+        size_t mask = m_Slots.size() - 1;
+        for (size_t i = name & mask; m_Slots[i].m_Object; i = (i + 1) & mask) {
+            if (m_Slots[i].m_Name == name) {
+                return m_Slots[i].m_Object.get();
+            }
         }
         return nullptr;
     }
@@ -54,16 +63,7 @@ public:
         ObjType* ret = getObject(name);
 
         if (!ret) {
-            typename std::map<GLuint, ObjType>::iterator i = 
-                m_Objects.insert(std::pair<GLuint, ObjType>(
-                    name, ObjType(name, createParams))
-                ).first;
-
-            ret = &(*i).second;
-
-            if (name < kFastLookupSize) {
-                m_ObjectsFastLookup[name] = ret;
-            }
+            ret = insert(name, std::unique_ptr<ObjType>(new ObjType(name, createParams)));
         }
         return ret;
     }
@@ -75,74 +75,126 @@ public:
             ObjType* ret = getObject(name);
 
             if (!ret) {
-                typename std::map<GLuint, ObjType>::iterator i = 
-                    m_Objects.insert(std::pair<GLuint, ObjType>(
-                    name, ObjType(name))
-                    ).first;
-
-                ret = &(*i).second;
-
-                if (name < kFastLookupSize) {
-                    m_ObjectsFastLookup[name] = ret;
-                }
+                ret = insert(name, std::unique_ptr<ObjType>(new ObjType(name)));
             }
             return ret;
     }
 
     void deleteObject(GLuint name) {
-
-        if (name < kFastLookupSize) {
-            m_ObjectsFastLookup[name] = nullptr;
+        size_t mask = m_Slots.size() - 1;
+        size_t i = name & mask;
+        for (; m_Slots[i].m_Object; i = (i + 1) & mask) {
+            if (m_Slots[i].m_Name == name) {
+                break;
+            }
         }
-
-        typename std::map<GLuint, ObjType>::iterator i = m_Objects.find(name);
-        if (i != m_Objects.end()) {
-            m_Objects.erase(i);
+        if (!m_Slots[i].m_Object) {
+            return;
+        }
+        m_Slots[i].m_Object.reset();
+        m_Count--;
+
+        // shift following entries of the probe sequence back into the hole,
+        // so lookups can still stop at first empty slot.
+        for (size_t j = (i + 1) & mask; m_Slots[j].m_Object; j = (j + 1) & mask) {
+            size_t home = m_Slots[j].m_Name & mask;
+            bool reachable = (i <= j) ? (i < home && home <= j)
+                                      : (i < home || home <= j);
+            if (!reachable) {
+                m_Slots[i] = std::move(m_Slots[j]);
+                i = j;
+            }
         }
     }
 
     std::set<dglnet::ContextObjectName> getReport(opaque_id_t ctxName) {
         std::set<dglnet::ContextObjectName> ret;
 
-        for (typename std::map<GLuint, ObjType>::iterator i = m_Objects.begin();
-            i != m_Objects.end(); ++i) {
-                ret.insert(
-                    dglnet::ContextObjectName(ctxName, i->second.getName(), i->second.getTarget()));
+        for (size_t i = 0; i < m_Slots.size(); i++) {
+            if (m_Slots[i].m_Object) {
+                ret.insert(dglnet::ContextObjectName(
+                        ctxName, m_Slots[i].m_Object->getName(),
+                        m_Slots[i].m_Object->getTarget()));
+            }
         }
 
         return ret;
     }
 
     void clear() {
-        for (size_t i = 0; i < kFastLookupSize; i++) {
-            m_ObjectsFastLookup[i] = nullptr;
-        }
-        m_Objects.clear();
+        m_Slots.clear();
+        m_Slots.resize(kInitialSize);
+        m_Count = 0;
     }
 
 private:
-    static const GLuint kFastLookupSize = 100;
+    struct Slot {
+        GLuint m_Name;
+        std::unique_ptr<ObjType> m_Object;
+    };
+
+    ObjType* insert(GLuint name, std::unique_ptr<ObjType> object) {
+        // keep load factor below 3/4
+        if ((m_Count + 1) * 4 > m_Slots.size() * 3) {
+            std::vector<Slot> oldSlots(m_Slots.size() * 2);
+            oldSlots.swap(m_Slots);
+            m_Count = 0;
+            for (size_t i = 0; i < oldSlots.size(); i++) {
+                if (oldSlots[i].m_Object) {
+                    insert(oldSlots[i].m_Name, std::move(oldSlots[i].m_Object));
+                }
+            }
+        }
+        size_t mask = m_Slots.size() - 1;
+        size_t i = name & mask;
+        while (m_Slots[i].m_Object) {
+            i = (i + 1) & mask;
+        }
+        m_Slots[i].m_Name = name;
+        m_Slots[i].m_Object = std::move(object);
+        m_Count++;
+        return m_Slots[i].m_Object.get();
+    }
 
-    std::map<GLuint, ObjType> m_Objects;
-    ObjType* m_ObjectsFastLookup[kFastLookupSize]; 
+    // power of two
+    static const size_t kInitialSize = 128;
+
+    std::vector<Slot> m_Slots;
+    size_t m_Count;
 };
 
 class GLShareableObjectNS {
 public:
     GLObjectNS<GLTextureObj>      m_Textures;
     GLObjectNS<GLBufferObj>       m_Buffers;
+private:
+    std::recursive_mutex m_Mutex;
+
+    friend class GLShareableObjectsAccessor;
 };
 
 class GLObjectNameSpaces;
 
+/**
+ * Scoped access to shareable objects of a context.
+ *
+ * Lives on stack (no allocation per access) and holds the share group lock
+ * for its lifetime.
+ */
 class GLShareableObjectsAccessor {
 public:
     GLShareableObjectsAccessor(GLObjectNameSpaces& namespaces);
-inline GLShareableObjectNS& get() { return *m_Namespaces; }
+    GLShareableObjectsAccessor(GLShareableObjectsAccessor&& other);
+    ~GLShareableObjectsAccessor();
+
+    inline GLShareableObjectNS& get() { return *m_Namespaces; }
 
 private:
-    std::lock_guard<std::recursive_mutex> m_lock;
-    std::shared_ptr<GLShareableObjectNS> m_Namespaces;
+    GLShareableObjectsAccessor(const GLShareableObjectsAccessor&);
+    GLShareableObjectsAccessor& operator=(const GLShareableObjectsAccessor&);
+
+    GLShareableObjectNS* m_Namespaces;
+    std::recursive_mutex* m_LockedMutex;
 };
 
 class GLObjectNameSpaces {
@@ -150,7 +202,18 @@ public:
 
     GLObjectNameSpaces(); 
 
-    std::unique_ptr<GLShareableObjectsAccessor> getShared();
+    GLShareableObjectsAccessor getShared();
+
+    /**
+     * Join share group of other context: shareable objects (textures,
+     * buffers) of both contexts are held in one namespace.
+     */
+    void shareWith(const GLObjectNameSpaces& other);
+
+    /**
+     * Returns true if shareable objects are visible from both namespaces
+     */
+    bool sharesWith(const GLObjectNameSpaces& other) const;
 
     void clear();
 
@@ -162,7 +225,6 @@ public:
 private:
     
     std::shared_ptr<GLShareableObjectNS> m_Shared;
-    std::recursive_mutex m_SharedMutex;
 
     friend GLShareableObjectsAccessor;
     
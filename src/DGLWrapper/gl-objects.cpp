@@ -17,6 +17,7 @@
 
 #include "gl-objects.h"
 #include "pointers.h"
+#include <DGLNet/protocol/pixeltransfer.h>
 
 #include <DGLCommon/def.h> 
 
@@ -36,7 +37,7 @@ void GLObj::setTarget(GLenum target) {
 
 GLenum GLObj::getTarget() const { return m_Target; }
 
-GLTextureObj::GLTextureObj(GLuint name) : GLObj(name) {}
+GLTextureObj::GLTextureObj(GLuint name) : GLObj(name), m_ImmutableLevels(0) {}
 
 void GLTextureObj::setTexImage(GLuint level, GLsizei width, GLsizei height,
                                GLsizei depth, GLenum internalFormat, GLenum,
@@ -51,24 +52,81 @@ void GLTextureObj::setTexImage(GLuint level, GLsizei width, GLsizei height,
 
 void GLTextureObj::setTexStorage(GLuint levels, GLsizei width, GLsizei height,
                                  GLsizei depth, GLenum internalFormat,
-                                 GLenum format, GLenum type) {
-    int levelWidth = width;
-    int levelHeight = height;
-    int levelDepth = depth;
-
+                                 GLenum, GLenum type) {
+    m_ImmutableLevels = levels;
+    m_Levels.clear();
     m_Levels.resize(static_cast<size_t>(levels));
 
+    GLTextureLevel level(internalFormat, type, width, height, depth);
     for (GLuint i = 0; i < levels; i++) {
-        setTexImage(i, levelWidth, levelHeight, levelDepth, internalFormat,
-                    format, type);
-        levelWidth = std::max(1, (levelWidth / 2));
-        levelHeight = std::max(1, (levelHeight / 2));
-        levelDepth = std::max(1, (levelDepth / 2));
+        m_Levels[i] = level;
+        level = minifyLevel(level);
+    }
+}
+
+void GLTextureObj::generateMipmap(GLuint baseLevel, GLuint maxLevel) {
+    const GLTextureLevel* base = getRequestedLevel(static_cast<GLint>(baseLevel));
+    if (!base || !base->m_Known) {
+        // cannot derive anything from unknown base: forget levels above it
+        if (m_Levels.size() > static_cast<size_t>(baseLevel) + 1) {
+            m_Levels.resize(static_cast<size_t>(baseLevel) + 1);
+        }
+        return;
+    }
+
+    if (m_ImmutableLevels) {
+        maxLevel = std::min(maxLevel, m_ImmutableLevels - 1);
+    }
+
+    GLTextureLevel level = *base;
+    for (GLuint i = baseLevel + 1; i <= maxLevel; i++) {
+        GLTextureLevel next = minifyLevel(level);
+        if (next.m_Width == level.m_Width && next.m_Height == level.m_Height &&
+            next.m_Depth == level.m_Depth) {
+            // 1x1 level reached
+            break;
+        }
+        level = next;
+        if (m_Levels.size() < static_cast<size_t>(i) + 1) {
+            m_Levels.resize(static_cast<size_t>(i) + 1);
+        }
+        m_Levels[i] = level;
     }
 }
 
+void GLTextureObj::resetLevels() { m_Levels.clear(); }
+
+GLTextureObj::GLTextureLevel GLTextureObj::minifyLevel(
+        const GLTextureLevel& level) const {
+    GLTextureLevel ret = level;
+    ret.m_Width = std::max(1, ret.m_Width / 2);
+    switch (getTarget()) {
+        case GL_TEXTURE_1D_ARRAY:
+            break;
+        case GL_TEXTURE_2D_ARRAY:
+        case GL_TEXTURE_CUBE_MAP_ARRAY:
+            ret.m_Height = std::max(1, ret.m_Height / 2);
+            break;
+        default:
+            ret.m_Height = std::max(1, ret.m_Height / 2);
+            ret.m_Depth = std::max(1, ret.m_Depth / 2);
+    }
+    return ret;
+}
+
 void GLTextureObj::getFormat(GLContext* ctx, int level, GLenum levelTarget, GLint& retInternalFormat, GLint& retSamples) const {
 
+    queryFormat(ctx, level, levelTarget, retInternalFormat, retSamples);
+
+    if (!ctx->hasCapability(GLContext::ContextCap::TextureGetters)) {
+        if (m_Levels.size()) {
+            retInternalFormat = m_Levels[0].m_RequestedInternalFormat;
+        }
+    }
+}
+
+void GLTextureObj::queryFormat(const GLContext* ctx, int level, GLenum levelTarget, GLint& retInternalFormat, GLint& retSamples) {
+
     retInternalFormat = 0; 
     retSamples = 0;
 
@@ -81,10 +139,6 @@ void GLTextureObj::getFormat(GLContext* ctx, int level, GLenum levelTarget, GLin
         DIRECT_CALL_CHK(glGetTexLevelParameteriv)(
             levelTarget, level, GL_TEXTURE_INTERNAL_FORMAT,
             &retInternalFormat);
-    } else {
-        if (m_Levels.size()) {
-            retInternalFormat = m_Levels[0].m_RequestedInternalFormat;
-        }
     }
 }
 
@@ -97,8 +151,34 @@ const GLTextureObj::GLTextureLevel* GLTextureObj::getRequestedLevel(GLint level)
     }
 }
 
-GLenum GLTextureObj::getTextureLevelTarget(size_t face) const {
+size_t GLTextureObj::getKnownDataSize() const {
+    size_t size = 0;
+    for (size_t i = 0; i < m_Levels.size(); i++) {
+        if (!m_Levels[i].m_Known) {
+            continue;
+        }
+        DGLPixelTransfer transfer;
+        // unknown formats are counted as 1 byte per texel
+        size_t pixelSize = 1;
+        if (transfer.initializeOGL(m_Levels[i].m_RequestedInternalFormat)) {
+            pixelSize = transfer.getPixelSize();
+        }
+        size += static_cast<size_t>(m_Levels[i].m_Width) *
+                static_cast<size_t>(m_Levels[i].m_Height) *
+                static_cast<size_t>(m_Levels[i].m_Depth) * pixelSize;
+    }
     if (getTarget() == GL_TEXTURE_CUBE_MAP) {
+        size *= 6;
+    }
+    return size;
+}
+
+GLenum GLTextureObj::getTextureLevelTarget(size_t face) const {
+    return getTextureLevelTarget(getTarget(), face);
+}
+
+GLenum GLTextureObj::getTextureLevelTarget(GLenum target, size_t face) {
+    if (target == GL_TEXTURE_CUBE_MAP) {
         GLenum cubeMapFaces[] = {
                 GL_TEXTURE_CUBE_MAP_POSITIVE_X, GL_TEXTURE_CUBE_MAP_NEGATIVE_X,
                 GL_TEXTURE_CUBE_MAP_POSITIVE_Y, GL_TEXTURE_CUBE_MAP_NEGATIVE_Y,
@@ -106,7 +186,7 @@ GLenum GLTextureObj::getTextureLevelTarget(size_t face) const {
         DGL_ASSERT((size_t)face < DGL_ARRAY_LENGTH(cubeMapFaces));
         return cubeMapFaces[face];
     } else {
-        return getTarget();
+        return target;
     }
 }
 
@@ -115,7 +195,8 @@ GLTextureObj::GLTextureLevel::GLTextureLevel()
           m_RequestedDataType(0),
           m_Width(0),
           m_Height(0),
-          m_Depth(0) {}
+          m_Depth(0),
+          m_Known(false) {}
 
 GLTextureObj::GLTextureLevel::GLTextureLevel(GLenum requestedInternalFormat,
                                              GLenum requestedDataType,
@@ -125,9 +206,14 @@ GLTextureObj::GLTextureLevel::GLTextureLevel(GLenum requestedInternalFormat,
           m_RequestedDataType(requestedDataType),
           m_Width(width),
           m_Height(height),
-          m_Depth(depth) {}
+          m_Depth(depth),
+          m_Known(true) {}
+
+GLBufferObj::GLBufferObj(GLuint name) : GLObj(name), m_Size(kUnknownSize) {}
+
+void GLBufferObj::setSize(GLsizeiptr size) { m_Size = size; }
 
-GLBufferObj::GLBufferObj(GLuint name) : GLObj(name) {}
+GLsizeiptr GLBufferObj::getSize() const { return m_Size; }
 
 GLProgramObj::GLProgramObj(GLuint name, bool arbApi)
         : GLObj(name), m_InUse(false), m_Deleted(false), m_arbApi(arbApi) {}
@@ -49,7 +49,7 @@ class GLTextureObj : public GLObj {
      */
     GLTextureObj(GLuint name);
 
-    GLTextureObj() {}
+    GLTextureObj(): m_ImmutableLevels(0) {}
 
     /** 
      * Set texture level image params (called on glTexImage)
@@ -61,17 +61,37 @@ class GLTextureObj : public GLObj {
      */
     void setTexStorage(GLuint levels, GLsizei width, GLsizei height, GLsizei depth, GLenum internalFormat, GLenum format, GLenum type);
 
+    /** 
+     * Derive mip chain params from base level (called on glGenerateMipmap).
+     * Levels beyond immutable storage are never derived.
+     */
+    void generateMipmap(GLuint baseLevel, GLuint maxLevel);
+
+    /** 
+     * Forget all level params (level images defined by untracked means).
+     * Immutable level count is kept.
+     */
+    void resetLevels();
+
     /**
      * Get texture format and sample count
      */
     void getFormat(GLContext* ctx, int level, GLenum levelTarget, GLint& retInternalFormat, GLint& retSamples) const;
 
+    /**
+     * Get texture format and sample count of texture bound on current
+     * context, using level getters only (does not touch texture object, so
+     * can be used on query workers)
+     */
+    static void queryFormat(const GLContext* ctx, int level, GLenum levelTarget, GLint& retInternalFormat, GLint& retSamples);
+
     /**
      * Get  target of texture level. 
      *
      * Face is required argument for cubemaps.
      */
     GLenum getTextureLevelTarget(size_t face) const;
+    static GLenum getTextureLevelTarget(GLenum target, size_t face);
 
     /**
      * Class describing level parameters 
@@ -84,12 +104,36 @@ class GLTextureObj : public GLObj {
         GLenum m_RequestedInternalFormat;
         GLenum m_RequestedDataType;
         GLsizei m_Width, m_Height, m_Depth;
+
+        /**
+         * True if level was defined by tracked call (level sizes are reliable)
+         */
+        bool m_Known;
     };
 
     /**
      * Getter for requested texture level parameters
      */
     const GLTextureLevel* getRequestedLevel(GLint level) const;
+
+    /**
+     * Lower bound of pixel data size of levels defined by tracked calls (0 if
+     * no level is known). Used to skip big textures without reading them.
+     */
+    size_t getKnownDataSize() const;
+
+   private:
+    /**
+     * Get params of next mip level. Layers of array textures are not minified.
+     */
+    GLTextureLevel minifyLevel(const GLTextureLevel& level) const;
+
+    /**
+     * Level count of immutable storage (0 if texture is mutable)
+     */
+    GLuint m_ImmutableLevels;
+
+   public:
    
     /** 
      * Level parameters
@@ -100,7 +144,23 @@ class GLTextureObj : public GLObj {
 class GLBufferObj : public GLObj {
    public:
     GLBufferObj(GLuint name);
-    GLBufferObj() {}
+    GLBufferObj(): m_Size(kUnknownSize) {}
+
+    /**
+     * Set data store size (called on glBufferData, glBufferStorage)
+     */
+    void setSize(GLsizeiptr size);
+
+    /**
+     * Get data store size, or kUnknownSize if store was not defined by
+     * tracked call
+     */
+    GLsizeiptr getSize() const;
+
+    static const GLsizeiptr kUnknownSize = -1;
+
+   private:
+    GLsizeiptr m_Size;
 };
 
 class GLObjectNameSpaces;
@@ -14,12 +14,461 @@
 */
 
 #include "gl-shadowstate.h"
+#include "pointers.h"
 
 namespace dglState  {
 
+namespace {
+
+/**
+ * State, that can be modified only by calls intercepted in StateAction (and
+ * object actions). Only such state can be safely remembered after it is read
+ * from driver.
+ */
+bool isTrackedState(GLenum pname) {
+    switch (pname) {
+        case GL_VIEWPORT:
+        case GL_SCISSOR_BOX:
+        case GL_BLEND_SRC_RGB:
+        case GL_BLEND_DST_RGB:
+        case GL_BLEND_SRC_ALPHA:
+        case GL_BLEND_DST_ALPHA:
+        case GL_BLEND_EQUATION_RGB:
+        case GL_BLEND_EQUATION_ALPHA:
+        case GL_BLEND_COLOR:
+        case GL_DEPTH_FUNC:
+        case GL_DEPTH_WRITEMASK:
+        case GL_DEPTH_RANGE:
+        case GL_ACTIVE_TEXTURE:
+        case GL_ARRAY_BUFFER_BINDING:
+        case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+        case GL_PIXEL_PACK_BUFFER_BINDING:
+        case GL_PIXEL_UNPACK_BUFFER_BINDING:
+        case GL_COPY_READ_BUFFER_BINDING:
+        case GL_COPY_WRITE_BUFFER_BINDING:
+        case GL_UNIFORM_BUFFER_BINDING:
+        case GL_TRANSFORM_FEEDBACK_BUFFER_BINDING:
+        case GL_DRAW_INDIRECT_BUFFER_BINDING:
+        case GL_DISPATCH_INDIRECT_BUFFER_BINDING:
+        case GL_SHADER_STORAGE_BUFFER_BINDING:
+        case GL_ATOMIC_COUNTER_BUFFER_BINDING:
+        case GL_VERTEX_ARRAY_BINDING:
+        case GL_DRAW_FRAMEBUFFER_BINDING:
+        case GL_READ_FRAMEBUFFER_BINDING:
+        case GL_RENDERBUFFER_BINDING:
+        case GL_UNPACK_SWAP_BYTES:
+        case GL_UNPACK_LSB_FIRST:
+        case GL_UNPACK_IMAGE_HEIGHT:
+        case GL_UNPACK_SKIP_IMAGES:
+        case GL_UNPACK_ROW_LENGTH:
+        case GL_UNPACK_SKIP_ROWS:
+        case GL_UNPACK_SKIP_PIXELS:
+        case GL_UNPACK_ALIGNMENT:
+        case GL_UNPACK_COMPRESSED_BLOCK_WIDTH:
+        case GL_UNPACK_COMPRESSED_BLOCK_HEIGHT:
+        case GL_UNPACK_COMPRESSED_BLOCK_DEPTH:
+        case GL_UNPACK_COMPRESSED_BLOCK_SIZE:
+        case GL_PACK_SWAP_BYTES:
+        case GL_PACK_LSB_FIRST:
+        case GL_PACK_IMAGE_HEIGHT:
+        case GL_PACK_SKIP_IMAGES:
+        case GL_PACK_ROW_LENGTH:
+        case GL_PACK_SKIP_ROWS:
+        case GL_PACK_SKIP_PIXELS:
+        case GL_PACK_ALIGNMENT:
+        case GL_PACK_COMPRESSED_BLOCK_WIDTH:
+        case GL_PACK_COMPRESSED_BLOCK_HEIGHT:
+        case GL_PACK_COMPRESSED_BLOCK_DEPTH:
+        case GL_PACK_COMPRESSED_BLOCK_SIZE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Capabilities, that are not global context state: per texture unit
+ * enables and client arrays (changed by glEnableClientState()).
+ */
+bool isTrackedCap(GLenum cap) {
+    switch (cap) {
+        case GL_TEXTURE_1D:
+        case GL_TEXTURE_2D:
+        case GL_TEXTURE_3D:
+        case GL_TEXTURE_CUBE_MAP:
+        case GL_TEXTURE_RECTANGLE:
+        case GL_TEXTURE_EXTERNAL_OES:
+        case GL_TEXTURE_GEN_S:
+        case GL_TEXTURE_GEN_T:
+        case GL_TEXTURE_GEN_R:
+        case GL_TEXTURE_GEN_Q:
+        case GL_VERTEX_ARRAY:
+        case GL_NORMAL_ARRAY:
+        case GL_COLOR_ARRAY:
+        case GL_INDEX_ARRAY:
+        case GL_TEXTURE_COORD_ARRAY:
+        case GL_EDGE_FLAG_ARRAY:
+        case GL_FOG_COORD_ARRAY:
+        case GL_SECONDARY_COLOR_ARRAY:
+            return false;
+        default:
+            return true;
+    }
+}
+
+GLenum bufferTargetToBinding(GLenum target) {
+    switch (target) {
+        case GL_ARRAY_BUFFER:
+            return GL_ARRAY_BUFFER_BINDING;
+        case GL_ELEMENT_ARRAY_BUFFER:
+            return GL_ELEMENT_ARRAY_BUFFER_BINDING;
+        case GL_PIXEL_PACK_BUFFER:
+            return GL_PIXEL_PACK_BUFFER_BINDING;
+        case GL_PIXEL_UNPACK_BUFFER:
+            return GL_PIXEL_UNPACK_BUFFER_BINDING;
+        case GL_COPY_READ_BUFFER:
+            return GL_COPY_READ_BUFFER_BINDING;
+        case GL_COPY_WRITE_BUFFER:
+            return GL_COPY_WRITE_BUFFER_BINDING;
+        case GL_UNIFORM_BUFFER:
+            return GL_UNIFORM_BUFFER_BINDING;
+        case GL_TRANSFORM_FEEDBACK_BUFFER:
+            return GL_TRANSFORM_FEEDBACK_BUFFER_BINDING;
+        case GL_DRAW_INDIRECT_BUFFER:
+            return GL_DRAW_INDIRECT_BUFFER_BINDING;
+        case GL_DISPATCH_INDIRECT_BUFFER:
+            return GL_DISPATCH_INDIRECT_BUFFER_BINDING;
+        case GL_SHADER_STORAGE_BUFFER:
+            return GL_SHADER_STORAGE_BUFFER_BINDING;
+        case GL_ATOMIC_COUNTER_BUFFER:
+            return GL_ATOMIC_COUNTER_BUFFER_BINDING;
+        default:
+            return 0;
+    }
+}
+
+const GLenum s_BufferBindings[] = {
+        GL_ARRAY_BUFFER_BINDING,          GL_ELEMENT_ARRAY_BUFFER_BINDING,
+        GL_PIXEL_PACK_BUFFER_BINDING,     GL_PIXEL_UNPACK_BUFFER_BINDING,
+        GL_COPY_READ_BUFFER_BINDING,      GL_COPY_WRITE_BUFFER_BINDING,
+        GL_UNIFORM_BUFFER_BINDING,        GL_TRANSFORM_FEEDBACK_BUFFER_BINDING,
+        GL_DRAW_INDIRECT_BUFFER_BINDING,  GL_DISPATCH_INDIRECT_BUFFER_BINDING,
+        GL_SHADER_STORAGE_BUFFER_BINDING, GL_ATOMIC_COUNTER_BUFFER_BINDING};
+
+}    // namespace
+
 GLContextShadowState::GLContextShadowState() : 
     m_CurrentProgram(0),
-    m_InImmediateMode(false)
-    {}
+    m_InImmediateMode(false),
+    m_InListCompileMode(false) {
+    m_MaxViewportDims[0] = m_MaxViewportDims[1] = 0;
+}
+
+void GLContextShadowState::init() {
+    m_TextureUnits.init();
+    DIRECT_CALL_CHK(glGetIntegerv)(GL_MAX_VIEWPORT_DIMS, m_MaxViewportDims);
+}
+
+void GLContextShadowState::setEnabled(GLenum cap, bool enabled) {
+    if (isTrackedCap(cap)) {
+        m_Enabled[cap] = enabled;
+    }
+}
+
+void GLContextShadowState::setViewport(GLint x, GLint y, GLsizei width,
+                                       GLsizei height) {
+    // implementation clamps viewport dimensions and (with ARB_viewport_array)
+    // origin. Do not try to predict that.
+    if (width > m_MaxViewportDims[0] || height > m_MaxViewportDims[1] ||
+        x < -32768 || x > 32767 || y < -32768 || y > 32767) {
+        invalidate(GL_VIEWPORT);
+        return;
+    }
+    GLint viewport[4] = {x, y, width, height};
+    setIntegers(GL_VIEWPORT, viewport, 4);
+}
+
+void GLContextShadowState::setScissor(GLint x, GLint y, GLsizei width,
+                                      GLsizei height) {
+    GLint box[4] = {x, y, width, height};
+    setIntegers(GL_SCISSOR_BOX, box, 4);
+}
+
+void GLContextShadowState::setBlendFunc(GLenum srcRGB, GLenum dstRGB,
+                                        GLenum srcAlpha, GLenum dstAlpha) {
+    GLint val = static_cast<GLint>(srcRGB);
+    setIntegers(GL_BLEND_SRC_RGB, &val, 1);
+    val = static_cast<GLint>(dstRGB);
+    setIntegers(GL_BLEND_DST_RGB, &val, 1);
+    val = static_cast<GLint>(srcAlpha);
+    setIntegers(GL_BLEND_SRC_ALPHA, &val, 1);
+    val = static_cast<GLint>(dstAlpha);
+    setIntegers(GL_BLEND_DST_ALPHA, &val, 1);
+}
+
+void GLContextShadowState::setBlendEquation(GLenum modeRGB, GLenum modeAlpha) {
+    GLint val = static_cast<GLint>(modeRGB);
+    setIntegers(GL_BLEND_EQUATION_RGB, &val, 1);
+    val = static_cast<GLint>(modeAlpha);
+    setIntegers(GL_BLEND_EQUATION_ALPHA, &val, 1);
+}
+
+void GLContextShadowState::setDepthFunc(GLenum func) {
+    GLint val = static_cast<GLint>(func);
+    setIntegers(GL_DEPTH_FUNC, &val, 1);
+}
+
+void GLContextShadowState::setDepthMask(GLboolean flag) {
+    GLint val = flag ? GL_TRUE : GL_FALSE;
+    setIntegers(GL_DEPTH_WRITEMASK, &val, 1);
+}
+
+void GLContextShadowState::setPixelStore(GLenum pname, GLint param) {
+    if (!isTrackedState(pname)) {
+        return;
+    }
+    switch (pname) {
+        case GL_PACK_SWAP_BYTES:
+        case GL_PACK_LSB_FIRST:
+        case GL_UNPACK_SWAP_BYTES:
+        case GL_UNPACK_LSB_FIRST:
+            param = param ? GL_TRUE : GL_FALSE;
+            break;
+    }
+    setIntegers(pname, &param, 1);
+}
+
+void GLContextShadowState::setActiveTexture(GLenum texture) {
+    GLint val = static_cast<GLint>(texture);
+    setIntegers(GL_ACTIVE_TEXTURE, &val, 1);
+}
+
+void GLContextShadowState::bindBuffer(GLenum target, GLuint name) {
+    GLenum binding = bufferTargetToBinding(target);
+    if (binding) {
+        GLint val = static_cast<GLint>(name);
+        setIntegers(binding, &val, 1);
+    }
+}
+
+void GLContextShadowState::bindVertexArray(GLuint name) {
+    GLint val = static_cast<GLint>(name);
+    setIntegers(GL_VERTEX_ARRAY_BINDING, &val, 1);
+    // element array binding is a part of VAO state
+    invalidate(GL_ELEMENT_ARRAY_BUFFER_BINDING);
+}
+
+void GLContextShadowState::vertexArrayElementBuffer(GLuint vaobj,
+                                                    GLuint buffer) {
+    // element array binding changes only if VAO is currently bound
+    GLint current;
+    if (getIntegerv(GL_VERTEX_ARRAY_BINDING, &current, 1)) {
+        if (static_cast<GLuint>(current) == vaobj) {
+            GLint val = static_cast<GLint>(buffer);
+            setIntegers(GL_ELEMENT_ARRAY_BUFFER_BINDING, &val, 1);
+        }
+    } else {
+        invalidate(GL_ELEMENT_ARRAY_BUFFER_BINDING);
+    }
+}
+
+void GLContextShadowState::bindFramebuffer(GLenum target, GLuint name,
+                                           bool separateReadDraw) {
+    GLint val = static_cast<GLint>(name);
+    switch (target) {
+        case GL_FRAMEBUFFER:
+            setIntegers(GL_DRAW_FRAMEBUFFER_BINDING, &val, 1);
+            if (separateReadDraw) {
+                setIntegers(GL_READ_FRAMEBUFFER_BINDING, &val, 1);
+            }
+            break;
+        case GL_DRAW_FRAMEBUFFER:
+            setIntegers(GL_DRAW_FRAMEBUFFER_BINDING, &val, 1);
+            break;
+        case GL_READ_FRAMEBUFFER:
+            setIntegers(GL_READ_FRAMEBUFFER_BINDING, &val, 1);
+            break;
+    }
+}
+
+void GLContextShadowState::bindRenderbuffer(GLuint name) {
+    GLint val = static_cast<GLint>(name);
+    setIntegers(GL_RENDERBUFFER_BINDING, &val, 1);
+}
+
+void GLContextShadowState::deleteBuffer(GLuint name) {
+    for (size_t i = 0; i < sizeof(s_BufferBindings) / sizeof(s_BufferBindings[0]); i++) {
+        unbind(s_BufferBindings[i], name);
+    }
+}
+
+void GLContextShadowState::deleteVertexArray(GLuint name) {
+    GLint current;
+    if (name && getIntegerv(GL_VERTEX_ARRAY_BINDING, &current, 1) &&
+        static_cast<GLuint>(current) == name) {
+        bindVertexArray(0);
+    } else if (name) {
+        //cannot tell if deleted VAO was bound
+        invalidate(GL_VERTEX_ARRAY_BINDING);
+        invalidate(GL_ELEMENT_ARRAY_BUFFER_BINDING);
+    }
+}
+
+void GLContextShadowState::deleteFramebuffer(GLuint name) {
+    unbind(GL_DRAW_FRAMEBUFFER_BINDING, name);
+    unbind(GL_READ_FRAMEBUFFER_BINDING, name);
+}
+
+void GLContextShadowState::deleteRenderbuffer(GLuint name) {
+    unbind(GL_RENDERBUFFER_BINDING, name);
+}
+
+void GLContextShadowState::invalidate(GLenum pname) { m_Values.erase(pname); }
+
+void GLContextShadowState::invalidateEnabled(GLenum cap) { m_Enabled.erase(cap); }
+
+void GLContextShadowState::invalidateAll() {
+    m_Enabled.clear();
+    m_Values.clear();
+}
+
+bool GLContextShadowState::getEnabled(GLenum cap, GLboolean* ret) const {
+    auto i = m_Enabled.find(cap);
+    if (i == m_Enabled.end()) {
+        return false;
+    }
+    *ret = i->second ? GL_TRUE : GL_FALSE;
+    return true;
+}
+
+bool GLContextShadowState::getIntegerv(GLenum pname, GLint* ret,
+                                       size_t length) const {
+    return get(pname, ValueType::Integer, ret, length);
+}
+
+bool GLContextShadowState::getBoundBuffer(GLenum target, GLuint* ret) const {
+    GLenum binding = bufferTargetToBinding(target);
+    GLint val = 0;
+    if (!binding || !getIntegerv(binding, &val, 1)) {
+        return false;
+    }
+    *ret = static_cast<GLuint>(val);
+    return true;
+}
+
+bool GLContextShadowState::getInteger64v(GLenum pname, GLint64* ret,
+                                         size_t length) const {
+    return get(pname, ValueType::Integer64, ret, length);
+}
+
+bool GLContextShadowState::getFloatv(GLenum pname, GLfloat* ret,
+                                     size_t length) const {
+    return get(pname, ValueType::Float, ret, length);
+}
+
+bool GLContextShadowState::getDoublev(GLenum pname, GLdouble* ret,
+                                      size_t length) const {
+    return get(pname, ValueType::Double, ret, length);
+}
+
+bool GLContextShadowState::getBooleanv(GLenum pname, GLboolean* ret,
+                                       size_t length) const {
+    std::vector<GLdouble> val(length);
+    if (!length || !get(pname, ValueType::Boolean, &val[0], length)) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        ret[i] = (val[i] != 0.0) ? GL_TRUE : GL_FALSE;
+    }
+    return true;
+}
+
+void GLContextShadowState::learnEnabled(GLenum cap, GLboolean value) {
+    setEnabled(cap, value != GL_FALSE);
+}
+
+void GLContextShadowState::learnIntegerv(GLenum pname, const GLint* value,
+                                         size_t length) {
+    learn(pname, ValueType::Integer, value, length);
+}
+
+void GLContextShadowState::learnInteger64v(GLenum pname, const GLint64* value,
+                                           size_t length) {
+    learn(pname, ValueType::Integer64, value, length);
+}
+
+void GLContextShadowState::learnFloatv(GLenum pname, const GLfloat* value,
+                                       size_t length) {
+    learn(pname, ValueType::Float, value, length);
+}
+
+void GLContextShadowState::learnDoublev(GLenum pname, const GLdouble* value,
+                                        size_t length) {
+    learn(pname, ValueType::Double, value, length);
+}
+
+void GLContextShadowState::learnBooleanv(GLenum pname, const GLboolean* value,
+                                         size_t length) {
+    learn(pname, ValueType::Boolean, value, length);
+}
+
+GLenum GLContextShadowState::getActiveTexture() {
+    GLint activeTexture;
+    if (!getIntegerv(GL_ACTIVE_TEXTURE, &activeTexture, 1)) {
+        DIRECT_CALL_CHK(glGetIntegerv)(GL_ACTIVE_TEXTURE, &activeTexture);
+        learnIntegerv(GL_ACTIVE_TEXTURE, &activeTexture, 1);
+    }
+    return static_cast<GLenum>(activeTexture);
+}
+
+template <typename T>
+bool GLContextShadowState::get(GLenum pname, ValueType type, T* ret,
+                               size_t length) const {
+    auto i = m_Values.find(pname);
+    if (i == m_Values.end() || i->second.m_Data.size() != length) {
+        return false;
+    }
+    // tracked integer values are converted exactly by all getters. Values
+    // read from driver are returned only to the same getter.
+    if (i->second.m_Type != ValueType::Tracked && i->second.m_Type != type) {
+        return false;
+    }
+    for (size_t j = 0; j < length; j++) {
+        ret[j] = static_cast<T>(i->second.m_Data[j]);
+    }
+    return true;
+}
+
+template <typename T>
+void GLContextShadowState::learn(GLenum pname, ValueType type, const T* value,
+                                 size_t length) {
+    if (!isTrackedState(pname)) {
+        return;
+    }
+    Value& v = m_Values[pname];
+    v.m_Type = type;
+    v.m_Data.assign(value, value + length);
+}
+
+void GLContextShadowState::setIntegers(GLenum pname, const GLint* value,
+                                       size_t length) {
+    learn(pname, ValueType::Tracked, value, length);
+}
+
+void GLContextShadowState::unbind(GLenum pname, GLuint name) {
+    GLint current;
+    if (!name) {
+        return;
+    }
+    if (getIntegerv(pname, &current, 1)) {
+        if (static_cast<GLuint>(current) == name) {
+            current = 0;
+            setIntegers(pname, &current, 1);
+        }
+    } else {
+        // unknown binding may refer to deleted object
+        invalidate(pname);
+    }
+}
 
-}
\ No newline at end of file
+}
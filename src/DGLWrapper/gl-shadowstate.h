@@ -19,6 +19,9 @@
 #include "gl-utils.h"
 #include "gl-texunit.h"
 
+#include <map>
+#include <vector>
+
 namespace dglState {
     
     class GLContextShadowState {
@@ -26,6 +29,11 @@ namespace dglState {
 
             GLContextShadowState();
 
+            /**
+             * Initialize shadow state. Called on first bind of context
+             */
+            void init();
+
             /**
              * Getter for texture units container
              */
@@ -41,18 +49,143 @@ namespace dglState {
 
             inline bool inImmediateMode() { return m_InImmediateMode; }
 
+            /**
+             * Display list compile mode setter - must be set, when between
+             * glNewList(GL_COMPILE) and glEndList(). Calls compiled into list
+             * are not executed, so they do not change shadowed state.
+             */
+            inline void setListCompileMode(bool compile) { m_InListCompileMode = compile; }
+
+            inline bool inListCompileMode() { return m_InListCompileMode; }
+
+            /**
+             * Setters called from intercepted GL calls (only if call did not
+             * produce GL error)
+             */
+            void setEnabled(GLenum cap, bool enabled);
+            void setViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+            void setScissor(GLint x, GLint y, GLsizei width, GLsizei height);
+            void setBlendFunc(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+            void setBlendEquation(GLenum modeRGB, GLenum modeAlpha);
+            void setDepthFunc(GLenum func);
+            void setDepthMask(GLboolean flag);
+            void setPixelStore(GLenum pname, GLint param);
+            void setActiveTexture(GLenum texture);
+            void bindBuffer(GLenum target, GLuint name);
+            void bindVertexArray(GLuint name);
+            void bindFramebuffer(GLenum target, GLuint name, bool separateReadDraw);
+            void bindRenderbuffer(GLuint name);
+            void vertexArrayElementBuffer(GLuint vaobj, GLuint buffer);
+
+            /**
+             * Object deletion - resets all bindings of deleted object to 0
+             */
+            void deleteBuffer(GLuint name);
+            void deleteVertexArray(GLuint name);
+            void deleteFramebuffer(GLuint name);
+            void deleteRenderbuffer(GLuint name);
+
+            /**
+             * Drop shadowed value - it will be re-read from driver on next query
+             */
+            void invalidate(GLenum pname);
+            void invalidateEnabled(GLenum cap);
+            void invalidateAll();
+
+            /**
+             * Shadowed state getters. Return false, if value is not known.
+             */
+            bool getEnabled(GLenum cap, GLboolean* ret) const;
+            bool getIntegerv(GLenum pname, GLint* ret, size_t length) const;
+            bool getInteger64v(GLenum pname, GLint64* ret, size_t length) const;
+            bool getFloatv(GLenum pname, GLfloat* ret, size_t length) const;
+            bool getDoublev(GLenum pname, GLdouble* ret, size_t length) const;
+            bool getBooleanv(GLenum pname, GLboolean* ret, size_t length) const;
+
+            /**
+             * Get buffer bound to given target. Returns false, if binding is
+             * not known (or target has no tracked binding).
+             */
+            bool getBoundBuffer(GLenum target, GLuint* ret) const;
+
+            /**
+             * Store value read from driver. Ignored for state, that is not
+             * tracked by intercepted setters.
+             */
+            void learnEnabled(GLenum cap, GLboolean value);
+            void learnIntegerv(GLenum pname, const GLint* value, size_t length);
+            void learnInteger64v(GLenum pname, const GLint64* value, size_t length);
+            void learnFloatv(GLenum pname, const GLfloat* value, size_t length);
+            void learnDoublev(GLenum pname, const GLdouble* value, size_t length);
+            void learnBooleanv(GLenum pname, const GLboolean* value, size_t length);
+
+            /**
+             * Get active texture unit (GL_TEXTUREi)
+             */
+            GLenum getActiveTexture();
+
             
             GLuint m_CurrentProgram;
         private:
+
+            /**
+             * Origin of shadowed value. Values set from intercepted calls
+             * (Tracked) are integers, and can be converted to any type.
+             * Values read from driver are returned only for the same getter.
+             */
+            enum class ValueType {
+                Tracked,
+                Integer,
+                Integer64,
+                Float,
+                Double,
+                Boolean,
+            };
+
+            struct Value {
+                ValueType m_Type;
+                std::vector<GLdouble> m_Data;
+            };
+
+            template <typename T>
+            bool get(GLenum pname, ValueType type, T* ret, size_t length) const;
+
+            template <typename T>
+            void learn(GLenum pname, ValueType type, const T* value, size_t length);
+
+            void setIntegers(GLenum pname, const GLint* value, size_t length);
+
+            void unbind(GLenum pname, GLuint name);
+
             /**
              * Set to true if betweek glBegin() and glEnd()
              */
             bool m_InImmediateMode;
 
+            /**
+             * Set to true if between glNewList(GL_COMPILE) and glEndList()
+             */
+            bool m_InListCompileMode;
+
             /**
              * Shadow of all bound textures
              */
             AllTextureUnits m_TextureUnits;
+
+            /**
+             * Shadow of glEnable()/glDisable() state
+             */
+            std::map<GLenum, bool> m_Enabled;
+
+            /**
+             * Shadow of state queried by glGet*()
+             */
+            std::map<GLenum, Value> m_Values;
+
+            /**
+             * Cached GL_MAX_VIEWPORT_DIMS, used to predict viewport clamping
+             */
+            GLint m_MaxViewportDims[2];
     };
 }
 
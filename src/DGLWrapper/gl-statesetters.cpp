@@ -22,9 +22,85 @@ namespace dglState {
 
 namespace state_setters {
 
+QuerySession::QuerySession(GLContext* ctx)
+        : m_Ctx(ctx),
+          m_Outermost(!ctx->m_QuerySession),
+          m_PBOSaved(false),
+          m_PBO(0),
+          m_PixelStoreSaved(false),
+          m_RenderBufferSaved(false),
+          m_RenderBuffer(0),
+          m_MaxDrawBuffers(-1) {
+    if (m_Outermost) {
+        m_Ctx->m_QuerySession = this;
+    }
+}
+
+QuerySession::~QuerySession() {
+    if (m_Outermost) {
+        restore();
+        m_Ctx->m_QuerySession = NULL;
+    }
+}
+
+void QuerySession::restore() {
+    if (m_PBOSaved && m_PBO) {
+        DIRECT_CALL_CHK(glBindBuffer)(GL_PIXEL_PACK_BUFFER, static_cast<GLuint>(m_PBO));
+    }
+    m_PBOSaved = false;
+
+    if (m_PixelStoreSaved) {
+        PixelStoreAlignment::restore(m_PixelStore);
+    }
+    m_PixelStoreSaved = false;
+
+    if (m_RenderBufferSaved) {
+        DIRECT_CALL_CHK(glBindRenderbuffer)(GL_RENDERBUFFER, static_cast<GLuint>(m_RenderBuffer));
+    }
+    m_RenderBufferSaved = false;
+}
+
+void QuerySession::unbindPBO() {
+    if (!m_PBOSaved) {
+        m_PBOSaved = true;
+        if (m_Ctx->hasCapability(GLContext::ContextCap::PixelBufferObjects)) {
+            m_PBO = m_Ctx->getShadowedInteger(GL_PIXEL_PACK_BUFFER_BINDING);
+        } else {
+            m_PBO = 0;
+        }
+        if (m_PBO) {
+            DIRECT_CALL_CHK(glBindBuffer)(GL_PIXEL_PACK_BUFFER, 0);
+        }
+    }
+}
+
+void QuerySession::setDefaultPixelStore() {
+    if (!m_PixelStoreSaved) {
+        m_PixelStoreSaved = true;
+        PixelStoreAlignment::setDefaults(m_Ctx, m_PixelStore);
+    }
+}
+
+void QuerySession::saveRenderBuffer() {
+    if (!m_RenderBufferSaved) {
+        m_RenderBufferSaved = true;
+        m_RenderBuffer = m_Ctx->getShadowedInteger(GL_RENDERBUFFER_BINDING);
+    }
+}
+
+GLint QuerySession::getMaxDrawBuffers() {
+    if (m_MaxDrawBuffers < 0) {
+        DIRECT_CALL_CHK(glGetIntegerv)(GL_MAX_DRAW_BUFFERS, &m_MaxDrawBuffers);
+    }
+    return m_MaxDrawBuffers;
+}
+
 DefaultPBO::DefaultPBO(GLContext* ctx) : m_Ctx(ctx) {
-    if (m_Ctx->hasCapability(GLContext::ContextCap::PixelBufferObjects)) {
-        DIRECT_CALL_CHK(glGetIntegerv)(GL_PIXEL_PACK_BUFFER_BINDING, &m_PBO);
+    if (QuerySession* session = m_Ctx->getQuerySession()) {
+        session->unbindPBO();
+        m_PBO = 0;
+    } else if (m_Ctx->hasCapability(GLContext::ContextCap::PixelBufferObjects)) {
+        m_PBO = m_Ctx->getShadowedInteger(GL_PIXEL_PACK_BUFFER_BINDING);
     } else {
         m_PBO = 0;
     }
@@ -44,14 +120,12 @@ CurrentFramebuffer::CurrentFramebuffer(GLContext* ctx, GLuint name)
         if (m_Ctx->hasCapability(GLContext::ContextCap::
                                          SeparateReadDrawFramebufferObjects)) {
             // full FBO support
-            DIRECT_CALL_CHK(glGetIntegerv)(GL_READ_FRAMEBUFFER_BINDING,
-                                           &m_ReadFBO);
-            DIRECT_CALL_CHK(glGetIntegerv)(GL_DRAW_FRAMEBUFFER_BINDING,
-                                           &m_DrawFBO);
+            m_ReadFBO = m_Ctx->getShadowedInteger(GL_READ_FRAMEBUFFER_BINDING);
+            m_DrawFBO = m_Ctx->getShadowedInteger(GL_DRAW_FRAMEBUFFER_BINDING);
             DIRECT_CALL_CHK(glBindFramebuffer)(GL_FRAMEBUFFER, name);
         } else {
             // only single draw+read fbo binding is supported
-            DIRECT_CALL_CHK(glGetIntegerv)(GL_FRAMEBUFFER_BINDING, &m_DrawFBO);
+            m_DrawFBO = m_Ctx->getShadowedInteger(GL_FRAMEBUFFER_BINDING);
             DIRECT_CALL_CHK(glBindFramebuffer)(GL_FRAMEBUFFER, name);
         }
     }
@@ -84,7 +158,11 @@ ReadBuffer::~ReadBuffer() {
 DrawBuffers::DrawBuffers(GLContext* ctx) : m_Ctx(ctx) {
     if (m_Ctx->hasCapability(GLContext::ContextCap::DrawBuffersMRT)) {
         GLint maxDrawBuffers;
-        DIRECT_CALL_CHK(glGetIntegerv)(GL_MAX_DRAW_BUFFERS, &maxDrawBuffers);
+        if (QuerySession* session = m_Ctx->getQuerySession()) {
+            maxDrawBuffers = session->getMaxDrawBuffers();
+        } else {
+            DIRECT_CALL_CHK(glGetIntegerv)(GL_MAX_DRAW_BUFFERS, &maxDrawBuffers);
+        }
         m_DrawBuffers.resize(static_cast<size_t>(maxDrawBuffers));
         for (GLint i = 0; i < maxDrawBuffers; i++) {
             DIRECT_CALL_CHK(glGetIntegerv)(GL_DRAW_BUFFER0 + i,
@@ -135,33 +213,56 @@ DrawBuffers::~DrawBuffers() {
     }
 }
 
-RenderBuffer::RenderBuffer() {
-    DIRECT_CALL_CHK(glGetIntegerv)(GL_RENDERBUFFER_BINDING, &m_RenderBuffer);
+RenderBuffer::RenderBuffer(GLContext* ctx) : m_Restore(true) {
+    if (QuerySession* session = ctx->getQuerySession()) {
+        session->saveRenderBuffer();
+        m_Restore = false;
+    } else {
+        m_RenderBuffer = ctx->getShadowedInteger(GL_RENDERBUFFER_BINDING);
+    }
 }
 RenderBuffer::~RenderBuffer() {
-    DIRECT_CALL_CHK(glBindRenderbuffer)(GL_RENDERBUFFER, m_RenderBuffer);
+    if (m_Restore) {
+        DIRECT_CALL_CHK(glBindRenderbuffer)(GL_RENDERBUFFER, m_RenderBuffer);
+    }
 }
 
 PixelStoreAlignment::PixelStoreAlignment(GLContext* ctx) : m_Ctx(ctx) {
+    if (QuerySession* session = m_Ctx->getQuerySession()) {
+        session->setDefaultPixelStore();
+        // nothing to restore here, session will do it.
+        for (int i = 0; i < STATE_SIZE; i++) {
+            m_SavedState[i] = s_StateTable[i].m_State;
+        }
+    } else {
+        setDefaults(m_Ctx, m_SavedState);
+    }
+}
+PixelStoreAlignment::~PixelStoreAlignment() {
+    restore(m_SavedState);
+}
+
+void PixelStoreAlignment::setDefaults(GLContext* ctx, GLint* saved) {
     // dump and set pixel store state
     for (int i = 0; i < STATE_SIZE; i++) {
-        if (m_Ctx->getVersion().check(GLContextVersion::Type::DT) ||
+        saved[i] = s_StateTable[i].m_State;
+        if (ctx->getVersion().check(GLContextVersion::Type::DT) ||
             (s_StateTable[i].m_ES3 &&
-             m_Ctx->getVersion().check(GLContextVersion::Type::ES, 3))) {
-            DIRECT_CALL_CHK(glGetIntegerv)(s_StateTable[i].m_Target,
-                                           &s_StateTable[i].m_SavedState);
-            DIRECT_CALL_CHK(glPixelStorei)(s_StateTable[i].m_Target,
-                                           s_StateTable[i].m_State);
+             ctx->getVersion().check(GLContextVersion::Type::ES, 3))) {
+            saved[i] = ctx->getShadowedInteger(s_StateTable[i].m_Target);
+            if (saved[i] != s_StateTable[i].m_State) {
+                DIRECT_CALL_CHK(glPixelStorei)(s_StateTable[i].m_Target,
+                                               s_StateTable[i].m_State);
+            }
         }
     }
 }
-PixelStoreAlignment::~PixelStoreAlignment() {
+
+void PixelStoreAlignment::restore(const GLint* saved) {
     for (int i = 0; i < STATE_SIZE; i++) {
-        if (m_Ctx->getVersion().check(GLContextVersion::Type::DT) ||
-            (s_StateTable[i].m_ES3 &&
-             m_Ctx->getVersion().check(GLContextVersion::Type::ES, 3))) {
+        if (saved[i] != s_StateTable[i].m_State) {
             DIRECT_CALL_CHK(glPixelStorei)(s_StateTable[i].m_Target,
-                                           s_StateTable[i].m_SavedState);
+                                           saved[i]);
         }
     }
 }
@@ -172,13 +273,13 @@ int PixelStoreAlignment::getAligned(int x) {
 }
 
 PixelStoreAlignment::StateEntry PixelStoreAlignment::s_StateTable[STATE_SIZE] =
-        {{GL_PACK_SWAP_BYTES, GL_FALSE, false, 0},
-         {GL_PACK_LSB_FIRST, GL_FALSE, false, 0},
-         {GL_PACK_ROW_LENGTH, 0, true, 0},
-         {GL_PACK_IMAGE_HEIGHT, 0, false, 0},
-         {GL_PACK_SKIP_ROWS, 0, true, 0},
-         {GL_PACK_SKIP_PIXELS, 0, true, 0},
-         {GL_PACK_SKIP_IMAGES, 0, false, 0},
-         {GL_PACK_ALIGNMENT, 4, true, 0}, };
+        {{GL_PACK_SWAP_BYTES, GL_FALSE, false},
+         {GL_PACK_LSB_FIRST, GL_FALSE, false},
+         {GL_PACK_ROW_LENGTH, 0, true},
+         {GL_PACK_IMAGE_HEIGHT, 0, false},
+         {GL_PACK_SKIP_ROWS, 0, true},
+         {GL_PACK_SKIP_PIXELS, 0, true},
+         {GL_PACK_SKIP_IMAGES, 0, false},
+         {GL_PACK_ALIGNMENT, 4, true}, };
 }
 }
\ No newline at end of file
@@ -25,6 +25,62 @@ class GLContext;
 
 namespace state_setters {
 
+#define STATE_SIZE 8
+
+/**
+ * Batch of queries sharing one save/restore of application state.
+ *
+ * Context-wide state changed by DefaultPBO, PixelStoreAlignment and
+ * RenderBuffer is saved on first use and restored once, when session ends
+ * (or on restore()). Inside nested session the outermost one is used.
+ *
+ * Framebuffer bindings and read/draw buffers are still restored by each
+ * setter: read and draw buffers belong to currently bound framebuffer.
+ */
+class QuerySession {
+   public:
+    QuerySession(GLContext* ctx);
+    ~QuerySession();
+
+    /**
+     * Restore saved application state now. State will be saved again on next
+     * use.
+     */
+    void restore();
+
+   private:
+    QuerySession(const QuerySession&);
+    QuerySession& operator=(const QuerySession&);
+
+    void unbindPBO();
+    void setDefaultPixelStore();
+    void saveRenderBuffer();
+    GLint getMaxDrawBuffers();
+
+    GLContext* m_Ctx;
+
+    /**
+     * False for nested session, that leaves all work to outermost one.
+     */
+    bool m_Outermost;
+
+    bool m_PBOSaved;
+    GLint m_PBO;
+
+    bool m_PixelStoreSaved;
+    GLint m_PixelStore[STATE_SIZE];
+
+    bool m_RenderBufferSaved;
+    GLint m_RenderBuffer;
+
+    GLint m_MaxDrawBuffers;
+
+    friend class DefaultPBO;
+    friend class DrawBuffers;
+    friend class RenderBuffer;
+    friend class PixelStoreAlignment;
+};
+
 class DefaultPBO {
    public:
     DefaultPBO(GLContext* ctx);
@@ -67,15 +123,15 @@ class DrawBuffers {
 
 class RenderBuffer {
    public:
-    RenderBuffer();
+    RenderBuffer(GLContext* ctx);
     ~RenderBuffer();
 
    private:
+    bool m_Restore;
     GLint m_RenderBuffer;
 };
 
 class PixelStoreAlignment {
-#define STATE_SIZE 8
    public:
     PixelStoreAlignment(GLContext* ctx);
     ~PixelStoreAlignment();
@@ -84,13 +140,30 @@ class PixelStoreAlignment {
     int getAligned(int x);
 
    private:
+    /**
+     * Save application state to saved[] and set pixel store to defaults.
+     */
+    static void setDefaults(GLContext* ctx, GLint* saved);
+
+    /**
+     * Restore application state saved by setDefaults().
+     */
+    static void restore(const GLint* saved);
+
     static struct StateEntry {
         GLenum m_Target;
         GLint m_State;
         bool m_ES3;
-        GLint m_SavedState;
     } s_StateTable[STATE_SIZE];
+
+    friend class QuerySession;
     GLContext* m_Ctx;
+
+    /**
+     * Saved application state. Entries equal to s_StateTable were not changed
+     * and are not restored.
+     */
+    GLint m_SavedState[STATE_SIZE];
 };
 }
 }
@@ -20,29 +20,20 @@ namespace dglState {
 
 
     
-    void TextureUnit::bindTexture(GLenum target, GLuint name) {
-        if (name) {
-            m_BoundTextures[target] = name;
-        } else {
-            auto i = m_BoundTextures.find(target);
-            if (i != m_BoundTextures.end()) {
+    GLuint TextureUnit::bindTexture(GLenum target, GLuint name) {
+        GLuint prev = 0;
+        auto i = m_BoundTextures.find(target);
+        if (i != m_BoundTextures.end()) {
+            prev = i->second;
+            if (name) {
+                i->second = name;
+            } else {
                 m_BoundTextures.erase(i);
             }
+        } else if (name) {
+            m_BoundTextures.insert(std::make_pair(target, name));
         }
-    }
-
-    void TextureUnit::unbindTexture(GLuint name) {
-        
-        auto i = m_BoundTextures.begin();
-
-        while(i != m_BoundTextures.end()) {
-            auto next = i;
-            ++next;
-            if (i->second == name) {
-                bindTexture(i->first, 0);
-            }
-            i = next;
-        }
+        return prev;
     }
 
     std::set<dglnet::ContextObjectName> TextureUnit::report(opaque_id_t ctxId) {
@@ -55,43 +46,102 @@ namespace dglState {
         return ret;
     }
 
+    AllTextureUnits::AllTextureUnits() : m_ReportCtxId(0), m_ReportValid(false) {}
+
     void AllTextureUnits::init() {
         
         GLint numUnits = 16;
         DIRECT_CALL_CHK(glGetIntegerv)(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &numUnits);
         
-        m_Units.resize(static_cast<size_t>(numUnits));
+        resize(static_cast<size_t>(numUnits));
         
     }
 
-    void AllTextureUnits::bindTexture(GLenum target, GLuint name) {
-        
-        GLint activeUnit; 
-        DIRECT_CALL_CHK(glGetIntegerv)(GL_ACTIVE_TEXTURE, &activeUnit);
+    void AllTextureUnits::resize(size_t units) {
+        m_Units.resize(units);
+        m_Report.resize(units);
+        m_UnitDirty.resize(units, false);
+        m_ReportValid = false;
+    }
+
+    void AllTextureUnits::bindTexture(GLenum activeTexture, GLenum target, GLuint name) {
         
-        activeUnit -= GL_TEXTURE0;
+        GLint activeUnit = static_cast<GLint>(activeTexture - GL_TEXTURE0);
 
         if (activeUnit >= static_cast<GLint>(m_Units.size())) {
             //that's very strange. 
-            m_Units.resize(static_cast<size_t>(activeUnit) + 1);
+            resize(static_cast<size_t>(activeUnit) + 1);
         }
-        m_Units[activeUnit].bindTexture(target, name);
+        size_t unit = static_cast<size_t>(activeUnit);
 
+        GLuint prev = m_Units[unit].bindTexture(target, name);
+        if (prev == name) {
+            return;
+        }
+        if (prev) {
+            removeBinding(prev, unit, target);
+        }
+        if (name) {
+            m_Bindings[name].push_back(std::make_pair(unit, target));
+        }
+        markDirty(unit);
     }
 
     void AllTextureUnits::unbindTexture(GLuint name) {
-        for (size_t i = 0; i < m_Units.size(); i++) {
-             m_Units[i].unbindTexture(name);
+        auto i = m_Bindings.find(name);
+        if (i == m_Bindings.end()) {
+            return;
+        }
+        for (size_t j = 0; j < i->second.size(); j++) {
+            m_Units[i->second[j].first].bindTexture(i->second[j].second, 0);
+            markDirty(i->second[j].first);
+        }
+        m_Bindings.erase(i);
+    }
+
+    void AllTextureUnits::removeBinding(GLuint name, size_t unit, GLenum target) {
+        auto i = m_Bindings.find(name);
+        if (i == m_Bindings.end()) {
+            return;
+        }
+        std::vector<std::pair<size_t, GLenum> >& bindings = i->second;
+        for (size_t j = 0; j < bindings.size(); j++) {
+            if (bindings[j].first == unit && bindings[j].second == target) {
+                bindings[j] = bindings.back();
+                bindings.pop_back();
+                break;
+            }
+        }
+        if (bindings.empty()) {
+            m_Bindings.erase(i);
         }
     }
 
-    std::vector<std::set<dglnet::ContextObjectName> > AllTextureUnits::report(opaque_id_t ctxId) {
-        std::vector<std::set<dglnet::ContextObjectName> > ret(m_Units.size());
+    void AllTextureUnits::markDirty(size_t unit) {
+        if (!m_UnitDirty[unit]) {
+            m_UnitDirty[unit] = true;
+            m_DirtyUnits.push_back(unit);
+        }
+    }
 
-        for (size_t i = 0; i < m_Units.size(); i++) {
-            ret[i] = m_Units[i].report(ctxId);
+    const std::vector<std::set<dglnet::ContextObjectName> >& AllTextureUnits::report(opaque_id_t ctxId) {
+        if (!m_ReportValid || ctxId != m_ReportCtxId) {
+            for (size_t i = 0; i < m_Units.size(); i++) {
+                m_Report[i] = m_Units[i].report(ctxId);
+                m_UnitDirty[i] = false;
+            }
+            m_DirtyUnits.clear();
+            m_ReportCtxId = ctxId;
+            m_ReportValid = true;
+        } else {
+            for (size_t i = 0; i < m_DirtyUnits.size(); i++) {
+                size_t unit = m_DirtyUnits[i];
+                m_Report[unit] = m_Units[unit].report(ctxId);
+                m_UnitDirty[unit] = false;
+            }
+            m_DirtyUnits.clear();
         }
-        return ret;
+        return m_Report;
     }
     
 } //dglState
\ No newline at end of file
@@ -23,14 +23,20 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <utility>
 
 namespace dglState {
 
 
     class TextureUnit {
     public:
-        void bindTexture(GLenum target, GLuint name);
-        void unbindTexture(GLuint name);
+        /**
+         * Bind name to target on this unit (0 unbinds).
+         *
+         * Returns name previously bound to target, or 0.
+         */
+        GLuint bindTexture(GLenum target, GLuint name);
 
         std::set<dglnet::ContextObjectName> report(opaque_id_t ctxId);
 
@@ -41,15 +47,44 @@ namespace dglState {
 
     class AllTextureUnits {
     public:
-        
+        AllTextureUnits();
+
         void init();        
-        void bindTexture(GLenum target, GLuint name);
+        void bindTexture(GLenum activeTexture, GLenum target, GLuint name);
+
+        /**
+         * Unbind deleted texture from all units and targets it is bound to.
+         *
+         * Cost depends only on number of bindings of this name.
+         */
         void unbindTexture(GLuint name);
         
-        std::vector<std::set<dglnet::ContextObjectName> > report(opaque_id_t ctxId);
+        /**
+         * Report bound textures, per unit.
+         *
+         * Report is cached, only units changed since last call are rebuilt.
+         */
+        const std::vector<std::set<dglnet::ContextObjectName> >& report(
+                opaque_id_t ctxId);
 
     private:
+        void resize(size_t units);
+        void removeBinding(GLuint name, size_t unit, GLenum target);
+        void markDirty(size_t unit);
+
         std::vector<TextureUnit> m_Units;
+
+        /**
+         * Reverse index: texture name -> (unit, target) pairs it is bound to.
+         */
+        std::unordered_map<GLuint, std::vector<std::pair<size_t, GLenum> > >
+                m_Bindings;
+
+        std::vector<std::set<dglnet::ContextObjectName> > m_Report;
+        std::vector<bool> m_UnitDirty;
+        std::vector<size_t> m_DirtyUnits;
+        opaque_id_t m_ReportCtxId;
+        bool m_ReportValid;
     };
 
     
@@ -42,11 +42,12 @@ MSAADownSampler::MSAADownSampler(dglState::GLContext* context, GLenum attTarget,
         // create renderbuffer for downsampling
         DIRECT_CALL_CHK(glGenRenderbuffers)(1, &m_DownsampledResource);
 
+        dglState::state_setters::RenderBuffer renderBuffer(m_Context);
+
         DIRECT_CALL_CHK(glBindRenderbuffer)(GL_RENDERBUFFER,
                                             m_DownsampledResource);
         DIRECT_CALL_CHK(glRenderbufferStorage)(
                 GL_RENDERBUFFER, attInternalFormat, width, height);
-        DIRECT_CALL_CHK(glBindRenderbuffer)(GL_RENDERBUFFER, 0);
 
     } else if (m_DownsampledResourceTarget == GL_TEXTURE_2D_MULTISAMPLE) {
 
@@ -231,4 +232,4 @@ bool getBoundTexture(GLenum target, GLuint& name) {
     return true;
 }
 
-}    // namespace glutils
\ No newline at end of file
+}    // namespace glutils
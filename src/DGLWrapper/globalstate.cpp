@@ -31,6 +31,8 @@ struct GlobalStateImpl {
 
 std::unique_ptr<GlobalStateImpl> GlobalState::s_GlobImpl;
 
+bool GlobalState::s_ForkLocked = false;
+
 
 GlobalStateImpl* GlobalState::GetImpl() {
     if (!s_GlobImpl) {
@@ -56,6 +58,27 @@ DGLDebugController& GlobalState::getDebugController() {
 DGLConfiguration& GlobalState::getConfiguration() {
     return GetImpl()->m_Configuration;
 }
+
+void GlobalState::forkPrepare() {
+    if (s_GlobImpl) {
+        s_GlobImpl->m_DebugController.onForkPrepare();
+        s_ForkLocked = true;
+    }
+}
+
+void GlobalState::forkParent() {
+    if (s_ForkLocked) {
+        s_ForkLocked = false;
+        s_GlobImpl->m_DebugController.onForkParent();
+    }
+}
+
+void GlobalState::forkChild() {
+    if (s_ForkLocked) {
+        s_ForkLocked = false;
+        s_GlobImpl->m_DebugController.onForkChild();
+    }
+}
  
 
 
@@ -39,10 +39,19 @@ public:
 
     static void reset();
 
+    /* pthread_atfork() handlers. Forwarded to debug controller, if it was
+     * already created (otherwise child will create new one on demand).
+    */
+    static void forkPrepare();
+    static void forkParent();
+    static void forkChild();
+
 private:
     inline static GlobalStateImpl* GetImpl();
 
     static std::unique_ptr<GlobalStateImpl> s_GlobImpl;
+
+    static bool s_ForkLocked;
 };
 
 /* Singleton wrapping all global state used from Loader Thread
@@ -0,0 +1,121 @@
+/* Copyright (C) 2016 Slawomir Cygan <slawomir.cygan@gmail.com>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "query-workers.h"
+
+#include <DGLNet/protocol/resource.h>
+#include <DGLCommon/os.h>
+
+#include <algorithm>
+
+const size_t QueryWorkers::kMaxWorkers = 4;
+
+QueryWorkers::QueryWorkers(size_t count)
+        : m_Count(count), m_Pending(0), m_Exit(false) {}
+
+QueryWorkers::~QueryWorkers() {
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Idle.wait(lock, [this] { return m_Pending == 0; });
+        m_Exit = true;
+    }
+    m_TaskReady.notify_all();
+    for (size_t i = 0; i < m_Threads.size(); i++) {
+        m_Threads[i].join();
+    }
+}
+
+size_t QueryWorkers::size() const { return m_Count; }
+
+size_t QueryWorkers::defaultCount() {
+    // hardware_concurrency() may return 0, if unknown
+    size_t count = static_cast<size_t>(std::thread::hardware_concurrency());
+    return std::max<size_t>(1, std::min(count, kMaxWorkers));
+}
+
+void QueryWorkers::post(
+        const std::vector<dglState::GLAuxContext*>& auxContexts,
+        dglState::GLContext::WorkerQuery query, Completion completion) {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (m_Threads.empty()) {
+            for (size_t i = 0; i < m_Count; i++) {
+                m_Threads.push_back(
+                        std::thread(&QueryWorkers::run, this, i));
+            }
+        }
+
+        Task task;
+        task.m_AuxContexts = auxContexts;
+        task.m_Query = query;
+        task.m_Completion = completion;
+        m_Tasks.push_back(task);
+        m_Pending++;
+    }
+    m_TaskReady.notify_one();
+}
+
+void QueryWorkers::wait() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Idle.wait(lock, [this] { return m_Pending == 0; });
+}
+
+void QueryWorkers::run(size_t index) {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_TaskReady.wait(lock,
+                             [this] { return m_Exit || !m_Tasks.empty(); });
+            if (m_Tasks.empty()) {
+                return;
+            }
+            task = m_Tasks.front();
+            m_Tasks.pop_front();
+        }
+
+        std::shared_ptr<dglnet::DGLResource> resource;
+        std::string error;
+        try {
+            resource = task.m_Query(task.m_AuxContexts[index]);
+        } catch (const std::exception& e) {
+            // nothing may escape worker thread: it would terminate
+            // application. Readback of big object may also throw bad_alloc.
+            error = e.what();
+        } catch (...) {
+            error = "Unknown error on query worker";
+        }
+
+        // serialization & compression of reply is done here, on worker
+        // thread.
+        try {
+            task.m_Completion(resource, error);
+        } catch (const std::exception& e) {
+            OS_DEBUG("Query worker completion failed: %s\n", e.what());
+        } catch (...) {
+            OS_DEBUG("Query worker completion failed\n");
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Pending--;
+            if (!m_Pending) {
+                m_Idle.notify_all();
+            }
+        }
+    }
+}
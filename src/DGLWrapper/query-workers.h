@@ -0,0 +1,143 @@
+/* Copyright (C) 2016 Slawomir Cygan <slawomir.cygan@gmail.com>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#ifndef QUERY_WORKERS_H
+#define QUERY_WORKERS_H
+
+#include "gl-context.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Pool of threads performing resource queries on auxiliary contexts.
+ *
+ * Each worker owns one auxiliary context of queried context (shared with it),
+ * so independent queries (textures, buffers) may be read back concurrently,
+ * while application thread keeps handling requests. Workers are started on
+ * first use.
+ */
+class QueryWorkers {
+   public:
+    /**
+     * Completion of query, called on worker thread. Error message is empty on
+     * success.
+     */
+    typedef std::function<void(std::shared_ptr<dglnet::DGLResource>,
+                               const std::string&)> Completion;
+
+    /**
+     * Ctor
+     */
+    QueryWorkers(size_t count);
+
+    /**
+     * Dtor. Waits for all pending queries and joins workers.
+     */
+    ~QueryWorkers();
+
+    /**
+     * Number of workers (and auxiliary contexts needed to post a query).
+     */
+    size_t size() const;
+
+    /**
+     * Default number of workers for this machine
+     */
+    static size_t defaultCount();
+
+    /**
+     * Queue query for execution. Worker #i runs it on auxContexts[i].
+     */
+    void post(const std::vector<dglState::GLAuxContext*>& auxContexts,
+              dglState::GLContext::WorkerQuery query, Completion completion);
+
+    /**
+     * Wait until all posted queries are completed.
+     *
+     * Must be called before application is continued: no auxiliary context
+     * may be current on worker thread, when application uses GL again.
+     */
+    void wait();
+
+   private:
+    /**
+     * Upper limit of worker count: readback is mostly bound by GPU and bus,
+     * not by CPU
+     */
+    static const size_t kMaxWorkers;
+
+    /**
+     * Single queued query
+     */
+    struct Task {
+        std::vector<dglState::GLAuxContext*> m_AuxContexts;
+        dglState::GLContext::WorkerQuery m_Query;
+        Completion m_Completion;
+    };
+
+    /**
+     * Worker thread main loop
+     */
+    void run(size_t index);
+
+    /**
+     * Number of worker threads
+     */
+    size_t m_Count;
+
+    /**
+     * Worker threads, empty until first post()
+     */
+    std::vector<std::thread> m_Threads;
+
+    /**
+     * Queued tasks
+     */
+    std::deque<Task> m_Tasks;
+
+    /**
+     * Number of tasks queued or in progress
+     */
+    size_t m_Pending;
+
+    /**
+     * True if workers should exit
+     */
+    bool m_Exit;
+
+    /**
+     * Mutex guarding task queue
+     */
+    std::mutex m_Mutex;
+
+    /**
+     * Signalled on new task or exit request
+     */
+    std::condition_variable m_TaskReady;
+
+    /**
+     * Signalled when all tasks are done
+     */
+    std::condition_variable m_Idle;
+};
+
+#endif
@@ -16,6 +16,34 @@
 #include "tls.h"
 #include "gl-context.h"
 #include "display.h"
+#include "debugger.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+
+namespace {
+void onThreadExit(void*) { DGLThreadState::releaseThread(); }
+
+/**
+ * Key with destructor, that calls DGLThreadState::releaseThread() on exit of
+ * thread which set a value for it. (On Windows it is called from DllMain).
+ */
+class ThreadExitKey {
+   public:
+    ThreadExitKey() { pthread_key_create(&m_Key, onThreadExit); }
+    ~ThreadExitKey() { pthread_key_delete(m_Key); }
+    pthread_key_t get() const { return m_Key; }
+
+   private:
+    pthread_key_t m_Key;
+};
+
+pthread_key_t getThreadExitKey() {
+    static ThreadExitKey s_Key;
+    return s_Key.get();
+}
+}
+#endif
 
 void DGLThreadState::resetAPI() {
     privAPI.m_Current = NULL;
@@ -24,6 +52,25 @@ void DGLThreadState::resetAPI() {
 
 void DGLThreadState::releaseAPI() { get()->resetAPI(); }
 
+void DGLThreadState::releaseThread() {
+    DGLThreadState* state = get();
+    delete state->privDebugger.m_HistoryRef;
+    state->privDebugger.m_HistoryRef = NULL;
+    state->privDebugger.m_History = NULL;
+    state->privDebugger.m_HistoryId = 0;
+}
+
+void DGLThreadState::setCallHistory(
+        const std::shared_ptr<ThreadCallHistory>& history, uint64_t historyId) {
+    delete privDebugger.m_HistoryRef;
+    privDebugger.m_HistoryRef = new std::shared_ptr<ThreadCallHistory>(history);
+    privDebugger.m_History = history.get();
+    privDebugger.m_HistoryId = historyId;
+#ifndef _WIN32
+    pthread_setspecific(getThreadExitKey(), this);
+#endif
+}
+
 DGLThreadState* DGLThreadState::get() {
 
     static DGL_THREAD_LOCAL DGLThreadState ret;
@@ -32,6 +79,10 @@ DGLThreadState* DGLThreadState::get() {
     if (!s_Initialized) {
         ret.resetAPI();
         ret.privDebugger.m_ActionProcessing = false;
+        ret.privDebugger.m_History = NULL;
+        ret.privDebugger.m_HistoryId = 0;
+        ret.privDebugger.m_HistoryRef = NULL;
+        ret.privDebugger.m_CallsSinceClockCheck = 0;
         s_Initialized = true;
     }
 
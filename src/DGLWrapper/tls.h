@@ -19,7 +19,10 @@
 #include <DGLCommon/gl-types.h>
 #include <DGLCommon/def.h>
 
+#include <memory>
+
 class DGLDisplayState;
+struct ThreadCallHistory;
 namespace dglState {
 class NativeSurfaceBase;
 class GLContext;
@@ -56,6 +59,18 @@ class DGLThreadState {
      */
     static void releaseAPI();
 
+    /**
+     * Release state held by thread between API calls - called on thread exit
+     */
+    static void releaseThread();
+
+    /**
+     * Set call history of this thread. Thread holds reference to it until
+     * thread exit (or until other history is set).
+     */
+    void setCallHistory(const std::shared_ptr<ThreadCallHistory>& history,
+                        uint64_t historyId);
+
     /**
     *  Get current TSS
     */
@@ -113,6 +128,25 @@ class DGLThreadState {
          * Current action recursion guard
          */
         bool m_ActionProcessing;
+
+        /*
+         * Call history of this thread. Valid only if m_HistoryId is id of
+         * current CallHistory object.
+         */
+        ThreadCallHistory* m_History;
+        uint64_t m_HistoryId;
+
+        /*
+         * Reference to m_History, dropped on thread exit (so history can be
+         * retired)
+         */
+        std::shared_ptr<ThreadCallHistory>* m_HistoryRef;
+
+        /*
+         * Number of calls since this thread checked, if it is time to poll
+         * debugger server
+         */
+        unsigned int m_CallsSinceClockCheck;
     } privDebugger;
 };
 
@@ -38,6 +38,8 @@ wrappersFile      = open(outputDir + "codegen_dgl_wrappers.inl",       "w")
 exportFile        = open(outputDir + "codegen_dgl_export.inl",         "w")
 exportExtFile     = open(outputDir + "codegen_dgl_export_ext.inl",     "w")
 exportAndroidFile = open(outputDir + "codegen_dgl_export_android.inl", "w")
+functionHashFile  = open(outputDir + "codegen_gl_function_hash.inl",   "w")
+enumNameTableFile = open(outputDir + "codegen_gl_enum_name_table.inl", "w")
 
 gles2onlyPat = re.compile('2\.[0-9]')
 gles3onlyPat = re.compile('3\.0')
@@ -122,6 +124,61 @@ class Entrypoint:
             ret += "defined(HAVE_" + lib.strip() + ")"
         return ret
         
+# FNV-1a with seed mixed into offset basis. Must match
+# entrypointNameHash() in DGLCommon/gl-entrypoints.cpp
+def nameHash(name, seed):
+    h = (2166136261 ^ seed) & 0xffffffff
+    for c in name:
+        h ^= ord(c)
+        h = (h * 16777619) & 0xffffffff
+    return h
+
+# Build minimal perfect hash (hash and displace) over names:
+# bucket = nameHash(name, 0) % len(names), then each name goes to slot
+# nameHash(name, displacements[bucket]) % len(names), or directly to slot
+# -displacements[bucket]-1 if displacement is negative (single-name bucket).
+def buildPerfectHash(names):
+    size = len(names)
+    buckets = [[] for i in range(size)]
+    for name in names:
+        buckets[nameHash(name, 0) % size].append(name)
+
+    displacements = [0] * size
+    slots = [None] * size
+
+    bucketOrder = sorted(range(size), key = lambda b: -len(buckets[b]))
+    freeSlots = []
+    for b in bucketOrder:
+        bucket = buckets[b]
+        if len(bucket) == 0:
+            break
+        if len(bucket) == 1:
+            if len(freeSlots) == 0:
+                freeSlots = [i for i in range(size) if slots[i] == None]
+                freeSlots.reverse()
+            slot = freeSlots.pop()
+            slots[slot] = bucket[0]
+            displacements[b] = -slot - 1
+            continue
+        d = 1
+        while True:
+            bucketSlots = [nameHash(name, d) % size for name in bucket]
+            if len(set(bucketSlots)) == len(bucket) and all(slots[s] == None for s in bucketSlots):
+                break
+            d += 1
+        for name, slot in zip(bucket, bucketSlots):
+            slots[slot] = name
+        displacements[b] = d
+    return displacements, slots
+
+# Evaluate enum value as it would be seen after (gl_t) cast in C++.
+# Returns None for values that are not integer constants (like "GLX").
+def enumValueToGLt(value):
+    m = re.match(r'^[(]*(?:[(][A-Za-z_0-9 ]+[)])?[(]?(-?(?:0x[0-9A-Fa-f]+|[0-9]+))[)]*$', value)
+    if not m:
+        return None
+    return int(m.group(1), 0) & 0xffffffffffffffff
+
 def listToString(list):
     str = "";
     for elem in list:
@@ -442,6 +499,33 @@ for name, enum in sorted(enums.items()):
 
 for name in enumGroups:
     print >> enumGroupFile, "ENUM_GROUP_LIST_ELEMENT(" + name + ")"
+
+#enum name lookup tables, sorted for binary search in GetGLEnumName():
+#first name of each value (by name) and first name of each (value, group) pair.
+enumNameTable = dict()
+enumGroupNameTable = dict()
+for name, enum in sorted(enums.items()):
+    if "_LINE_BIT" in name:
+        continue
+    value = enumValueToGLt(enum.value)
+    if value == None:
+        continue
+    if not value in enumNameTable:
+        enumNameTable[value] = name
+    for g in enum.groups:
+        if g != 'NoneGroup' and not (value, enumGroups.index(g)) in enumGroupNameTable:
+            enumGroupNameTable[(value, enumGroups.index(g))] = name
+for value, name in sorted(enumNameTable.items()):
+    print >> enumNameTableFile, "ENUM_NAME_ENTRY(" + hex(value).rstrip("L") + "ull, " + name + ")"
+for (value, group), name in sorted(enumGroupNameTable.items()):
+    print >> enumNameTableFile, "ENUM_GROUP_NAME_ENTRY(" + hex(value).rstrip("L") + "ull, GLEnumGroup::" + enumGroups[group] + ", " + name + ")"
+
+#perfect hash of entrypoint names (same set as codegen_gl_functions.inl)
+hashDisplacements, hashSlots = buildPerfectHash([name for name in sorted(entrypoints.keys()) if name not in blacklist])
+for d in hashDisplacements:
+    print >> functionHashFile, "FUNC_HASH_DISPLACEMENT(" + str(d) + ")"
+for name in hashSlots:
+    print >> functionHashFile, "FUNC_HASH_SLOT(" + name + ")"
         
 for name, entrypoint in sorted(entrypoints.items()):
     if name in blacklist:
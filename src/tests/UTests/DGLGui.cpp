@@ -16,8 +16,22 @@
 #include "gtest/gtest.h"
 
 #include <DGLGui/dglsyntaxhighlight.h>
+#include <DGLGui/dglblitkernels.h>
+#include <DGLGui/dgltreeview.h>
+#include <DGLNet/protocol/pixeltransfer.h>
+#include <DGLCommon/def.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <sstream>
 
 #include <QPlainTextEdit>
+#include <QTextCursor>
+#include <QTextDocument>
 
 using namespace std;
 
@@ -268,4 +282,518 @@ TEST_F(DGLGui, syntax_highlighter_parse_esslflag) {
         EXPECT_NO_FATAL_FAILURE(validateHL(&editor, expected, strings));
     }
 }
+
+namespace {
+
+/**
+ * Highlighter counting highlighted blocks
+ */
+class CountingHighlighter : public DGLSyntaxHighlighterGLSL {
+   public:
+    CountingHighlighter(QTextDocument* document)
+            : DGLSyntaxHighlighterGLSL(false, document), m_Count(0) {}
+
+    int m_Count;
+
+   protected:
+    void highlightBlock(const QString& text) {
+        m_Count++;
+        DGLSyntaxHighlighterGLSL::highlightBlock(text);
+    }
+};
+
+/**
+ * Generate large shader, like generated uber-shaders
+ */
+std::string getLargeShader(int functions) {
+    std::ostringstream shader;
+    shader << "#version 330" << std::endl
+           << "layout(location = 0) out vec4 color;" << std::endl
+           << "uniform sampler2D samplerImg;" << std::endl;
+    for (int i = 0; i < functions; i++) {
+        shader << "/* variant " << i << std::endl
+               << " * of generated function" << std::endl
+               << " */" << std::endl
+               << "vec4 variant" << i << "(in vec2 texcoord, float scale) {"
+               << std::endl
+               << "    // scaled lookup" << std::endl
+               << "    vec4 texcolor = texture(samplerImg, texcoord * "
+               << i << ".5e-1) + vec4(0x1F, 017, " << i << ", 1.0f);"
+               << std::endl
+               << "    if (texcolor.a < 0.5) {" << std::endl
+               << "        discard;" << std::endl
+               << "    }" << std::endl
+               << "    return clamp(texcolor * scale, 0.0, 1.0);" << std::endl
+               << "}" << std::endl;
+    }
+    return shader.str();
+}
+
+typedef std::vector<
+        std::vector<std::pair<std::pair<int, int>, QTextCharFormat> > >
+        formats_t;
+
+formats_t getFormats(const QTextDocument& document) {
+    formats_t ret;
+    for (QTextBlock it = document.begin(); it != document.end();
+         it = it.next()) {
+        ret.push_back(formats_t::value_type());
+        QList<QTextLayout::FormatRange> ranges =
+                it.layout()->additionalFormats();
+        for (int i = 0; i < ranges.size(); i++) {
+            ret.back().push_back(std::make_pair(
+                    std::make_pair(ranges[i].start, ranges[i].length),
+                    ranges[i].format));
+        }
+    }
+    return ret;
+}
+
+}    // namespace
+
+TEST_F(DGLGui, syntax_highlighter_incremental) {
+    QTextDocument document;
+    document.setPlainText(QString::fromStdString(getLargeShader(100)));
+
+    CountingHighlighter highlighter(&document);
+    highlighter.rehighlight();
+    QCoreApplication::processEvents();
+
+    const int middle = document.blockCount() / 2;
+
+    // edit not changing state of block: only edited block is rehighlighted
+    highlighter.m_Count = 0;
+    QTextCursor cursor(document.findBlockByNumber(middle));
+    cursor.insertText("float unused = 1.0; ");
+    EXPECT_EQ(1, highlighter.m_Count);
+
+    // opening comment changes state of following blocks, until comment end
+    highlighter.m_Count = 0;
+    cursor.insertText("/*");
+    EXPECT_LT(1, highlighter.m_Count);
+    EXPECT_GT(document.blockCount() - middle, highlighter.m_Count);
+
+    // result is same, as if whole document was highlighted
+    QTextDocument reference;
+    DGLSyntaxHighlighterGLSL referenceHighlighter(false, &reference);
+    reference.setPlainText(document.toPlainText());
+    QCoreApplication::processEvents();
+    EXPECT_TRUE(getFormats(reference) == getFormats(document));
+
+    highlighter.m_Count = 0;
+    cursor.deletePreviousChar();
+    cursor.deletePreviousChar();
+    EXPECT_LT(1, highlighter.m_Count);
+
+    reference.setPlainText(document.toPlainText());
+    QCoreApplication::processEvents();
+    EXPECT_TRUE(getFormats(reference) == getFormats(document));
+}
+
+TEST_F(DGLGui, syntax_highlighter_benchmark) {
+    QTextDocument document;
+    document.setPlainText(QString::fromStdString(getLargeShader(1000)));
+
+    CountingHighlighter highlighter(&document);
+
+    std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+    highlighter.rehighlight();
+    double fullTime = std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+    QCoreApplication::processEvents();
+
+    // typing in the middle of shader
+    QTextCursor cursor(document.findBlockByNumber(document.blockCount() / 2));
+    highlighter.m_Count = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; i++) {
+        cursor.insertText("x");
+    }
+    double typingTime = std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+
+    cout << "highlight of " << document.blockCount()
+         << " lines: " << fullTime << " ms, 100 keystrokes: " << typingTime
+         << " ms (" << highlighter.m_Count << " blocks rehighlighted)"
+         << endl;
+
+    EXPECT_EQ(100, highlighter.m_Count);
+}
+
+namespace {
+
+dglnet::message::utils::ContextReport getTreeReport(opaque_id_t ctx,
+                                                    gl_t textures) {
+    dglnet::message::utils::ContextReport report(ctx);
+    for (gl_t i = 1; i <= textures; i++) {
+        report.m_TextureSpace.insert(
+                dglnet::ContextObjectName(ctx, i, GL_TEXTURE_2D));
+        report.m_BufferSpace.insert(dglnet::ContextObjectName(ctx, i));
+    }
+    return report;
+}
+}
+
+TEST_F(DGLGui, tree_model_incremental) {
+    DGLTreeModel model(NULL);
+    std::vector<dglnet::message::utils::ContextReport> reports(
+            1, getTreeReport(1, 10000));
+    model.update(1, reports);
+
+    ASSERT_EQ(1, model.rowCount());
+    QModelIndex ctx = model.index(0, 0);
+    QModelIndex textures = model.index(0, 0, ctx);
+    EXPECT_EQ("Textures", model.data(textures).toString().toStdString());
+
+    // folder is populated only when view asks for it
+    EXPECT_TRUE(model.hasChildren(textures));
+    EXPECT_EQ(0, model.rowCount(textures));
+    ASSERT_TRUE(model.canFetchMore(textures));
+    model.fetchMore(textures);
+    ASSERT_EQ(DGLTreeModel::kFetchSize, model.rowCount(textures));
+
+    QPersistentModelIndex tracked = model.index(10, 0, textures);
+    EXPECT_EQ(11u, model.data(tracked, DGLTreeModel::SortRole).toUInt());
+
+    // delete texture 5, create 20000: only these rows are touched
+    reports[0].m_TextureSpace.erase(dglnet::ContextObjectName(1, 5));
+    reports[0].m_TextureSpace.insert(
+            dglnet::ContextObjectName(1, 20000, GL_TEXTURE_2D));
+    model.update(1, reports);
+
+    EXPECT_EQ(DGLTreeModel::kFetchSize, model.rowCount(textures));
+    ASSERT_TRUE(tracked.isValid());
+    EXPECT_EQ(9, tracked.row());
+    EXPECT_EQ(11u, model.data(tracked, DGLTreeModel::SortRole).toUInt());
+    EXPECT_EQ(6u, model.data(model.index(4, 0, textures),
+                             DGLTreeModel::SortRole).toUInt());
+
+    dglnet::ContextObjectName name;
+    dglnet::message::ObjectType type;
+    ASSERT_TRUE(model.getObject(tracked, name, type));
+    EXPECT_EQ(11u, name.m_Name);
+    EXPECT_TRUE(type == dglnet::message::ObjectType::Texture);
+    EXPECT_FALSE(model.getObject(textures, name, type));
+
+    // context removal
+    reports[0] = getTreeReport(2, 1);
+    model.update(2, reports);
+    ASSERT_EQ(1, model.rowCount());
+    EXPECT_FALSE(tracked.isValid());
+    EXPECT_TRUE(model.data(model.index(0, 0), Qt::DisplayRole)
+                        .toString()
+                        .startsWith("Context 0x2"));
+}
+
+TEST_F(DGLGui, tree_model_benchmark) {
+    DGLTreeModel model(NULL);
+    std::vector<dglnet::message::utils::ContextReport> reports(
+            1, getTreeReport(1, 50000));
+    model.update(1, reports);
+    QModelIndex textures = model.index(0, 0, model.index(0, 0));
+    while (model.canFetchMore(textures)) {
+        model.fetchMore(textures);
+    }
+    QPersistentModelIndex last = model.index(49999, 0, textures);
+
+    std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; i++) {
+        model.update(1, reports);
+    }
+    double unchangedTime = std::chrono::duration<double, std::milli>(
+                                   std::chrono::steady_clock::now() - start)
+                                   .count();
+
+    start = std::chrono::steady_clock::now();
+    for (gl_t i = 0; i < 100; i++) {
+        reports[0].m_TextureSpace.insert(
+                dglnet::ContextObjectName(1, 100000 + i, GL_TEXTURE_2D));
+        model.update(1, reports);
+    }
+    double changedTime = std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+
+    cout << "tree of " << 2 * 50000 << " objects, 100 unchanged updates: "
+         << unchangedTime << " ms, 100 single object updates: " << changedTime
+         << " ms" << endl;
+
+    EXPECT_EQ(50100, model.rowCount(textures));
+    EXPECT_EQ(49999, last.row());
+}
+
+namespace {
+
+size_t getOutputPixelSize(DGLBlitterBase::OutputFormat format) {
+    size_t ret = 0;
+    for (int i = 0; i < 4; i++) {
+        if (DGLBlitterBase::outputOffsets[format][i] >= 0) ret++;
+    }
+    return ret;
+}
+
+std::vector<unsigned char> getRandomPixels(gl_t type, size_t size,
+                                           std::mt19937& rng) {
+    std::vector<unsigned char> ret(size);
+    if (type == GL_FLOAT) {
+        std::uniform_real_distribution<float> dist(-0.5f, 1.5f);
+        const float specials[] = {std::numeric_limits<float>::quiet_NaN(),
+                                  std::numeric_limits<float>::infinity(),
+                                  -std::numeric_limits<float>::infinity(),
+                                  -0.0f, 0.0f, 1.0f, 1e30f, -1e30f};
+        for (size_t i = 0; i + sizeof(float) <= size; i += sizeof(float)) {
+            float v = dist(rng);
+            if (rng() % 8 == 0) {
+                v = specials[rng() % DGL_ARRAY_LENGTH(specials)];
+            }
+            memcpy(&ret[i], &v, sizeof(v));
+        }
+    } else {
+        for (size_t i = 0; i < size; i++) {
+            ret[i] = static_cast<unsigned char>(rng());
+        }
+    }
+    return ret;
+}
+
+/**
+ * Run kernel (or generic blitFunc, if kernel is nullptr) on whole image
+ */
+void runBlit(blitkernels::Kernel kernel, gl_t type, int components,
+             DGLBlitterBase::OutputFormat format, size_t width, size_t height,
+             const std::vector<unsigned char>& src, size_t srcStride,
+             std::vector<unsigned char>& dst, size_t dstStride,
+             std::pair<float, float>* scaleBias) {
+    if (kernel) {
+        kernel(width, height, &src[0], &dst[0], srcStride, dstStride,
+               scaleBias);
+    } else {
+        const GLDataType* dataType = GLFormats::getDataType(type);
+        dataType->blitFunc(DGLBlitterBase::outputOffsets[format], width,
+                           height, &src[0], &dst[0], srcStride, dstStride,
+                           dataType->byteSize * components,
+                           getOutputPixelSize(format), components, scaleBias);
+    }
+}
+}
+
+TEST_F(DGLGui, blit_kernels_exact) {
+    const gl_t types[] = {GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_FLOAT};
+    const DGLBlitterBase::OutputFormat formats[] = {
+            DGLBlitterBase::_GL_BGRA32, DGLBlitterBase::_GL_RGBX32,
+            DGLBlitterBase::_GL_MONO8};
+    std::pair<float, float> scaleBiases[2][4] = {
+            {std::make_pair(1.0f, 0.0f), std::make_pair(1.0f, 0.0f),
+             std::make_pair(1.0f, 0.0f), std::make_pair(1.0f, 0.0f)},
+            {std::make_pair(2.0f, -0.25f), std::make_pair(0.5f, 0.25f),
+             std::make_pair(-1.0f, 1.0f), std::make_pair(3.0f, 0.1f)}};
+
+    // odd width, so vector loops leave remainder pixels
+    const size_t width = 37, height = 5;
+
+    std::mt19937 rng(1234);
+
+    for (size_t t = 0; t < DGL_ARRAY_LENGTH(types); t++) {
+        for (int components = 1; components <= 4; components++) {
+            size_t srcStride = width * components *
+                                       GLFormats::getDataType(types[t])->byteSize +
+                               8;
+            std::vector<unsigned char> src =
+                    getRandomPixels(types[t], srcStride * height, rng);
+
+            for (size_t f = 0; f < DGL_ARRAY_LENGTH(formats); f++) {
+                size_t dstStride =
+                        (width * getOutputPixelSize(formats[f]) + 3) & ~3;
+
+                for (size_t s = 0; s < DGL_ARRAY_LENGTH(scaleBiases); s++) {
+                    std::vector<unsigned char> expected(dstStride * height,
+                                                        0xcd);
+                    runBlit(nullptr, types[t], components, formats[f], width,
+                            height, src, srcStride, expected, dstStride,
+                            scaleBiases[s]);
+
+                    for (int isa = 0;
+                         isa <= static_cast<int>(blitkernels::getBestISA());
+                         isa++) {
+                        blitkernels::Kernel kernel = blitkernels::getKernel(
+                                types[t], components, formats[f],
+                                static_cast<blitkernels::ISA>(isa));
+                        ASSERT_TRUE(kernel != nullptr);
+
+                        std::vector<unsigned char> actual(dstStride * height,
+                                                          0xcd);
+                        runBlit(kernel, types[t], components, formats[f],
+                                width, height, src, srcStride, actual,
+                                dstStride, scaleBiases[s]);
+
+                        EXPECT_TRUE(expected == actual)
+                                << "type " << types[t] << ", components "
+                                << components << ", format " << formats[f]
+                                << ", ISA " << isa;
+                    }
+                }
+            }
+        }
+    }
+
+    EXPECT_TRUE(blitkernels::getKernel(GL_UNSIGNED_SHORT_5_6_5, 3,
+                                       DGLBlitterBase::_GL_RGBX32,
+                                       blitkernels::getBestISA()) == nullptr);
+}
+
+TEST_F(DGLGui, blit_kernels_benchmark) {
+    const gl_t types[] = {GL_UNSIGNED_BYTE, GL_FLOAT};
+    const size_t width = 1024, height = 1024;
+    const int components = 4;
+    const DGLBlitterBase::OutputFormat format = DGLBlitterBase::_GL_BGRA32;
+
+    std::pair<float, float> scaleBias[4] = {
+            std::make_pair(1.0f, 0.0f), std::make_pair(1.0f, 0.0f),
+            std::make_pair(1.0f, 0.0f), std::make_pair(1.0f, 0.0f)};
+
+    std::mt19937 rng(1234);
+
+    for (size_t t = 0; t < DGL_ARRAY_LENGTH(types); t++) {
+        size_t srcStride =
+                width * components * GLFormats::getDataType(types[t])->byteSize;
+        std::vector<unsigned char> src =
+                getRandomPixels(types[t], srcStride * height, rng);
+        size_t dstStride = width * getOutputPixelSize(format);
+
+        blitkernels::Kernel kernels[2] = {
+                nullptr, blitkernels::getKernel(types[t], components, format,
+                                                blitkernels::getBestISA())};
+        std::vector<unsigned char> results[2];
+        double times[2];
+
+        for (int k = 0; k < 2; k++) {
+            results[k].resize(dstStride * height);
+            times[k] = std::numeric_limits<double>::max();
+            // best of 3 runs
+            for (int run = 0; run < 3; run++) {
+                std::chrono::steady_clock::time_point start =
+                        std::chrono::steady_clock::now();
+                runBlit(kernels[k], types[t], components, format, width,
+                        height, src, srcStride, results[k], dstStride,
+                        scaleBias);
+                times[k] = std::min(
+                        times[k],
+                        std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - start)
+                                .count());
+            }
+        }
+
+        cout << "blit of " << width << "x" << height << " type " << types[t]
+             << ": generic " << times[0] << " ms, kernel (ISA "
+             << static_cast<int>(blitkernels::getBestISA()) << ") "
+             << times[1] << " ms" << endl;
+
+        // timings are informational only, kernels have to be bit exact
+        EXPECT_TRUE(results[0] == results[1]);
+    }
+}
+
+namespace {
+
+/**
+ * Blitter storing last sunk image
+ */
+class TestBlitter : public DGLBlitterBase {
+   public:
+    TestBlitter() : m_Sinks(0), m_SunkGeneration(0) {}
+    ~TestBlitter() { cancel(); }
+
+    std::vector<char> waitForImage(unsigned int generation) {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Sunk.wait(lock, [this, generation] {
+            return m_SunkGeneration == generation;
+        });
+        return m_Image;
+    }
+
+    int getSinks() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Sinks;
+    }
+
+   private:
+    void sink(int /*width*/, int /*height*/, OutputFormat /*format*/,
+              const std::shared_ptr<std::vector<char> >& data,
+              unsigned int generation) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Image = *data;
+        m_SunkGeneration = generation;
+        m_Sinks++;
+        m_Sunk.notify_all();
+    }
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Sunk;
+    std::vector<char> m_Image;
+    int m_Sinks;
+    unsigned int m_SunkGeneration;
+};
+}
+
+TEST_F(DGLGui, blitter_async) {
+    std::mt19937 rng(1234);
+
+    const size_t bigSize = 2048;
+    std::vector<unsigned char> big =
+            getRandomPixels(GL_UNSIGNED_BYTE, bigSize * bigSize * 4, rng);
+
+    // many row bands, last one incomplete
+    const size_t width = 37, height = 300;
+    std::vector<unsigned char> src =
+            getRandomPixels(GL_UNSIGNED_BYTE, width * height * 4, rng);
+
+    std::pair<float, float> scaleBias[4] = {
+            std::make_pair(1.0f, 0.0f), std::make_pair(1.0f, 0.0f),
+            std::make_pair(1.0f, 0.0f), std::make_pair(1.0f, 0.0f)};
+    std::vector<unsigned char> expected(width * height * 4);
+    runBlit(nullptr, GL_UNSIGNED_BYTE, 4, DGLBlitterBase::_GL_BGRA32, width,
+            height, src, width * 4, expected, width * 4, scaleBias);
+
+    TestBlitter blitter;
+
+    // second blit obsoletes first one: data of first one is released right
+    // after, as GUI does
+    std::vector<unsigned char> released(big);
+    blitter.blit(bigSize, bigSize, bigSize * 4, GL_RGBA, GL_UNSIGNED_BYTE,
+                 &released[0]);
+    unsigned int obsolete = blitter.getGeneration();
+    blitter.blit(width, height, width * 4, GL_RGBA, GL_UNSIGNED_BYTE, &src[0]);
+    EXPECT_NE(obsolete, blitter.getGeneration());
+    std::vector<unsigned char>().swap(released);
+
+    std::vector<char> image = blitter.waitForImage(blitter.getGeneration());
+    EXPECT_TRUE(std::vector<char>(expected.begin(), expected.end()) == image);
+
+    // cancelled blit is never sunk, its data may be released after cancel()
+    released = big;
+    blitter.blit(bigSize, bigSize, bigSize * 4, GL_RGBA, GL_UNSIGNED_BYTE,
+                 &released[0]);
+    blitter.cancel();
+    std::vector<unsigned char>().swap(released);
+    int sinks = blitter.getSinks();
+
+    blitter.blit(width, height, width * 4, GL_RGBA, GL_UNSIGNED_BYTE, &src[0]);
+    image = blitter.waitForImage(blitter.getGeneration());
+    EXPECT_TRUE(std::vector<char>(expected.begin(), expected.end()) == image);
+    EXPECT_EQ(sinks + 1, blitter.getSinks());
+
+    // destroyed blitter does not read data released after it
+    released = big;
+    {
+        TestBlitter destroyed;
+        destroyed.blit(bigSize, bigSize, bigSize * 4, GL_RGBA,
+                       GL_UNSIGNED_BYTE, &released[0]);
+    }
+    std::vector<unsigned char>().swap(released);
+}
 }
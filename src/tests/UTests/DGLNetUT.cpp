@@ -16,6 +16,8 @@
 #include "gtest/gtest.h"
 
 #include <DGLNet/protocol/pixeltransfer.h>
+#include <DGLNet/protocol/resource.h>
+#include <DGLNet/protocol/request.h>
 
 namespace {
 
@@ -55,4 +57,172 @@ TEST_F(DGLNetUT, formats_esformat) {
     }
 }
 
+namespace formats {
+// lookup used before dense format indices were introduced
+template <typename T>
+const T* findLinear(const T* table, size_t count, gl_t T::*key, gl_t value) {
+    for (size_t i = 0; i < count; i++) {
+        if (table[i].*key == value) {
+            return &table[i];
+        }
+    }
+    return NULL;
+}
+}    // namespace formats
+
+TEST_F(DGLNetUT, formats_lookup_all) {
+    size_t numInternalFormats, numDataFormats, numDataTypes;
+    const GLInternalFormat* internalFormats =
+            GLFormats::getInternalFormats(numInternalFormats);
+    const GLDataFormat* dataFormats = GLFormats::getDataFormats(numDataFormats);
+    const GLDataType* dataTypes = GLFormats::getDataTypes(numDataTypes);
+
+    // all GL enums used by format tables are well below 0x10000
+    for (gl_t value = 0; value < 0x10000; value++) {
+        ASSERT_EQ(formats::findLinear(internalFormats, numInternalFormats,
+                                      &GLInternalFormat::internalFormat, value),
+                  GLFormats::getInternalFormat(value));
+        ASSERT_EQ(formats::findLinear(dataFormats, numDataFormats,
+                                      &GLDataFormat::format, value),
+                  GLFormats::getDataFormat(value));
+        ASSERT_EQ(formats::findLinear(dataTypes, numDataTypes,
+                                      &GLDataType::type, value),
+                  GLFormats::getDataType(value));
+    }
+    EXPECT_TRUE(GLFormats::getInternalFormat(~gl_t(0)) == NULL);
+    EXPECT_TRUE(GLFormats::getDataFormat(~gl_t(0)) == NULL);
+    EXPECT_TRUE(GLFormats::getDataType(~gl_t(0)) == NULL);
+
+    // duplicated keys resolve to first entry
+    EXPECT_EQ(static_cast<gl_t>(GL_UNSIGNED_BYTE),
+              GLFormats::getInternalFormat(GL_RGBA4)->dataType);
+}
+
+TEST_F(DGLNetUT, state_delta) {
+    std::vector<dglnet::resource::utils::StateItem> base(3);
+    base[0].m_Name = "GL_BLEND";
+    base[0].m_Values.push_back(static_cast<unsigned char>(0));
+    base[1].m_Name = "GL_VIEWPORT";
+    base[1].m_Values.resize(4, 0);
+    base[2].m_Name = "GL_DEPTH_FUNC";
+    base[2].m_Values.push_back(GL_LESS);
+
+    dglnet::resource::DGLResourceState state;
+    state.m_SnapshotId = 2;
+    state.m_Items = base;
+    state.m_Items[1].m_Values[2] = 640;
+
+    // incompatible base: stays full
+    state.makeDelta(1, std::vector<dglnet::resource::utils::StateItem>());
+    EXPECT_EQ(0u, state.m_BaseSnapshotId);
+    EXPECT_EQ(3u, state.m_Items.size());
+
+    state.makeDelta(1, base);
+    EXPECT_EQ(1u, state.m_BaseSnapshotId);
+    ASSERT_EQ(1u, state.m_Items.size());
+    ASSERT_EQ(1u, state.m_Indices.size());
+    EXPECT_EQ(1u, state.m_Indices[0]);
+
+    // delta applies only on its base snapshot
+    std::vector<dglnet::resource::utils::StateItem> items = base;
+    EXPECT_THROW(state.apply(3, items), std::runtime_error);
+
+    std::vector<size_t> changed = state.apply(1, items);
+    ASSERT_EQ(1u, changed.size());
+    EXPECT_EQ(1u, changed[0]);
+    EXPECT_TRUE(items[1].m_Values[2] == AnyValue(640));
+    EXPECT_TRUE(items[0] == base[0]);
+    EXPECT_TRUE(items[2] == base[2]);
+
+    // full snapshot reports changes against held items
+    dglnet::resource::DGLResourceState full;
+    full.m_SnapshotId = 3;
+    full.m_Items = base;
+    changed = full.apply(2, items);
+    ASSERT_EQ(1u, changed.size());
+    EXPECT_EQ(1u, changed[0]);
+    EXPECT_TRUE(full.apply(0, items).empty());
+}
+
+TEST_F(DGLNetUT, search_call_trace) {
+    CalledEntryPoint bind(glBindTexture_Call, 2);
+    bind.setArg(0, static_cast<GLenum>(GL_TEXTURE_2D));
+    bind.setArg(1, static_cast<GLuint>(5));
+
+    CalledEntryPoint enable(glEnable_Call, 1);
+    enable.setArg(0, static_cast<GLenum>(GL_TEXTURE_2D));
+    enable.setError(GL_INVALID_ENUM);
+
+    CalledEntryPoint draw(glDrawArrays_Call, 3);
+    draw.setDebugOutput("performance warning");
+
+    dglnet::request::SearchCallTrace search;
+    EXPECT_TRUE(search.matches(bind));
+    EXPECT_TRUE(search.matches(enable));
+    EXPECT_TRUE(search.matches(draw));
+
+    search.m_GLErrorOnly = true;
+    EXPECT_FALSE(search.matches(bind));
+    EXPECT_TRUE(search.matches(enable));
+    search.m_GLErrorOnly = false;
+
+    search.m_DebugOutputOnly = true;
+    EXPECT_FALSE(search.matches(enable));
+    EXPECT_TRUE(search.matches(draw));
+    search.m_DebugOutputOnly = false;
+
+    // first argument, formatted as enum
+    search.m_ArgFilters.push_back(
+            dglnet::request::SearchCallTrace::ArgFilter(0, "GL_TEXTURE_2D"));
+    EXPECT_TRUE(search.matches(bind));
+    EXPECT_TRUE(search.matches(enable));
+
+    search.m_Entrypoints.insert(glBindTexture_Call);
+    EXPECT_TRUE(search.matches(bind));
+    EXPECT_FALSE(search.matches(enable));
+
+    // numbers are compared by value
+    search.m_ArgFilters.push_back(
+            dglnet::request::SearchCallTrace::ArgFilter(1, "5.0"));
+    EXPECT_TRUE(search.matches(bind));
+    search.m_ArgFilters.back().m_Value = "6";
+    EXPECT_FALSE(search.matches(bind));
+
+    // no such argument
+    search.m_ArgFilters.back() =
+            dglnet::request::SearchCallTrace::ArgFilter(2, "0");
+    EXPECT_FALSE(search.matches(bind));
+}
+
+TEST_F(DGLNetUT, resource_data_size) {
+    using namespace dglnet::resource;
+
+    DGLResourceTexture texture;
+    texture.m_FacesLevelsLayers.resize(1);
+    texture.m_FacesLevelsLayers[0].resize(2);
+    for (size_t level = 0; level < 2; level++) {
+        DGLResourceTexture::TextureLayer layer;
+        layer.m_PixelRectangle = std::make_shared<DGLPixelRectangle>(
+                4 >> level, 4 >> level, 16 >> level, GL_RGBA, GL_UNSIGNED_BYTE);
+        texture.m_FacesLevelsLayers[0][level].push_back(layer);
+    }
+    // empty layer
+    texture.m_FacesLevelsLayers[0][1].push_back(
+            DGLResourceTexture::TextureLayer());
+    EXPECT_EQ(64u + 16u, texture.getDataSize());
+
+    DGLResourceBuffer buffer;
+    buffer.m_Data.resize(100);
+    EXPECT_EQ(100u, buffer.getDataSize());
+
+    DGLResourceFBO fbo;
+    fbo.m_Attachments.push_back(DGLResourceFBO::FBOAttachment(GL_COLOR_ATTACHMENT0));
+    fbo.m_Attachments[0].m_PixelRectangle = std::make_shared<DGLPixelRectangle>(
+            2, 2, 8, GL_RGBA, GL_UNSIGNED_BYTE);
+    fbo.m_Attachments.push_back(DGLResourceFBO::FBOAttachment(GL_DEPTH_ATTACHMENT));
+    EXPECT_EQ(16u, fbo.getDataSize());
+
+    EXPECT_EQ(0u, dglnet::resource::DGLResourceGPU().getDataSize());
+}
+
 }    // namespace
@@ -29,6 +29,7 @@
 
 #include <thread>
 #include <chrono>
+#include <set>
 
 #include "LiveProcessWrapper.h"
 
@@ -578,6 +579,172 @@ TEST_F(LiveTest, framebuffer_query) {
     terminate(client);
 }
 
+TEST_F(LiveTest, state_query_shadow_validation) {
+    std::shared_ptr<dglnet::Client> client = getClientFor("simple");
+
+    dglnet::message::BreakedCall* breaked =
+            utils::receiveUntilMessage<dglnet::message::BreakedCall>(
+                    client.get(), getMessageHandler());
+    ASSERT_TRUE(breaked != NULL);
+
+    {
+        // cross-check every shadowed value with the driver
+        DGLConfiguration usualConfig = getUsualConfig();
+        usualConfig.m_ValidateShadowState = true;
+        dglnet::message::Configuration config(usualConfig);
+        client->sendMessage(&config);
+    }
+
+    breaked = utils::runUntilEntryPoint(client, getMessageHandler(),
+                                        glDrawArrays_Call);
+
+    opaque_id_t snapshotId = 0;
+    for (int step = 0; step < 2; step++) {
+        // step == 0: state partially shadowed (set by application calls)
+        // step == 1: state learned by previous query, served from shadow;
+        //            only delta against previous snapshot is sent
+        {
+            dglnet::message::Request request(new dglnet::request::QueryResource(
+                    dglnet::message::ObjectType::State,
+                    dglnet::ContextObjectName(breaked->m_CurrentCtx, 0),
+                    snapshotId));
+            client->sendMessage(&request);
+        }
+
+        dglnet::message::RequestReply* reply =
+                utils::receiveUntilMessage<dglnet::message::RequestReply>(
+                        client.get(), getMessageHandler());
+        std::string error;
+        ASSERT_TRUE(reply->isOk(error)) << error;
+        dglnet::resource::DGLResourceState* stateResource =
+                dynamic_cast<dglnet::resource::DGLResourceState*>(
+                        reply->m_Reply.get());
+        ASSERT_TRUE(stateResource != NULL);
+        EXPECT_NE(snapshotId, stateResource->m_SnapshotId);
+        EXPECT_EQ(snapshotId, stateResource->m_BaseSnapshotId);
+        if (step) {
+            EXPECT_EQ(stateResource->m_Items.size(),
+                      stateResource->m_Indices.size());
+        } else {
+            EXPECT_FALSE(stateResource->m_Items.empty());
+        }
+        snapshotId = stateResource->m_SnapshotId;
+
+        // advance one call
+        dglnet::message::ContinueBreak stepCall(
+                dglnet::message::StepMode::CALL);
+        client->sendMessage(&stepCall);
+        breaked = utils::receiveUntilMessage<dglnet::message::BreakedCall>(
+                client.get(), getMessageHandler());
+        ASSERT_TRUE(breaked != NULL);
+    }
+
+    terminate(client);
+}
+
+TEST_F(LiveTest, state_query_shadow_display_list) {
+    std::shared_ptr<dglnet::Client> client = getClientFor("display_list");
+
+    dglnet::message::BreakedCall* breaked =
+            utils::receiveUntilMessage<dglnet::message::BreakedCall>(
+                    client.get(), getMessageHandler());
+    ASSERT_TRUE(breaked != NULL);
+
+    {
+        // cross-check every shadowed value with the driver
+        DGLConfiguration usualConfig = getUsualConfig();
+        usualConfig.m_ValidateShadowState = true;
+        dglnet::message::Configuration config(usualConfig);
+        client->sendMessage(&config);
+    }
+
+    // glFinish: list is compiled, but not executed
+    // glClear: list is executed
+    Entrypoint entrypoints[] = {glFinish_Call, glClear_Call};
+    for (size_t i = 0; i < sizeof(entrypoints) / sizeof(entrypoints[0]); i++) {
+        breaked = utils::runUntilEntryPoint(client, getMessageHandler(),
+                                            entrypoints[i]);
+        {
+            dglnet::message::Request request(new dglnet::request::QueryResource(
+                    dglnet::message::ObjectType::State,
+                    dglnet::ContextObjectName(breaked->m_CurrentCtx, 0)));
+            client->sendMessage(&request);
+        }
+
+        dglnet::message::RequestReply* reply =
+                utils::receiveUntilMessage<dglnet::message::RequestReply>(
+                        client.get(), getMessageHandler());
+        std::string error;
+        EXPECT_TRUE(reply->isOk(error)) << error;
+    }
+
+    terminate(client);
+}
+
+TEST_F(LiveTest, state_query_shadow_display_list_bindings) {
+    // PBO, FBO and pixel store are changed inside glNewList(GL_COMPILE)
+    std::shared_ptr<dglnet::Client> client =
+            getClientFor("display_list_bindings");
+
+    dglnet::message::BreakedCall* breaked =
+            utils::receiveUntilMessage<dglnet::message::BreakedCall>(
+                    client.get(), getMessageHandler());
+    ASSERT_TRUE(breaked != NULL);
+
+    {
+        // pushed resources restore state from shadow; shadow validation
+        // would catch any binding missed in compile mode
+        DGLConfiguration usualConfig = getUsualConfig();
+        usualConfig.m_PushBoundResources = true;
+        usualConfig.m_ValidateShadowState = true;
+        dglnet::message::Configuration config(usualConfig);
+        client->sendMessage(&config);
+    }
+
+    breaked = utils::runUntilEntryPoint(client, getMessageHandler(),
+                                        glClear_Call);
+    ASSERT_TRUE(breaked != NULL);
+
+    {
+        dglnet::message::Request request(new dglnet::request::QueryResource(
+                dglnet::message::ObjectType::State,
+                dglnet::ContextObjectName(breaked->m_CurrentCtx, 0)));
+        client->sendMessage(&request);
+    }
+
+    dglnet::message::RequestReply* reply =
+            utils::receiveUntilMessage<dglnet::message::RequestReply>(
+                    client.get(), getMessageHandler());
+    std::string error;
+    ASSERT_TRUE(reply->isOk(error)) << error;
+    dglnet::resource::DGLResourceState* stateResource =
+            dynamic_cast<dglnet::resource::DGLResourceState*>(
+                    reply->m_Reply.get());
+    ASSERT_TRUE(stateResource != NULL);
+
+    int found = 0;
+    for (size_t i = 0; i < stateResource->m_Items.size(); i++) {
+        const std::string& name = stateResource->m_Items[i].m_Name;
+        if (name != "GL_PIXEL_PACK_BUFFER_BINDING" &&
+            name != "GL_READ_FRAMEBUFFER_BINDING" &&
+            name != "GL_PACK_ALIGNMENT") {
+            continue;
+        }
+        ASSERT_EQ(1, stateResource->m_Items[i].m_Values.size());
+        GLint value = 0;
+        stateResource->m_Items[i].m_Values[0].get(value);
+        if (name == "GL_PACK_ALIGNMENT") {
+            EXPECT_EQ(1, value);
+        } else {
+            EXPECT_NE(0, value) << name;
+        }
+        found++;
+    }
+    EXPECT_EQ(3, found);
+
+    terminate(client);
+}
+
 TEST_F(LiveTest, framebuffer_resize) {
     std::shared_ptr<dglnet::Client> client = getClientFor("resize");
 
@@ -645,6 +812,227 @@ TEST_F(LiveTest, framebuffer_resize) {
     terminate(client);
 }
 
+TEST_F(LiveTest, dlsym_stress) {
+    std::shared_ptr<dglnet::Client> client = getClientFor("dlsym_stress");
+
+    dglnet::message::BreakedCall* breaked =
+            utils::receiveUntilMessage<dglnet::message::BreakedCall>(
+                    client.get(), getMessageHandler());
+    ASSERT_TRUE(breaked != NULL);
+
+    {
+        // disable breaking stuff
+        dglnet::message::Configuration config(getUsualConfig());
+        client->sendMessage(&config);
+    }
+
+    // sample renders with glFinish, if any dlsym call returned wrong pointer
+    {
+        std::set<Entrypoint> breakpoints;
+        breakpoints.insert(glClear_Call);
+        breakpoints.insert(glFinish_Call);
+        dglnet::message::SetBreakPoints breakPointMessage(breakpoints);
+        client->sendMessage(&breakPointMessage);
+    }
+    {
+        dglnet::message::ContinueBreak continueMsg(false);
+        client->sendMessage(&continueMsg);
+    }
+
+    breaked = utils::receiveUntilMessage<dglnet::message::BreakedCall>(
+            client.get(), getMessageHandler());
+    ASSERT_TRUE(breaked != NULL);
+    EXPECT_EQ(glClear_Call, breaked->m_entryp.getEntrypoint());
+
+    terminate(client);
+}
+
+#ifndef _WIN32
+
+TEST_F(LiveTest, fork_session) {
+    std::shared_ptr<dglnet::Client> client = getClientFor("fork");
+
+    dglnet::message::BreakedCall* breaked =
+            utils::receiveUntilMessage<dglnet::message::BreakedCall>(
+                    client.get(), getMessageHandler());
+    ASSERT_TRUE(breaked != NULL);
+
+    {
+        // disable breaking stuff
+        dglnet::message::Configuration config(getUsualConfig());
+        client->sendMessage(&config);
+    }
+
+    // parent breaks after child is forked
+    breaked = utils::runUntilEntryPoint(client, getMessageHandler(),
+                                        glFlush_Call);
+    ASSERT_TRUE(breaked != NULL);
+    EXPECT_LT(0, breaked->m_TraceSize);
+
+    // child listens for its own session, with own break state and history
+    std::shared_ptr<dglnet::Client> childClient = getAnotherConnection();
+
+    dglnet::message::Hello* hello =
+            utils::receiveMessage<dglnet::message::Hello>(
+                    childClient.get(), getMessageHandler());
+    ASSERT_TRUE(hello != NULL);
+
+    dglnet::message::BreakedCall* childBreaked =
+            utils::receiveMessage<dglnet::message::BreakedCall>(
+                    childClient.get(), getMessageHandler());
+    ASSERT_TRUE(childBreaked != NULL);
+    EXPECT_EQ(glGetError_Call, childBreaked->m_entryp.getEntrypoint());
+    EXPECT_EQ(0, childBreaked->m_TraceSize);
+
+    terminate(childClient);
+
+    // connection of parent was not broken by child
+    breaked = utils::runUntilEntryPoint(client, getMessageHandler(),
+                                        glFlush_Call);
+    ASSERT_TRUE(breaked != NULL);
+
+    terminate(client);
+}
+
+#endif
+
+TEST_F(LiveTest, texture_delete_stress) {
+    std::shared_ptr<dglnet::Client> client =
+            getClientFor("texture_delete_stress");
+
+    dglnet::message::BreakedCall* breaked =
+            utils::receiveUntilMessage<dglnet::message::BreakedCall>(
+                    client.get(), getMessageHandler());
+    ASSERT_TRUE(breaked != NULL);
+
+    {
+        // disable breaking stuff
+        dglnet::message::Configuration config(getUsualConfig());
+        client->sendMessage(&config);
+    }
+
+    breaked = utils::runUntilEntryPoint(client, getMessageHandler(),
+                                        glClear_Call);
+
+    ASSERT_EQ(1, breaked->m_CtxReports.size());
+    EXPECT_EQ(1, breaked->m_CtxReports[0].m_TextureSpace.size());
+
+    // all streamed textures are deleted, only one is left bound on unit 1
+    const std::vector<std::set<dglnet::ContextObjectName> >& units =
+            breaked->m_CtxReports[0].m_TextureUnitSpace;
+    ASSERT_LT(1u, units.size());
+    for (size_t i = 0; i < units.size(); i++) {
+        if (i == 1) {
+            ASSERT_EQ(1, units[i].size());
+            EXPECT_EQ(GL_TEXTURE_2D, units[i].begin()->m_Target);
+        } else {
+            EXPECT_EQ(0, units[i].size());
+        }
+    }
+
+    terminate(client);
+}
+
+TEST_F(LiveTest, mt_throughput) {
+    // as in sample: each thread makes kVerifyCalls numbered glClearStencil
+    const int kThreads = 4;
+    const int kVerifyCalls = 500;
+
+    std::shared_ptr<dglnet::Client> client = getClientFor("mt_throughput");
+
+    dglnet::message::BreakedCall* breaked =
+            utils::receiveUntilMessage<dglnet::message::BreakedCall>(
+                    client.get(), getMessageHandler());
+    ASSERT_TRUE(breaked != NULL);
+
+    {
+        // disable breaking stuff
+        dglnet::message::Configuration config(getUsualConfig());
+        client->sendMessage(&config);
+    }
+
+    breaked = utils::runUntilEntryPoint(client, getMessageHandler(),
+                                        glClear_Call);
+    ASSERT_TRUE(breaked != NULL);
+
+    {
+        dglnet::message::QueryCallTrace queryCallTrace(0,
+                                                       breaked->m_TraceSize);
+        client->sendMessage(&queryCallTrace);
+    }
+    dglnet::message::CallTrace* callTrace =
+            utils::receiveUntilMessage<dglnet::message::CallTrace>(
+                    client.get(), getMessageHandler());
+    ASSERT_TRUE(callTrace != NULL);
+
+    // every call of every thread is recorded, in order of the thread
+    std::vector<int> nextCall(kThreads, 0);
+    for (size_t i = 0; i < callTrace->m_Trace.size(); i++) {
+        if (callTrace->m_Trace[i].getEntrypoint() != glClearStencil_Call) {
+            continue;
+        }
+        GLint value;
+        callTrace->m_Trace[i].getArgs()[0].get(value);
+        int thread = value / kVerifyCalls;
+        ASSERT_LE(0, thread);
+        ASSERT_GT(kThreads, thread);
+        EXPECT_EQ(nextCall[thread], value % kVerifyCalls);
+        nextCall[thread] = value % kVerifyCalls + 1;
+    }
+    for (int i = 0; i < kThreads; i++) {
+        EXPECT_EQ(kVerifyCalls, nextCall[i]);
+    }
+
+    terminate(client);
+}
+
+TEST_F(LiveTest, break_latency) {
+    std::shared_ptr<dglnet::Client> client = getClientFor("long_frame");
+
+    dglnet::message::BreakedCall* breaked =
+            utils::receiveUntilMessage<dglnet::message::BreakedCall>(
+                    client.get(), getMessageHandler());
+    ASSERT_TRUE(breaked != NULL);
+
+    {
+        // disable breaking stuff
+        dglnet::message::Configuration config(getUsualConfig());
+        client->sendMessage(&config);
+    }
+    {
+        dglnet::message::ContinueBreak continueMsg(false);
+        client->sendMessage(&continueMsg);
+    }
+
+    // let sample run into its frames, which last 1s each
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+
+    for (int i = 0; i < 3; i++) {
+        std::chrono::steady_clock::time_point start =
+                std::chrono::steady_clock::now();
+        {
+            dglnet::message::ContinueBreak continueMsg(true);
+            client->sendMessage(&continueMsg);
+        }
+        breaked = utils::receiveUntilMessage<dglnet::message::BreakedCall>(
+                client.get(), getMessageHandler());
+        ASSERT_TRUE(breaked != NULL);
+
+        // break request must be noticed in the middle of frame, not at its
+        // end
+        EXPECT_GT(std::chrono::milliseconds(250),
+                  std::chrono::steady_clock::now() - start);
+
+        {
+            dglnet::message::ContinueBreak continueMsg(false);
+            client->sendMessage(&continueMsg);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    }
+
+    terminate(client);
+}
+
 TEST_F(LiveTest, texture_query_2d) {
     std::shared_ptr<dglnet::Client> client = getClientFor("texture2d");
 
@@ -732,6 +1120,232 @@ TEST_F(LiveTest, texture_query_2d) {
     terminate(client);
 }
 
+TEST_F(LiveTest, push_bound_resources) {
+    std::shared_ptr<dglnet::Client> client = getClientFor("texture2d");
+
+    dglnet::message::BreakedCall* breaked =
+            utils::receiveUntilMessage<dglnet::message::BreakedCall>(
+                    client.get(), getMessageHandler());
+    ASSERT_TRUE(breaked != NULL);
+
+    // nothing is pushed, unless configured
+    EXPECT_EQ(0, breaked->m_PushedResources.size());
+
+    {
+        DGLConfiguration usualConfig = getUsualConfig();
+        usualConfig.m_PushBoundResources = true;
+        dglnet::message::Configuration config(usualConfig);
+        client->sendMessage(&config);
+    }
+
+    breaked = utils::runUntilEntryPoint(client, getMessageHandler(),
+                                        glDrawArrays_Call);
+
+    bool pushedProgram = false, pushedTexture = false, pushedBuffer = false;
+    for (size_t i = 0; i < breaked->m_PushedResources.size(); i++) {
+        const dglnet::message::PushedResource& pushed =
+                breaked->m_PushedResources[i];
+        EXPECT_EQ(breaked->m_CurrentCtx, pushed.m_ObjectName.m_Context);
+
+        switch (pushed.m_Type) {
+            case dglnet::message::ObjectType::Program:
+                pushedProgram =
+                        dynamic_cast<dglnet::resource::DGLResourceProgram*>(
+                                pushed.m_Resource.get()) != NULL;
+                break;
+            case dglnet::message::ObjectType::Texture: {
+                dglnet::resource::DGLResourceTexture* textureResource =
+                        dynamic_cast<dglnet::resource::DGLResourceTexture*>(
+                                pushed.m_Resource.get());
+                ASSERT_TRUE(textureResource != NULL);
+                ASSERT_EQ(1, textureResource->m_FacesLevelsLayers.size());
+                EXPECT_EQ(5, textureResource->m_FacesLevelsLayers[0].size());
+                pushedTexture = true;
+                break;
+            }
+            case dglnet::message::ObjectType::Buffer: {
+                dglnet::resource::DGLResourceBuffer* bufferResource =
+                        dynamic_cast<dglnet::resource::DGLResourceBuffer*>(
+                                pushed.m_Resource.get());
+                ASSERT_TRUE(bufferResource != NULL);
+                EXPECT_EQ(16 * sizeof(GLfloat), bufferResource->m_Data.size());
+                pushedBuffer = true;
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    EXPECT_TRUE(pushedProgram);
+    EXPECT_TRUE(pushedTexture);
+    EXPECT_TRUE(pushedBuffer);
+
+    terminate(client);
+}
+
+TEST_F(LiveTest, push_bound_resources_restore_state) {
+    // sample sets GL_PACK_ALIGNMENT to 1
+    std::shared_ptr<dglnet::Client> client =
+            getClientFor("texture2d_pack_alignment");
+
+    dglnet::message::BreakedCall* breaked =
+            utils::receiveUntilMessage<dglnet::message::BreakedCall>(
+                    client.get(), getMessageHandler());
+    ASSERT_TRUE(breaked != NULL);
+
+    {
+        // pushed resources are queried in one session; shadow validation
+        // would catch any state left changed after it.
+        DGLConfiguration usualConfig = getUsualConfig();
+        usualConfig.m_PushBoundResources = true;
+        usualConfig.m_ValidateShadowState = true;
+        dglnet::message::Configuration config(usualConfig);
+        client->sendMessage(&config);
+    }
+
+    breaked = utils::runUntilEntryPoint(client, getMessageHandler(),
+                                        glDrawArrays_Call);
+    EXPECT_FALSE(breaked->m_PushedResources.empty());
+
+    {
+        dglnet::message::Request request(new dglnet::request::QueryResource(
+                dglnet::message::ObjectType::State,
+                dglnet::ContextObjectName(breaked->m_CurrentCtx, 0)));
+        client->sendMessage(&request);
+    }
+
+    dglnet::message::RequestReply* reply =
+            utils::receiveUntilMessage<dglnet::message::RequestReply>(
+                    client.get(), getMessageHandler());
+    std::string error;
+    ASSERT_TRUE(reply->isOk(error)) << error;
+    dglnet::resource::DGLResourceState* stateResource =
+            dynamic_cast<dglnet::resource::DGLResourceState*>(
+                    reply->m_Reply.get());
+    ASSERT_TRUE(stateResource != NULL);
+
+    bool packAlignmentFound = false;
+    for (size_t i = 0; i < stateResource->m_Items.size(); i++) {
+        if (stateResource->m_Items[i].m_Name == "GL_PACK_ALIGNMENT") {
+            ASSERT_EQ(1, stateResource->m_Items[i].m_Values.size());
+            EXPECT_TRUE(AnyValue(static_cast<GLint>(1)) ==
+                        stateResource->m_Items[i].m_Values[0]);
+            packAlignmentFound = true;
+        }
+    }
+    EXPECT_TRUE(packAlignmentFound);
+
+    terminate(client);
+}
+
+TEST_F(LiveTest, texture_storage_generate_mipmap) {
+    std::shared_ptr<dglnet::Client> client =
+            getClientFor("texture2d_storage_mipmap");
+
+    dglnet::message::BreakedCall* breaked =
+            utils::receiveUntilMessage<dglnet::message::BreakedCall>(
+                    client.get(), getMessageHandler());
+    ASSERT_TRUE(breaked != NULL);
+
+    {
+        DGLConfiguration usualConfig = getUsualConfig();
+        usualConfig.m_PushBoundResources = true;
+        dglnet::message::Configuration config(usualConfig);
+        client->sendMessage(&config);
+    }
+
+    // glGenerateMipmap on single-level storage must not make levels above 0
+    // known: estimated size would exceed pushed resources budget.
+    breaked = utils::runUntilEntryPoint(client, getMessageHandler(),
+                                        glClear_Call);
+
+    bool pushedTexture = false;
+    for (size_t i = 0; i < breaked->m_PushedResources.size(); i++) {
+        const dglnet::message::PushedResource& pushed =
+                breaked->m_PushedResources[i];
+        if (pushed.m_Type != dglnet::message::ObjectType::Texture) {
+            continue;
+        }
+        dglnet::resource::DGLResourceTexture* textureResource =
+                dynamic_cast<dglnet::resource::DGLResourceTexture*>(
+                        pushed.m_Resource.get());
+        ASSERT_TRUE(textureResource != NULL);
+        ASSERT_EQ(1, textureResource->m_FacesLevelsLayers.size());
+        EXPECT_EQ(1, textureResource->m_FacesLevelsLayers[0].size());
+        pushedTexture = true;
+    }
+    EXPECT_TRUE(pushedTexture);
+
+    terminate(client);
+}
+
+TEST_F(LiveTest, texture_query_batch) {
+    std::shared_ptr<dglnet::Client> client = getClientFor("texture2d");
+
+    dglnet::message::BreakedCall* breaked =
+            utils::receiveUntilMessage<dglnet::message::BreakedCall>(
+                    client.get(), getMessageHandler());
+    ASSERT_TRUE(breaked != NULL);
+
+    {
+        // disable breaking stuff
+        dglnet::message::Configuration config(getUsualConfig());
+        client->sendMessage(&config);
+    }
+
+    breaked = utils::runUntilEntryPoint(client, getMessageHandler(),
+                                        glDrawArrays_Call);
+
+    ASSERT_EQ(1, breaked->m_CtxReports.size());
+    ASSERT_EQ(1, breaked->m_CtxReports[0].m_TextureSpace.size());
+
+    // send whole batch first, queries may be served concurrently
+    const size_t kBatchSize = 6;
+    std::set<int> requestIds;
+    for (size_t i = 0; i < kBatchSize; i++) {
+        dglnet::message::Request request(new dglnet::request::QueryResource(
+                dglnet::message::ObjectType::Texture,
+                dglnet::ContextObjectName(breaked->m_CurrentCtx,
+                                          breaked->m_CtxReports[0]
+                                                  .m_TextureSpace.begin()
+                                                  ->m_Name)));
+        requestIds.insert(request.getId());
+        client->sendMessage(&request);
+    }
+
+    std::vector<GLubyte> firstLevel;
+    for (size_t i = 0; i < kBatchSize; i++) {
+        dglnet::message::RequestReply* reply =
+                utils::receiveUntilMessage<dglnet::message::RequestReply>(
+                        client.get(), getMessageHandler());
+        ASSERT_TRUE(reply != NULL);
+
+        // replies may come in any order, but each exactly once
+        EXPECT_EQ(1, requestIds.erase(reply->m_RequestId));
+
+        std::string nothing;
+        ASSERT_TRUE(reply->isOk(nothing));
+        dglnet::resource::DGLResourceTexture* textureResource =
+                dynamic_cast<dglnet::resource::DGLResourceTexture*>(
+                        reply->m_Reply.get());
+        ASSERT_TRUE(textureResource != NULL);
+        ASSERT_EQ(5, textureResource->m_FacesLevelsLayers[0].size());
+
+        dglnet::resource::DGLPixelRectangle* rect =
+                textureResource->m_FacesLevelsLayers[0][0][0]
+                        .m_PixelRectangle.get();
+        const GLubyte* ptr = reinterpret_cast<const GLubyte*>(rect->getPtr());
+        std::vector<GLubyte> level(ptr, ptr + rect->getSize());
+        if (firstLevel.empty()) {
+            firstLevel = level;
+        } else {
+            EXPECT_TRUE(firstLevel == level);
+        }
+    }
+    EXPECT_TRUE(requestIds.empty());
+
+    terminate(client);
+}
 
 TEST_F(LiveTest, texture_query_3d) {
     std::shared_ptr<dglnet::Client> client = getClientFor("texture3d");
@@ -23,6 +23,17 @@ class PlatWindowCtx {
     virtual void swapBuffers() = 0;
     virtual bool pendingClose() = 0;
     virtual void resize(int newWidth, int newHeight) = 0;
+
+    /**
+     * Create hidden context sharing objects with this one. Must be called on
+     * main thread, resulting context can be made current on any thread.
+     */
+    virtual std::shared_ptr<PlatWindowCtx> createSharedContext() = 0;
+
+    /**
+     * Release context current to calling thread.
+     */
+    virtual void releaseCurrent() = 0;
 };
 
 class Platform {
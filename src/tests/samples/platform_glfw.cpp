@@ -23,17 +23,25 @@
 
 class GLWFPlatWindowCtx : public PlatWindowCtx {
    public:
-    GLWFPlatWindowCtx() : m_window(NULL) {
+    GLWFPlatWindowCtx(GLFWwindow* share = NULL) : m_window(NULL) {
 #ifdef OPENGL_ES2
         glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_ES_API);
         glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
 #endif
-        m_window = glfwCreateWindow(640, 480, "Hello World", NULL, NULL);
+        if (share) {
+            glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+            m_window = glfwCreateWindow(1, 1, "Shared", NULL, share);
+            glfwWindowHint(GLFW_VISIBLE, GL_TRUE);
+        } else {
+            m_window = glfwCreateWindow(640, 480, "Hello World", NULL, NULL);
+        }
         if (!m_window) {
             throw std::runtime_error("Cannot create glwf window");
         }
     }
 
+    ~GLWFPlatWindowCtx() { glfwDestroyWindow(m_window); }
+
     virtual void makeCurrent() override {
         glfwMakeContextCurrent(m_window);
 #ifndef OPENGL_ES2
@@ -57,6 +65,12 @@ class GLWFPlatWindowCtx : public PlatWindowCtx {
         glfwSetWindowSize(m_window, newWidth, newHeight);
     }
 
+    virtual std::shared_ptr<PlatWindowCtx> createSharedContext() override {
+        return std::make_shared<GLWFPlatWindowCtx>(m_window);
+    }
+
+    virtual void releaseCurrent() override { glfwMakeContextCurrent(NULL); }
+
    private:
     GLFWwindow* m_window;
     static bool glewInitDone;
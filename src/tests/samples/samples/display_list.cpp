@@ -0,0 +1,110 @@
+/* Copyright (C) 2014 Slawomir Cygan <slawomir.cygan@gmail.com>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "sample.h"
+
+/**
+ * Changes state through display list. State calls are compiled (not executed)
+ * in startup, marked by glFinish, and executed by glCallList in each frame,
+ * before glClear.
+ */
+class SampleDisplayList : public Sample {
+
+    virtual void startup() override {
+#ifndef OPENGL_ES2
+        m_List = glGenLists(1);
+        glNewList(m_List, GL_COMPILE);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE);
+        glViewport(0, 0, 16, 16);
+        glDepthFunc(GL_GREATER);
+        glEndList();
+#endif
+        glFinish();
+    }
+
+    virtual void render() override {
+        glDisable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glViewport(0, 0, 32, 32);
+        glDepthFunc(GL_LESS);
+#ifndef OPENGL_ES2
+        glCallList(m_List);
+#endif
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    virtual void shutdown() override {
+#ifndef OPENGL_ES2
+        glDeleteLists(m_List, 1);
+#endif
+    }
+
+#ifndef OPENGL_ES2
+    GLuint m_List;
+#endif
+};
+
+REGISTER_SAMPLE(SampleDisplayList, "display_list");
+
+/**
+ * Calls executed immediately even in glNewList(GL_COMPILE): PBO, FBO and pixel
+ * store are changed while the list is compiled, before glFinish.
+ */
+class SampleDisplayListBindings : public Sample {
+
+    virtual void startup() override {
+        glGenBuffers(1, &m_Pbo);
+        glGenFramebuffers(1, &m_Fbo);
+        glGenRenderbuffers(1, &m_Rbo);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_Rbo);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 16, 16);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+#ifndef OPENGL_ES2
+        m_List = glGenLists(1);
+        glNewList(m_List, GL_COMPILE);
+#endif
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_Pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, 16 * 16 * 4, NULL, GL_STREAM_READ);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_Fbo);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                  GL_RENDERBUFFER, m_Rbo);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+#ifndef OPENGL_ES2
+        glEndList();
+#endif
+        glFinish();
+    }
+
+    virtual void render() override {
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    virtual void shutdown() override {
+#ifndef OPENGL_ES2
+        glDeleteLists(m_List, 1);
+#endif
+        glDeleteFramebuffers(1, &m_Fbo);
+        glDeleteRenderbuffers(1, &m_Rbo);
+        glDeleteBuffers(1, &m_Pbo);
+    }
+
+#ifndef OPENGL_ES2
+    GLuint m_List;
+#endif
+    GLuint m_Pbo, m_Fbo, m_Rbo;
+};
+
+REGISTER_SAMPLE(SampleDisplayListBindings, "display_list_bindings");
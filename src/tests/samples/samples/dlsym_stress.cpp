@@ -0,0 +1,167 @@
+/* Copyright (C) 2014 Slawomir Cygan <slawomir.cygan@gmail.com>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "sample.h"
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+/**
+ * Calls dlsym from many threads at once. Most of calls are for symbols
+ * unrelated to GL (as loader-heavy applications do), some are for GL
+ * entrypoints. Under debugger all of them go through dlsym interception.
+ * Meanwhile one more thread keeps opening and closing GL library, so lookups
+ * race with loader changes.
+ *
+ * Renders with glClear if every call returned expected pointer, with glFinish
+ * otherwise.
+ */
+class SampleDlsymStress : public Sample {
+
+    virtual void startup() override {
+        m_Ok = true;
+#ifndef _WIN32
+        m_GLLibrary = dlopen(kGLLibraryName, RTLD_NOW);
+        if (!m_GLLibrary) {
+            m_Ok = false;
+            return;
+        }
+
+        const int kCalls = 200000;
+
+        double singleThreadTime = stress(1, kCalls);
+
+        unsigned int threads = std::max(2u, std::thread::hardware_concurrency());
+        double multiThreadTime = stress(threads, kCalls);
+
+        printf("dlsym stress: %d calls on 1 thread: %.1f ms, %d calls on %u "
+               "threads: %.1f ms\n",
+               kCalls, singleThreadTime, kCalls * threads, threads,
+               multiThreadTime);
+        fflush(stdout);
+#endif
+    }
+
+    virtual void render() override {
+        if (m_Ok) {
+            glClear(GL_COLOR_BUFFER_BIT);
+        } else {
+            glFinish();
+        }
+    }
+
+    virtual void shutdown() override {
+#ifndef _WIN32
+        if (m_GLLibrary) {
+            dlclose(m_GLLibrary);
+        }
+#endif
+    }
+
+#ifndef _WIN32
+    /**
+     * Make given number of dlsym calls on each thread, while GL library is
+     * reopened on another one. Return wall time in ms.
+     */
+    double stress(unsigned int threads, int calls) {
+        const char* names[] = {"malloc", "free", "pthread_create", "strlen",
+                               "fopen", "dgl_nonexistent_symbol"};
+        const size_t namesCount = sizeof(names) / sizeof(names[0]);
+
+        std::vector<void*> expected(namesCount);
+        for (size_t i = 0; i < namesCount; i++) {
+            expected[i] = dlsym(RTLD_DEFAULT, names[i]);
+        }
+        void* expectedGL = dlsym(m_GLLibrary, "glClear");
+
+        std::atomic<bool> failed(false);
+        std::atomic<bool> done(false);
+
+        std::chrono::steady_clock::time_point start =
+                std::chrono::steady_clock::now();
+
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < threads; t++) {
+            workers.push_back(std::thread([&]() {
+                for (int i = 0; i < calls; i++) {
+                    if (i % 16 == 0) {
+                        if (dlsym(m_GLLibrary, "glClear") != expectedGL) {
+                            failed = true;
+                        }
+                    } else {
+                        size_t name = i % namesCount;
+                        if (dlsym(RTLD_DEFAULT, names[name]) != expected[name]) {
+                            failed = true;
+                        }
+                    }
+                }
+            }));
+        }
+
+        // library stays loaded (m_GLLibrary holds a reference), but each
+        // dlopen/dlclose pair still goes through loader and its locks
+        std::thread churn([&]() {
+            while (!done) {
+                void* library = dlopen(kGLLibraryName, RTLD_NOW);
+                if (!library) {
+                    failed = true;
+                    break;
+                }
+                if (dlsym(library, "glClear") != expectedGL) {
+                    failed = true;
+                }
+                dlclose(library);
+            }
+        });
+
+        for (size_t t = 0; t < workers.size(); t++) {
+            workers[t].join();
+        }
+        done = true;
+        churn.join();
+
+        if (failed) {
+            m_Ok = false;
+        }
+
+        return std::chrono::duration<double, std::milli>(
+                       std::chrono::steady_clock::now() - start).count();
+    }
+
+    static const char* const kGLLibraryName;
+
+    void* m_GLLibrary;
+#endif
+    bool m_Ok;
+};
+
+#ifndef _WIN32
+const char* const SampleDlsymStress::kGLLibraryName =
+#ifdef OPENGL_ES2
+        "libGLESv2.so";
+#else
+        "libGL.so.1";
+#endif
+#endif
+
+REGISTER_SAMPLE(SampleDlsymStress, "dlsym_stress");
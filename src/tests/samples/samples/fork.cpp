@@ -0,0 +1,52 @@
+/* Copyright (C) 2014 Slawomir Cygan <slawomir.cygan@gmail.com>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "sample.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+/**
+ * Forks in first frame (after GL was already used by parent). Child makes
+ * single GL call (glGetError), so debugger starts new session in it, and
+ * exits without touching window system. Parent renders with glClear and
+ * glFlush.
+ */
+class SampleFork : public Sample {
+
+    virtual void startup() override { m_Forked = false; }
+
+    virtual void render() override {
+        glClear(GL_COLOR_BUFFER_BIT);
+#ifndef _WIN32
+        if (!m_Forked) {
+            m_Forked = true;
+            if (fork() == 0) {
+                glGetError();
+                _exit(0);
+            }
+        }
+#endif
+        glFlush();
+    }
+
+    virtual void shutdown() override {}
+
+   private:
+    bool m_Forked;
+};
+
+REGISTER_SAMPLE(SampleFork, "fork");
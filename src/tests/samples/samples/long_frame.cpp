@@ -0,0 +1,44 @@
+/* Copyright (C) 2014 Slawomir Cygan <slawomir.cygan@gmail.com>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "sample.h"
+
+#include <chrono>
+
+/**
+ * Renders very long frames made of many cheap GL calls. Debugger cannot rely
+ * on frame boundaries to notice client messages in time.
+ */
+class SampleLongFrame : public Sample {
+
+    virtual void startup() override {}
+
+    virtual void render() override {
+        std::chrono::steady_clock::time_point end =
+                std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+        while (std::chrono::steady_clock::now() < end) {
+            for (int i = 0; i < 1000; i++) {
+                glEnable(GL_BLEND);
+                glDisable(GL_BLEND);
+            }
+        }
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    virtual void shutdown() override {}
+};
+
+REGISTER_SAMPLE(SampleLongFrame, "long_frame");
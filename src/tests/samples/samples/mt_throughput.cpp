@@ -0,0 +1,113 @@
+/* Copyright (C) 2014 Slawomir Cygan <slawomir.cygan@gmail.com>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "sample.h"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+/**
+ * Makes cheap GL calls from many threads at once, each thread with own
+ * context. Under debugger each call is intercepted; calls from different
+ * threads should not serialize on each other. Throughput is only printed.
+ *
+ * Then each of kThreads threads makes kVerifyCalls calls of
+ * glClearStencil(thread * kVerifyCalls + call), so call history can be
+ * checked for all calls in per-thread order. Renders with glClear.
+ */
+class SampleMtThroughput : public Sample {
+
+    static const unsigned int kThreads = 4;
+    static const int kVerifyCalls = 500;
+
+    virtual void startup() override {
+        const int kCalls = 200000;
+
+        for (unsigned int i = 0; i < kThreads; i++) {
+            m_Contexts.push_back(getWindow()->createSharedContext());
+        }
+
+        double singleThroughput = stress(1, kCalls);
+        double multiThroughput = stress(kThreads, kCalls);
+
+        printf("mt throughput: 1 thread: %.0f calls/s, %u threads: %.0f "
+               "calls/s, speedup %.2f\n",
+               singleThroughput, kThreads, multiThroughput,
+               multiThroughput / singleThroughput);
+        fflush(stdout);
+
+        verifyCalls();
+    }
+
+    virtual void render() override { glClear(GL_COLOR_BUFFER_BIT); }
+
+    virtual void shutdown() override { m_Contexts.clear(); }
+
+    /**
+     * Make given number of GL calls on each thread, return aggregate
+     * throughput in calls per second.
+     */
+    double stress(unsigned int threads, int calls) {
+        std::chrono::steady_clock::time_point start =
+                std::chrono::steady_clock::now();
+
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < threads; t++) {
+            PlatWindowCtx* context = m_Contexts[t].get();
+            workers.push_back(std::thread([context, calls]() {
+                context->makeCurrent();
+                for (int i = 0; i < calls; i += 2) {
+                    glEnable(GL_BLEND);
+                    glDisable(GL_BLEND);
+                }
+                context->releaseCurrent();
+            }));
+        }
+        for (size_t t = 0; t < workers.size(); t++) {
+            workers[t].join();
+        }
+
+        double seconds = std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() - start).count();
+
+        return static_cast<double>(calls) * threads / seconds;
+    }
+
+    /**
+     * Make numbered calls on all threads at once.
+     */
+    void verifyCalls() {
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < kThreads; t++) {
+            PlatWindowCtx* context = m_Contexts[t].get();
+            workers.push_back(std::thread([context, t]() {
+                context->makeCurrent();
+                for (int i = 0; i < kVerifyCalls; i++) {
+                    glClearStencil(static_cast<GLint>(t) * kVerifyCalls + i);
+                }
+                context->releaseCurrent();
+            }));
+        }
+        for (size_t t = 0; t < workers.size(); t++) {
+            workers[t].join();
+        }
+    }
+
+    std::vector<std::shared_ptr<PlatWindowCtx> > m_Contexts;
+};
+
+REGISTER_SAMPLE(SampleMtThroughput, "mt_throughput");
@@ -20,6 +20,7 @@
 
 class SampleTexture2D : public Sample {
 
+   protected:
     virtual void startup() override {
         glGenBuffers(1, &m_vbo);
         glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
@@ -114,3 +115,41 @@ class SampleTexture2D : public Sample {
 };
 
 REGISTER_SAMPLE(SampleTexture2D, "texture2d");
+
+/**
+ * texture2d with non-default pack state: texture queries have to restore it.
+ */
+class SampleTexture2DPackAlignment : public SampleTexture2D {
+    virtual void startup() override {
+        SampleTexture2D::startup();
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    }
+};
+
+REGISTER_SAMPLE(SampleTexture2DPackAlignment, "texture2d_pack_alignment");
+
+/**
+ * Immutable single-level texture followed by glGenerateMipmap: no level beyond
+ * storage may become known. Level 0 (3.5MB) fits into pushed resources budget,
+ * a full mip chain derived from it would not.
+ */
+class SampleTexture2DStorageMipmap : public Sample {
+    virtual void startup() override {
+        glGenTextures(1, &m_tex);
+        glBindTexture(GL_TEXTURE_2D, m_tex);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, 1024, 896);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    virtual void render() override {
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    virtual void shutdown() override {
+        glDeleteTextures(1, &m_tex);
+    }
+
+    GLuint m_tex;
+};
+
+REGISTER_SAMPLE(SampleTexture2DStorageMipmap, "texture2d_storage_mipmap");
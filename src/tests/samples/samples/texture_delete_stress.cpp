@@ -0,0 +1,76 @@
+/* Copyright (C) 2014 Slawomir Cygan <slawomir.cygan@gmail.com>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "sample.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+/**
+ * Streams textures as some applications do: each frame creates thousands of
+ * textures, binds them spread over all texture units and deletes them.
+ * Under debugger every deletion goes through texture unit tracking.
+ *
+ * After startup only one texture is left bound: on unit 1, to GL_TEXTURE_2D.
+ */
+class SampleTextureDeleteStress : public Sample {
+
+    virtual void startup() override {
+        GLint units = 0;
+        glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &units);
+        if (units < 2) {
+            units = 2;
+        }
+
+        const int kFrames = 20;
+        const int kTextures = 2000;
+
+        std::vector<GLuint> names(kTextures);
+
+        std::chrono::steady_clock::time_point start =
+                std::chrono::steady_clock::now();
+
+        for (int frame = 0; frame < kFrames; frame++) {
+            glGenTextures(kTextures, &names[0]);
+            for (int i = 0; i < kTextures; i++) {
+                glActiveTexture(GL_TEXTURE0 + (i % units));
+                glBindTexture(GL_TEXTURE_2D, names[i]);
+            }
+            glDeleteTextures(kTextures, &names[0]);
+        }
+
+        double time = std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - start).count();
+
+        printf("texture delete stress: %d textures on %d units: %.1f ms\n",
+               kFrames * kTextures, units, time);
+        fflush(stdout);
+
+        glActiveTexture(GL_TEXTURE1);
+        glGenTextures(1, &m_Texture);
+        glBindTexture(GL_TEXTURE_2D, m_Texture);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    virtual void render() override { glClear(GL_COLOR_BUFFER_BIT); }
+
+    virtual void shutdown() override { glDeleteTextures(1, &m_Texture); }
+
+   private:
+    GLuint m_Texture;
+};
+
+REGISTER_SAMPLE(SampleTextureDeleteStress, "texture_delete_stress");